@@ -751,7 +751,7 @@ protected:
    */
   inline void determineThreadRanges() {
     allNodesRanges = galois::graphs::determineUnitRangesFromPrefixSum(
-        galois::runtime::activeThreads, graph.getEdgePrefixSum());
+        galois::getActiveThreads(), graph.getEdgePrefixSum());
   }
 
   /**
@@ -775,7 +775,7 @@ protected:
     } else {
       galois::gDebug("Manually det. master thread ranges");
       masterRanges = galois::graphs::determineUnitRangesFromGraph(
-          graph, galois::runtime::activeThreads, beginMaster,
+          graph, galois::getActiveThreads(), beginMaster,
           beginMaster + numOwned, 0);
     }
   }
@@ -801,7 +801,7 @@ protected:
     } else {
       galois::gDebug("Manually det. with edges thread ranges");
       withEdgeRanges = galois::graphs::determineUnitRangesFromGraph(
-          graph, galois::runtime::activeThreads, 0, numNodesWithEdges, 0);
+          graph, galois::getActiveThreads(), 0, numNodesWithEdges, 0);
     }
   }
 
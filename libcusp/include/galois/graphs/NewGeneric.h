@@ -29,6 +29,7 @@
 
 #include "galois/graphs/DistributedGraph.h"
 #include "galois/DReducible.h"
+#include "galois/ParallelSTL.h"
 #include <optional>
 #include <sstream>
 
@@ -386,14 +387,13 @@ private:
         },
         galois::no_stats());
 
-    for (unsigned i = 1; i < numLocalNodes; i++) {
-      edgePrefixSum[i] += edgePrefixSum[i - 1];
-    }
+    galois::ParallelSTL::partial_sum(edgePrefixSum.begin(), edgePrefixSum.end(),
+                                     edgePrefixSum.begin());
 
     assignedThreadRanges = galois::graphs::determineUnitRangesFromPrefixSum(
-        galois::runtime::activeThreads, edgePrefixSum);
+        galois::getActiveThreads(), edgePrefixSum);
 
-    for (unsigned i = 0; i < galois::runtime::activeThreads + 1; i++) {
+    for (unsigned i = 0; i < galois::getActiveThreads() + 1; i++) {
       assignedThreadRanges[i] += startNode;
     }
 
@@ -2449,9 +2449,12 @@ private:
                                              incomingEstimate);
     base_DistGraph::globalToLocalMap[base_DistGraph::localToGlobalVector[0]] =
         0;
+    galois::ParallelSTL::partial_sum(
+        prefixSumOfEdges.begin(),
+        prefixSumOfEdges.begin() + base_DistGraph::numNodesWithEdges,
+        prefixSumOfEdges.begin());
     // global to local map construction using num nodes with edges
     for (unsigned i = 1; i < base_DistGraph::numNodesWithEdges; i++) {
-      prefixSumOfEdges[i] += prefixSumOfEdges[i - 1];
       base_DistGraph::globalToLocalMap[base_DistGraph::localToGlobalVector[i]] =
           i;
     }
@@ -2538,10 +2541,15 @@ private:
   void finalizeInspection(galois::gstl::Vector<uint64_t>& prefixSumOfEdges) {
     // reserve rest of memory needed
     base_DistGraph::globalToLocalMap.reserve(base_DistGraph::numNodes);
+    // finalize prefix sum
+    if (base_DistGraph::numNodesWithEdges > 0) {
+      galois::ParallelSTL::partial_sum(
+          prefixSumOfEdges.begin() + base_DistGraph::numNodesWithEdges - 1,
+          prefixSumOfEdges.begin() + base_DistGraph::numNodes,
+          prefixSumOfEdges.begin() + base_DistGraph::numNodesWithEdges - 1);
+    }
     for (unsigned i = base_DistGraph::numNodesWithEdges;
          i < base_DistGraph::numNodes; i++) {
-      // finalize prefix sum
-      prefixSumOfEdges[i] += prefixSumOfEdges[i - 1];
       // global to local map construction
       base_DistGraph::globalToLocalMap[base_DistGraph::localToGlobalVector[i]] =
           i;
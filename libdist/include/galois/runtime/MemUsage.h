@@ -29,6 +29,9 @@
 
 #pragma once
 #include <atomic>
+
+#include "galois/substrate/MemAccounting.h"
+
 namespace galois {
 namespace runtime {
 
@@ -50,6 +53,7 @@ public:
    * @param size amount to increment mem usage by
    */
   inline void incrementMemUsage(uint64_t size) {
+    substrate::memAccountAlloc(substrate::MemCategory::CommBuffers, size);
     currentMemUsage += size;
     if (currentMemUsage > maxMemUsage)
       maxMemUsage = currentMemUsage;
@@ -60,7 +64,10 @@ public:
    *
    * @param size amount to decrement mem usage by
    */
-  inline void decrementMemUsage(uint64_t size) { currentMemUsage -= size; }
+  inline void decrementMemUsage(uint64_t size) {
+    substrate::memAccountFree(substrate::MemCategory::CommBuffers, size);
+    currentMemUsage -= size;
+  }
 
   /**
    * Reset mem usage and max mem usage to 0.
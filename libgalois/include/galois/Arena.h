@@ -0,0 +1,121 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_ARENA_H
+#define GALOIS_ARENA_H
+
+#include <string>
+
+#include "galois/config.h"
+#include "galois/Loops.h"
+#include "galois/runtime/Mem.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+
+//! Heap of every thread of a PerThreadArena
+typedef runtime::ArenaHeap<runtime::SystemHeap> ArenaHeapTy;
+
+//! STL allocator that allocates from an arena; deallocate is a no-op
+template <typename T>
+using ArenaAllocator = runtime::ExternalHeapAllocator<T, ArenaHeapTy>;
+
+/**
+ * Rewinds an arena to where it was when the scope was entered, freeing
+ * every allocation made in the scope at once. Containers using allocator()
+ * must be destroyed before the scope, e.g., be declared after it.
+ *
+ * Only use it in loops without conflicts (do_all, or for_each with
+ * disable_conflict_detection): an aborted for_each iteration is unwound with
+ * longjmp by default, which skips the destructor and leaves its allocations
+ * in the arena. Loops that can abort and keep nothing in the arena across
+ * iterations should instead reset the local arena at the start of every
+ * iteration.
+ *
+ * \code
+ * galois::PerThreadArena arena;
+ * galois::do_all(galois::iterate(graph), [&](GNode n) {
+ *   galois::ArenaScope scope(arena);
+ *   std::vector<GNode, galois::ArenaAllocator<GNode>> tmp(scope.allocator());
+ *   ...
+ * });
+ * \endcode
+ */
+class ArenaScope {
+  ArenaHeapTy& heap;
+  ArenaHeapTy::Checkpoint start;
+
+public:
+  explicit ArenaScope(ArenaHeapTy& h) : heap(h), start(h.checkpoint()) {}
+  template <typename Arena>
+  explicit ArenaScope(Arena& arena) : ArenaScope(arena.local()) {}
+
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+  ~ArenaScope() { heap.rewind(start); }
+
+  //! Allocator for containers that live in this scope
+  ArenaAllocator<char> allocator() const {
+    return ArenaAllocator<char>(&heap);
+  }
+};
+
+/**
+ * Per-thread arenas for temporaries of loop operators. Unlike the
+ * per-iteration allocator of for_each, which returns its memory after every
+ * iteration, the memory of an arena is kept across iterations and loops and
+ * only handed back in bulk: by an ArenaScope at the end of an iteration, by
+ * reset between loops, or when the arena is destroyed. It can be used from
+ * do_all as well as for_each.
+ */
+class PerThreadArena {
+  substrate::PerThreadStorage<ArenaHeapTy> heaps;
+
+public:
+  //! Arena of the calling thread
+  ArenaHeapTy& local() { return *heaps.getLocal(); }
+
+  //! Allocator for the arena of the calling thread
+  ArenaAllocator<char> allocator() { return ArenaAllocator<char>(&local()); }
+
+  /**
+   * Frees all allocations of all threads but keeps the memory. Must not run
+   * concurrently with allocations.
+   */
+  void reset() {
+    for (unsigned i = 0; i < heaps.size(); ++i) {
+      heaps.getRemote(i)->reset();
+    }
+  }
+
+  //! Reports the bytes served and the number of rewinds of every thread
+  void reportStats(const std::string& region) {
+    galois::on_each([&](unsigned, unsigned) {
+      ArenaHeapTy& heap = local();
+      runtime::reportStat_Tsum(region, "ArenaBytesServed", heap.bytesServed());
+      runtime::reportStat_Tsum(region, "ArenaResets", heap.numRewinds());
+    });
+  }
+};
+
+} // namespace galois
+
+#endif
@@ -21,12 +21,16 @@
 #define GALOIS_BAG_H
 
 #include <algorithm>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
+#include <boost/iterator/counting_iterator.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 
 #include "galois/config.h"
 #include "galois/gstl.h"
+#include "galois/ParallelSTL.h"
 #include "galois/runtime/Executor_OnEach.h"
 #include "galois/substrate/PerThreadStorage.h"
 #include "galois/gIO.h"
@@ -34,9 +38,17 @@
 
 namespace galois {
 
+template <typename T>
+class LargeArray;
+
 /**
  * Unordered collection of elements. This data structure supports scalable
  * concurrent pushes but reading the bag can only be done serially.
+ *
+ * Elements are stored in blocks that every thread links into its own list.
+ * Clearing the bag keeps the blocks of each thread for its later pushes, so
+ * a bag that is refilled every round stops allocating after the largest
+ * round; the blocks are freed by shrink_to_fit or the destructor.
  */
 template <typename T, unsigned int BlockSize = 0>
 class InsertBag {
@@ -126,6 +138,8 @@ public:
 private:
   galois::runtime::FixedSizeHeap heap;
   galois::substrate::PerThreadStorage<PerThread> heads;
+  //! emptied blocks of each thread
+  galois::substrate::PerThreadStorage<header*> spares;
 
   void insHeader(header* h) {
     PerThread& hpair = *heads.getLocal();
@@ -151,6 +165,14 @@ private:
   }
 
   header* newHeader() {
+    header*& spare = *spares.getLocal();
+    if (spare) {
+      header* H = spare;
+      spare     = H->next;
+      H->dend   = H->dbegin;
+      H->next   = 0;
+      return H;
+    }
     if (BlockSize) {
       return newHeaderFromHeap(heap.allocate(BlockSize), BlockSize);
     } else {
@@ -159,42 +181,60 @@ private:
     }
   }
 
+  void freeHeader(header* h) {
+    if (BlockSize)
+      heap.deallocate(h);
+    else
+      galois::runtime::pagePoolFree(h);
+  }
+
+  //! Destroys the elements of a thread and moves its blocks to its spares
+  void recycle(PerThread& hpair, header*& spare) {
+    header*& h = hpair.first;
+    while (h) {
+      uninitialized_destroy(h->dbegin, h->dend);
+      header* h2 = h;
+      h          = h->next;
+      h2->next   = spare;
+      spare      = h2;
+    }
+    hpair.second = 0;
+  }
+
+  void releaseSpares(header*& spare) {
+    while (spare) {
+      header* h2 = spare;
+      spare      = spare->next;
+      freeHeader(h2);
+    }
+  }
+
   void destruct_serial() {
     for (unsigned x = 0; x < heads.size(); ++x) {
-      PerThread& hpair = *heads.getRemote(x);
-      header*& h       = hpair.first;
-      while (h) {
-        uninitialized_destroy(h->dbegin, h->dend);
-        header* h2 = h;
-        h          = h->next;
-        if (BlockSize)
-          heap.deallocate(h2);
-        else
-          galois::runtime::pagePoolFree(h2);
-      }
-      hpair.second = 0;
+      recycle(*heads.getRemote(x), *spares.getRemote(x));
     }
   }
 
   void destruct_parallel(void) {
     galois::runtime::on_each_gen(
         [this](const unsigned int tid, const unsigned int) {
-          PerThread& hpair = *heads.getLocal(tid);
-          header*& h       = hpair.first;
-          while (h) {
-            uninitialized_destroy(h->dbegin, h->dend);
-            header* h2 = h;
-            h          = h->next;
-            if (BlockSize)
-              heap.deallocate(h2);
-            else
-              galois::runtime::pagePoolFree(h2);
-          }
-          hpair.second = 0;
+          recycle(*heads.getLocal(tid), *spares.getLocal(tid));
         },
         std::make_tuple(galois::no_stats()));
   }
 
+  //! Appends the blocks of all threads to blocks with their offsets
+  size_t collectBlocks(std::vector<std::pair<header*, size_t>>& blocks) const {
+    size_t n = 0;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        blocks.emplace_back(h, n);
+        n += h->dend - h->dbegin;
+      }
+    }
+    return n;
+  }
+
 public:
   // static_assert(BlockSize == 0 || BlockSize >= (2 * sizeof(T) +
   // sizeof(header)),
@@ -204,26 +244,40 @@ public:
   InsertBag(InsertBag&& o) : heap(BlockSize) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(spares, o.spares);
   }
 
   InsertBag& operator=(InsertBag&& o) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(spares, o.spares);
     return *this;
   }
 
   InsertBag(const InsertBag&) = delete;
   InsertBag& operator=(const InsertBag&) = delete;
 
-  ~InsertBag() { destruct_parallel(); }
+  ~InsertBag() {
+    destruct_parallel();
+    shrink_to_fit();
+  }
 
+  //! Empties the bag; keeps the blocks for later pushes
   void clear() { destruct_parallel(); }
 
   void clear_serial() { destruct_serial(); }
 
+  //! Frees the blocks kept by clear. Do NOT call in a parallel region.
+  void shrink_to_fit() {
+    for (unsigned x = 0; x < spares.size(); ++x) {
+      releaseSpares(*spares.getRemote(x));
+    }
+  }
+
   void swap(InsertBag& o) {
     std::swap(heap, o.heap);
     std::swap(heads, o.heads);
+    std::swap(spares, o.spares);
   }
 
   typedef T value_type;
@@ -247,6 +301,89 @@ public:
     return local_iterator(&heads, galois::substrate::ThreadPool::getTID() + 1);
   }
 
+  //! Number of elements. Do NOT call in a parallel region.
+  size_t size() const {
+    size_t n = 0;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      for (header* h = heads.getRemote(x)->first; h; h = h->next) {
+        n += h->dend - h->dbegin;
+      }
+    }
+    return n;
+  }
+
+  /**
+   * Copy-constructs the elements in iteration order into uninitialized
+   * memory at out, in parallel. The blocks are split evenly among threads,
+   * so every thread copies about size() / threads elements whichever
+   * threads pushed them. Do NOT call in a parallel region.
+   *
+   * @returns number of elements copied
+   */
+  size_t copy_to(T* out) const {
+    std::vector<std::pair<header*, size_t>> blocks;
+    size_t n = collectBlocks(blocks);
+    galois::runtime::on_each_gen(
+        [&](const unsigned int tid, const unsigned int numThreads) {
+          size_t b = blocks.size() * tid / numThreads;
+          size_t e = blocks.size() * (tid + 1) / numThreads;
+          for (; b < e; ++b) {
+            header* h = blocks[b].first;
+            std::uninitialized_copy(h->dbegin, h->dend, out + blocks[b].second);
+          }
+        },
+        std::make_tuple(galois::no_stats()));
+    return n;
+  }
+
+  /**
+   * Replaces the contents of arr by the elements of the bag in iteration
+   * order, so that the next round can iterate over a contiguous array. arr
+   * is reallocated, interleaved over NUMA nodes, only if its size changes.
+   * Needs galois/LargeArray.h. Do NOT call in a parallel region.
+   */
+  void to_array(LargeArray<T>& arr) const {
+    size_t n = size();
+    arr.destroy();
+    if (arr.size() != n || !arr.data()) {
+      arr.deallocate();
+      arr.allocateInterleaved(n);
+    }
+    copy_to(arr.data());
+  }
+
+  /**
+   * Like to_array, but keeps one copy of every group of equal elements, in
+   * sorted order. Needs galois/LargeArray.h. Do NOT call in a parallel
+   * region.
+   *
+   * @param comp strict weak order of the elements
+   */
+  template <typename Compare = std::less<T>>
+  void to_unique_array(LargeArray<T>& arr, Compare comp = Compare()) const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "to_unique_array needs trivially copyable elements");
+    LargeArray<T> all;
+    to_array(all);
+    T* a = all.data();
+    galois::ParallelSTL::sort(a, a + all.size(), comp);
+
+    // the first of each group is not equal to its predecessor
+    auto first = [&](size_t i) { return i == 0 || comp(a[i - 1], a[i]); };
+    size_t m   = galois::ParallelSTL::count_if(
+        boost::counting_iterator<size_t>(0),
+        boost::counting_iterator<size_t>(all.size()), first);
+
+    arr.destroy();
+    if (arr.size() != m || !arr.data()) {
+      arr.deallocate();
+      arr.allocateInterleaved(m);
+    }
+    // copy_if passes references into all, so the index is known
+    galois::ParallelSTL::copy_if(a, a + all.size(), arr.data(),
+                                 [&](const T& x) { return first(&x - a); });
+  }
+
   bool empty() const {
     for (unsigned x = 0; x < heads.size(); ++x) {
       header* h = heads.getRemote(x)->first;
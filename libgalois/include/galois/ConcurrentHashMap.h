@@ -0,0 +1,320 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_CONCURRENTHASHMAP_H
+#define GALOIS_CONCURRENTHASHMAP_H
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+
+namespace internal {
+
+//! Spreads the bits of a hash; std::hash of integers is the identity
+inline uint64_t mixHash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+} // namespace internal
+
+/**
+ * Serial hash map with open addressing and linear probing. Keys and values
+ * live in separate arrays next to an array of one control byte per slot that
+ * holds 7 bits of the hash, so probes compare keys only on a likely match.
+ * The table doubles when it is 3/4 full. There is no erase.
+ *
+ * Keys are copied into the table; clear keeps the allocated slots.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class OpenHashMap {
+  static constexpr uint8_t EMPTY = 0;
+
+  std::vector<uint8_t> ctrl;
+  std::vector<K> keys;
+  std::vector<V> values;
+  size_t numEntries = 0;
+  unsigned logCapacity = 0;
+
+  Hash hasher;
+  KeyEqual equal;
+
+  static uint8_t tag(uint64_t h) { return 0x80 | (h & 0x7F); }
+
+  size_t slot(uint64_t h) const {
+    return logCapacity ? h >> (64 - logCapacity) : 0;
+  }
+
+  void grow() {
+    std::vector<uint8_t> oldCtrl = std::move(ctrl);
+    std::vector<K> oldKeys       = std::move(keys);
+    std::vector<V> oldValues     = std::move(values);
+
+    logCapacity = logCapacity ? logCapacity + 1 : 4;
+    size_t cap  = size_t{1} << logCapacity;
+    ctrl.assign(cap, EMPTY);
+    keys.resize(cap);
+    values.resize(cap);
+
+    for (size_t i = 0; i < oldCtrl.size(); ++i) {
+      if (oldCtrl[i] != EMPTY) {
+        uint64_t h = internal::mixHash(hasher(oldKeys[i]));
+        size_t s   = slot(h);
+        while (ctrl[s] != EMPTY) {
+          s = (s + 1) & (cap - 1);
+        }
+        ctrl[s]   = oldCtrl[i];
+        keys[s]   = std::move(oldKeys[i]);
+        values[s] = std::move(oldValues[i]);
+      }
+    }
+  }
+
+public:
+  //! Hash of key as used by the map
+  uint64_t hashOf(const K& key) const {
+    return internal::mixHash(hasher(key));
+  }
+
+  /**
+   * Inserts (key, value) if key is not in the map; otherwise calls
+   * combine(old, value), which updates the old value in place.
+   *
+   * @returns true if key was inserted
+   */
+  template <typename Combine>
+  bool update(const K& key, const V& value, const Combine& combine) {
+    return update(hashOf(key), key, value, combine);
+  }
+
+  //! update with the hash of key already computed by hashOf
+  template <typename Combine>
+  bool update(uint64_t h, const K& key, const V& value,
+              const Combine& combine) {
+    if (4 * (numEntries + 1) > 3 * ctrl.size()) {
+      grow();
+    }
+    size_t mask = ctrl.size() - 1;
+    uint8_t t   = tag(h);
+    for (size_t s = slot(h);; s = (s + 1) & mask) {
+      if (ctrl[s] == EMPTY) {
+        ctrl[s]   = t;
+        keys[s]   = key;
+        values[s] = value;
+        ++numEntries;
+        return true;
+      }
+      if (ctrl[s] == t && equal(keys[s], key)) {
+        combine(values[s], value);
+        return false;
+      }
+    }
+  }
+
+  //! Value of key or nullptr if key is not in the map
+  V* find(const K& key) {
+    if (numEntries == 0) {
+      return nullptr;
+    }
+    uint64_t h  = hashOf(key);
+    size_t mask = ctrl.size() - 1;
+    uint8_t t   = tag(h);
+    for (size_t s = slot(h); ctrl[s] != EMPTY; s = (s + 1) & mask) {
+      if (ctrl[s] == t && equal(keys[s], key)) {
+        return &values[s];
+      }
+    }
+    return nullptr;
+  }
+
+  //! Calls fn(key, value) on every entry
+  template <typename F>
+  void forEach(const F& fn) {
+    for (size_t s = 0; s < ctrl.size(); ++s) {
+      if (ctrl[s] != EMPTY) {
+        fn(const_cast<const K&>(keys[s]), values[s]);
+      }
+    }
+  }
+
+  size_t size() const { return numEntries; }
+  bool empty() const { return numEntries == 0; }
+
+  //! Removes every entry but keeps the memory
+  void clear() {
+    if (numEntries) {
+      std::fill(ctrl.begin(), ctrl.end(), EMPTY);
+      numEntries = 0;
+    }
+  }
+
+  friend void swap(OpenHashMap& a, OpenHashMap& b) {
+    using std::swap;
+    swap(a.ctrl, b.ctrl);
+    swap(a.keys, b.keys);
+    swap(a.values, b.values);
+    swap(a.numEntries, b.numEntries);
+    swap(a.logCapacity, b.logCapacity);
+  }
+};
+
+/**
+ * Hash map for aggregating values by key from all threads, e.g., counting
+ * patterns. Every thread inserts into or updates its own OpenHashMaps without
+ * synchronization; merge then combines the per-thread maps in parallel.
+ *
+ * The key space is split into a few partitions per thread by hash, and every
+ * thread keeps one table per partition, so partition p can be merged from
+ * the p-th tables of all threads independently of the other partitions.
+ * After merge, the merged map can be searched and iterated (serially or in
+ * parallel), and updates go to the per-thread maps again until the next
+ * merge.
+ *
+ * @tparam Combine combines two values of the same key (default: addition)
+ */
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>,
+          typename Combine = std::plus<V>>
+class ConcurrentHashMap {
+  using Table = OpenHashMap<K, V, Hash, KeyEqual>;
+
+  unsigned logPartitions;
+  substrate::PerThreadStorage<std::vector<Table>> locals;
+  std::vector<Table> merged;
+  Combine combine;
+
+  size_t partition(uint64_t h) const {
+    return (h >> 7) & ((size_t{1} << logPartitions) - 1);
+  }
+
+public:
+  ConcurrentHashMap(Combine c = Combine()) : logPartitions(0), combine(c) {
+    while ((1u << logPartitions) < 4 * galois::getActiveThreads()) {
+      ++logPartitions;
+    }
+    merged.resize(size_t{1} << logPartitions);
+  }
+
+  /**
+   * Adds value to key in the map of the calling thread.
+   *
+   * @returns true if key was new to the thread's map
+   */
+  bool update(const K& key, const V& value) {
+    std::vector<Table>& tables = *locals.getLocal();
+    if (tables.empty()) {
+      tables.resize(merged.size());
+    }
+    uint64_t h = tables[0].hashOf(key);
+    return tables[partition(h)].update(
+        h, key, value, [&](V& a, const V& b) { a = combine(a, b); });
+  }
+
+  /**
+   * Combines the maps of all threads into the merged map, which is replaced.
+   * The per-thread maps are emptied.
+   */
+  void merge() {
+    size_t numPartitions = merged.size();
+    galois::do_all(
+        galois::iterate(size_t{0}, numPartitions),
+        [&](size_t p) {
+          Table& out = merged[p];
+          out.clear();
+          for (unsigned t = 0; t < locals.size(); ++t) {
+            std::vector<Table>& tables = *locals.getRemote(t);
+            if (tables.empty() || tables[p].empty()) {
+              continue;
+            }
+            Table& in = tables[p];
+            if (out.empty()) {
+              // take over the first map of this partition without copying
+              swap(out, in);
+              continue;
+            }
+            in.forEach([&](const K& key, V& value) {
+              out.update(key, value,
+                         [&](V& a, const V& b) { a = combine(a, b); });
+            });
+            in.clear();
+          }
+        },
+        galois::steal(), galois::no_stats(), galois::loopname("HashMapMerge"));
+  }
+
+  //! Number of keys in the merged map
+  size_t size() const {
+    size_t n = 0;
+    for (auto& t : merged) {
+      n += t.size();
+    }
+    return n;
+  }
+
+  //! Value of key in the merged map or nullptr
+  V* find(const K& key) {
+    uint64_t h = merged[0].hashOf(key);
+    return merged[partition(h)].find(key);
+  }
+
+  //! Calls fn(key, value) on every entry of the merged map serially
+  template <typename F>
+  void forEach(const F& fn) {
+    for (auto& t : merged) {
+      t.forEach(fn);
+    }
+  }
+
+  //! Calls fn(key, value) on every entry of the merged map in parallel
+  template <typename F>
+  void parallelForEach(const F& fn) {
+    galois::do_all(
+        galois::iterate(size_t{0}, merged.size()),
+        [&](size_t p) { merged[p].forEach(fn); }, galois::steal(),
+        galois::no_stats(), galois::loopname("HashMapForEach"));
+  }
+
+  //! Empties the merged map and the maps of all threads
+  void clear() {
+    for (auto& t : merged) {
+      t.clear();
+    }
+    for (unsigned t = 0; t < locals.size(); ++t) {
+      for (auto& table : *locals.getRemote(t)) {
+        table.clear();
+      }
+    }
+  }
+};
+
+} // namespace galois
+
+#endif
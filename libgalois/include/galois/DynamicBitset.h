@@ -26,11 +26,13 @@
 #ifndef _GALOIS_DYNAMIC_BIT_SET_
 #define _GALOIS_DYNAMIC_BIT_SET_
 
+#include <algorithm>
 #include <climits>
 #include <vector>
 #include <cassert>
 
 #include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/mpl/has_xxx.hpp>
 
 #include "galois/config.h"
@@ -43,6 +45,11 @@
 namespace galois {
 /**
  * Concurrent dynamically allocated bitset
+ *
+ * Bulk operations (bitwise_*, count, offsets) work on blocks of
+ * block_words words in parallel, with plain loops over the words that the
+ * compiler vectorizes for the target architecture. They assume that no bit
+ * is set or reset concurrently.
  **/
 class DynamicBitSet {
 protected:
@@ -50,7 +57,128 @@ protected:
   size_t num_bits;
   static constexpr uint32_t bits_uint64 = sizeof(uint64_t) * CHAR_BIT;
 
+  static_assert(sizeof(galois::CopyableAtomic<uint64_t>) == sizeof(uint64_t),
+                "bulk operations access the words directly");
+
+  //! The words of the bitset, for bulk operations
+  uint64_t* words() { return reinterpret_cast<uint64_t*>(bitvec.data()); }
+
+  //! The words of the bitset, for bulk operations
+  const uint64_t* words() const {
+    return reinterpret_cast<const uint64_t*>(bitvec.data());
+  }
+
+  static uint64_t popcount(uint64_t n) {
+#ifdef __GNUC__
+    return __builtin_popcountll(n);
+#else
+    n = n - ((n >> 1) & 0x5555555555555555UL);
+    n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
+    return (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
+           56;
+#endif
+  }
+
+  //! Index of the lowest set bit of n, which must not be 0
+  static unsigned lowest_bit(uint64_t n) {
+#ifdef __GNUC__
+    return __builtin_ctzll(n);
+#else
+    unsigned i = 0;
+    while (!(n & 1)) {
+      n >>= 1;
+      ++i;
+    }
+    return i;
+#endif
+  }
+
+  static uint64_t popcount_words(const uint64_t* w, size_t n) {
+    uint64_t c = 0;
+    for (size_t i = 0; i < n; ++i) {
+      c += popcount(w[i]);
+    }
+    return c;
+  }
+
+  //! Runs fn(begin, end) on the word ranges of all blocks in parallel
+  template <typename F>
+  void for_each_block(const F& fn) const {
+    size_t n = bitvec.size();
+    galois::do_all(
+        galois::iterate(size_t{0}, num_blocks()),
+        [&](size_t b) {
+          size_t beg = b * block_words;
+          fn(beg, std::min(n, beg + block_words));
+        },
+        galois::no_stats());
+  }
+
 public:
+  //! Number of words that bulk operations and the prefix index group
+  static constexpr size_t block_words = 256;
+
+  /**
+   * Number of set bits before every block of a bitset. Building it counts
+   * the bits of all blocks in parallel; afterwards, the number of bits set
+   * before any bit and the offsets of the set bits can be computed in
+   * parallel without counting again. Valid until the bitset changes.
+   */
+  class PrefixIndex {
+    friend class DynamicBitSet;
+    //! prefix[b] is the number of bits set before block b
+    std::vector<uint64_t> prefix;
+
+  public:
+    //! Number of set bits in the bitset
+    uint64_t count() const { return prefix.empty() ? 0 : prefix.back(); }
+  };
+
+  /**
+   * Forward iterator over the indices of the set bits, which skips a whole
+   * word of zeros at a time and finds the next bit in a word with a trailing
+   * zero count.
+   */
+  class set_iterator
+      : public boost::iterator_facade<set_iterator, size_t,
+                                      std::forward_iterator_tag, size_t> {
+    friend class boost::iterator_core_access;
+
+    const uint64_t* w;
+    size_t num_words;
+    size_t word;
+    //! bits of word that have not been visited yet
+    uint64_t rest;
+
+    void skip_zeros() {
+      while (!rest && ++word < num_words) {
+        rest = w[word];
+      }
+    }
+
+    size_t dereference() const { return word * bits_uint64 + lowest_bit(rest); }
+
+    void increment() {
+      rest &= rest - 1;
+      skip_zeros();
+    }
+
+    bool equal(const set_iterator& o) const {
+      return word == o.word && rest == o.rest;
+    }
+
+  public:
+    set_iterator() : w(nullptr), num_words(0), word(0), rest(0) {}
+
+    set_iterator(const uint64_t* words, size_t n, size_t first)
+        : w(words), num_words(n), word(first), rest(0) {
+      if (word < num_words) {
+        rest = w[word];
+        skip_zeros();
+      }
+    }
+  };
+
   //! Constructor which initializes to an empty bitset.
   DynamicBitSet() : num_bits(0) {}
 
@@ -98,6 +226,11 @@ public:
    */
   size_t size() const { return num_bits; }
 
+  //! Number of blocks of block_words words
+  size_t num_blocks() const {
+    return (bitvec.size() + block_words - 1) / block_words;
+  }
+
   /**
    * Gets the space taken by the bitset
    * @returns the space in bytes taken by this bitset
@@ -240,10 +373,13 @@ public:
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_or(const DynamicBitSet& other) {
     assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] |= other_bitvec[i]; }, galois::no_stats());
+    uint64_t* a       = words();
+    const uint64_t* b = other.words();
+    for_each_block([&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; ++i) {
+        a[i] |= b[i];
+      }
+    });
   }
 
   // assumes bit_vector is not updated (set) in parallel
@@ -255,10 +391,13 @@ public:
    */
   void bitwise_and(const DynamicBitSet& other) {
     assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] &= other_bitvec[i]; }, galois::no_stats());
+    uint64_t* a       = words();
+    const uint64_t* b = other.words();
+    for_each_block([&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; ++i) {
+        a[i] &= b[i];
+      }
+    });
   }
 
   /**
@@ -271,13 +410,14 @@ public:
   void bitwise_and(const DynamicBitSet& other1, const DynamicBitSet& other2) {
     assert(size() == other1.size());
     assert(size() == other2.size());
-    auto& other_bitvec1 = other1.get_vec();
-    auto& other_bitvec2 = other2.get_vec();
-
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] = other_bitvec1[i] & other_bitvec2[i]; },
-        galois::no_stats());
+    uint64_t* a       = words();
+    const uint64_t* b = other1.words();
+    const uint64_t* c = other2.words();
+    for_each_block([&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; ++i) {
+        a[i] = b[i] & c[i];
+      }
+    });
   }
 
   /**
@@ -287,10 +427,13 @@ public:
    */
   void bitwise_xor(const DynamicBitSet& other) {
     assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] ^= other_bitvec[i]; }, galois::no_stats());
+    uint64_t* a       = words();
+    const uint64_t* b = other.words();
+    for_each_block([&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; ++i) {
+        a[i] ^= b[i];
+      }
+    });
   }
 
   /**
@@ -303,13 +446,14 @@ public:
   void bitwise_xor(const DynamicBitSet& other1, const DynamicBitSet& other2) {
     assert(size() == other1.size());
     assert(size() == other2.size());
-    auto& other_bitvec1 = other1.get_vec();
-    auto& other_bitvec2 = other2.get_vec();
-
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-        galois::no_stats());
+    uint64_t* a       = words();
+    const uint64_t* b = other1.words();
+    const uint64_t* c = other2.words();
+    for_each_block([&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; ++i) {
+        a[i] = b[i] ^ c[i];
+      }
+    });
   }
 
   /**
@@ -319,87 +463,121 @@ public:
    */
   uint64_t count() const {
     galois::GAccumulator<uint64_t> ret;
-    galois::do_all(
-        galois::iterate(bitvec.begin(), bitvec.end()),
-        [&](uint64_t n) {
-#ifdef __GNUC__
-          ret += __builtin_popcountll(n);
-#else
-          n = n - ((n >> 1) & 0x5555555555555555UL);
-          n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-          ret +=
-              (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-              56;
-#endif
-        },
-        galois::no_stats());
+    const uint64_t* w = words();
+    for_each_block([&](size_t beg, size_t end) {
+      ret += popcount_words(w + beg, end - beg);
+    });
     return ret.reduce();
   }
 
+  /**
+   * Computes the number of set bits before every block in parallel.
+   * Do NOT call in a parallel region as it uses galois::do_all.
+   *
+   * @param index output: the prefix index of this bitset
+   */
+  void build_index(PrefixIndex& index) const {
+    auto& prefix = index.prefix;
+    prefix.assign(num_blocks() + 1, 0);
+    const uint64_t* w = words();
+    for_each_block([&](size_t beg, size_t end) {
+      prefix[beg / block_words + 1] = popcount_words(w + beg, end - beg);
+    });
+    for (size_t b = 1; b < prefix.size(); ++b) {
+      prefix[b] += prefix[b - 1];
+    }
+  }
+
+  /**
+   * Number of set bits with an index smaller than i
+   *
+   * @param index prefix index of the current state of this bitset
+   * @param i bit index, at most size()
+   */
+  uint64_t rank(const PrefixIndex& index, size_t i) const {
+    size_t word  = i / bits_uint64;
+    size_t block = word / block_words;
+    uint64_t r   = index.prefix[block] +
+                 popcount_words(words() + block * block_words,
+                                word - block * block_words);
+    if (i % bits_uint64) {
+      r += popcount(words()[word] & ((uint64_t(1) << (i % bits_uint64)) - 1));
+    }
+    return r;
+  }
+
+  /**
+   * Writes the indices of the set bits in increasing order. Every block
+   * writes its own part of the output in parallel.
+   * Do NOT call in a parallel region as it uses galois::do_all.
+   *
+   * @param index prefix index of the current state of this bitset
+   * @param offsets output: room for index.count() offsets
+   */
+  template <typename T>
+  void get_offsets(const PrefixIndex& index, T* offsets) const {
+    const uint64_t* w = words();
+    for_each_block([&](size_t beg, size_t end) {
+      T* out = offsets + index.prefix[beg / block_words];
+      for (size_t i = beg; i < end; ++i) {
+        for (uint64_t rest = w[i]; rest; rest &= rest - 1) {
+          *out++ = T(i * bits_uint64 + lowest_bit(rest));
+        }
+      }
+    });
+  }
+
   /**
    * Returns a vector containing the set bits in this bitset in order
    * from left to right.
-   * Do NOT call in a parallel region as it uses galois::on_each.
+   * Do NOT call in a parallel region as it uses galois::do_all.
    *
    * @returns vector with offsets into set bits
    */
   // TODO uint32_t is somewhat dangerous; change in the future
   std::vector<uint32_t> getOffsets() const {
-    uint32_t activeThreads = galois::getActiveThreads();
-    std::vector<unsigned int> tPrefixBitCounts(activeThreads);
-
-    // count how many bits are set on each thread
-    galois::on_each([&](unsigned tid, unsigned nthreads) {
-      size_t start;
-      size_t end;
-      std::tie(start, end) =
-          galois::block_range((size_t)0, this->size(), tid, nthreads);
-
-      unsigned int count = 0;
-      for (unsigned int i = start; i < end; ++i) {
-        if (this->test(i))
-          ++count;
-      }
-
-      tPrefixBitCounts[tid] = count;
-    });
-
-    // calculate prefix sum of bits per thread
-    for (unsigned int i = 1; i < activeThreads; ++i) {
-      tPrefixBitCounts[i] += tPrefixBitCounts[i - 1];
+    PrefixIndex index;
+    build_index(index);
+    std::vector<uint32_t> offsets(index.count());
+    if (!offsets.empty()) {
+      get_offsets(index, offsets.data());
     }
+    return offsets;
+  }
 
-    // total num of set bits
-    uint64_t bitsetCount = tPrefixBitCounts[activeThreads - 1];
-    std::vector<uint32_t> offsets;
-
-    // calculate the indices of the set bits and save them to the offset
-    // vector
-    if (bitsetCount > 0) {
-      offsets.resize(bitsetCount);
-      galois::on_each([&](unsigned tid, unsigned nthreads) {
-        size_t start;
-        size_t end;
-        std::tie(start, end) =
-            galois::block_range((size_t)0, this->size(), tid, nthreads);
-        unsigned int count = 0;
-        unsigned int tPrefixBitCount;
-        if (tid == 0) {
-          tPrefixBitCount = 0;
-        } else {
-          tPrefixBitCount = tPrefixBitCounts[tid - 1];
-        }
+  //! First set bit
+  set_iterator begin_set() const {
+    return set_iterator(words(), bitvec.size(), 0);
+  }
 
-        for (unsigned int i = start; i < end; ++i) {
-          if (this->test(i)) {
-            offsets[tPrefixBitCount + count] = i;
-            ++count;
-          }
-        }
-      });
-    }
+  //! End of the set bits
+  set_iterator end_set() const {
+    return set_iterator(words(), bitvec.size(), bitvec.size());
+  }
 
-    return offsets;
+  /**
+   * Calls fn(i) for every set bit i in parallel. Threads take whole blocks,
+   * so the bits of a block are visited in order by one thread.
+   * Do NOT call in a parallel region as it uses galois::do_all.
+   *
+   * @param fn function called with the index of every set bit
+   * @param args extra arguments of galois::do_all, e.g., galois::loopname
+   */
+  template <typename F, typename... Args>
+  void do_all_set(const F& fn, Args&&... args) const {
+    const uint64_t* w = words();
+    size_t n          = bitvec.size();
+    galois::do_all(
+        galois::iterate(size_t{0}, num_blocks()),
+        [&](size_t b) {
+          size_t end = std::min(n, (b + 1) * block_words);
+          for (size_t i = b * block_words; i < end; ++i) {
+            for (uint64_t rest = w[i]; rest; rest &= rest - 1) {
+              fn(i * bits_uint64 + lowest_bit(rest));
+            }
+          }
+        },
+        galois::steal(), std::forward<Args>(args)...);
   }
 
   //! this is defined to
@@ -21,7 +21,10 @@
 #define GALOIS_FLATMAP_H
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
@@ -378,4 +381,286 @@ inline void swap(galois::flat_map<_Key, _Tp, _Compare, _Alloc>& __x,
 
 } // namespace std
 
+namespace galois {
+
+/**
+ * Sorted map for small key types that is mostly searched and rarely
+ * modified, e.g., the per-thread bucket maps of OBIM. Keys and values are
+ * kept in separate sorted arrays, so a search only touches keys.
+ *
+ * Up to LINEAR_SEARCH_MAX keys, lower_bound counts the keys that compare
+ * less than the searched key without branches, which the compiler
+ * vectorizes for arithmetic keys. Larger maps also keep a copy of the keys
+ * in Eytzinger (BFS) order, where the path of a binary search is laid out
+ * front to back and the next levels can be prefetched. The copy is rebuilt
+ * on every insert and erase.
+ *
+ * Iterators are invalidated by insert and erase and dereference to a
+ * std::pair of references to the key and the value.
+ */
+template <class Key, class T, class Compare = std::less<Key>>
+class split_flat_map {
+public:
+  static constexpr size_t LINEAR_SEARCH_MAX = 32;
+
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef std::pair<Key, T> value_type;
+  typedef Compare key_compare;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+private:
+  std::vector<Key> keys;
+  std::vector<T> values;
+  //! keys in Eytzinger order starting at index 1, if there are many
+  std::vector<Key> eytzKeys;
+  //! index in keys of every element of eytzKeys
+  std::vector<uint32_t> eytzRank;
+  Compare comp;
+
+  size_t buildEytzinger(size_t i, size_t k) {
+    if (k <= keys.size()) {
+      i           = buildEytzinger(i, 2 * k);
+      eytzKeys[k] = keys[i];
+      eytzRank[k] = i++;
+      i           = buildEytzinger(i, 2 * k + 1);
+    }
+    return i;
+  }
+
+  void rebuild() {
+    if (keys.size() <= LINEAR_SEARCH_MAX) {
+      eytzKeys.clear();
+      eytzRank.clear();
+      return;
+    }
+    eytzKeys.assign(keys.size() + 1, keys[0]);
+    eytzRank.resize(keys.size() + 1);
+    buildEytzinger(0, 1);
+  }
+
+  //! Index of the first key not less than x
+  size_t lowerBoundIndex(const Key& x) const {
+    size_t n = keys.size();
+    if (n <= LINEAR_SEARCH_MAX) {
+      const Key* k = keys.data();
+      size_t i     = 0;
+      for (size_t j = 0; j < n; ++j) {
+        i += comp(k[j], x);
+      }
+      return i;
+    }
+    // a cache line holds the 4th level of the subtree below k
+    constexpr size_t ahead = std::max<size_t>(1, 64 / sizeof(Key));
+    const Key* e           = eytzKeys.data();
+    size_t k               = 1;
+    while (k <= n) {
+      if (ahead * k <= n) {
+        __builtin_prefetch(e + ahead * k);
+      }
+      k = 2 * k + comp(e[k], x);
+    }
+    // undo the right turns after the last left turn
+    k >>= __builtin_ffsll(~k);
+    return k ? eytzRank[k] : n;
+  }
+
+  bool keyEq(const Key& a, const Key& b) const {
+    return !comp(a, b) && !comp(b, a);
+  }
+
+  template <bool Const>
+  class Iterator {
+    friend class split_flat_map;
+    template <bool>
+    friend class Iterator;
+    using Map = typename std::conditional<Const, const split_flat_map,
+                                          split_flat_map>::type;
+    using Value = typename std::conditional<Const, const T, T>::type;
+
+    Map* map;
+    size_t i;
+
+    Iterator(Map* m, size_t idx) : map(m), i(idx) {}
+
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef std::pair<const Key&, Value&> reference;
+    typedef typename split_flat_map::value_type value_type;
+    typedef ptrdiff_t difference_type;
+
+    //! Holds the pair of references for operator->
+    struct pointer {
+      reference ref;
+      reference* operator->() { return &ref; }
+    };
+
+    Iterator() : map(nullptr), i(0) {}
+    //! iterator to const_iterator
+    template <bool C = Const, typename = typename std::enable_if<C>::type>
+    Iterator(const Iterator<false>& o) : map(o.map), i(o.i) {}
+
+    reference operator*() const {
+      return reference(map->keys[i], map->values[i]);
+    }
+    pointer operator->() const { return pointer{**this}; }
+
+    Iterator& operator++() {
+      ++i;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator tmp(*this);
+      ++i;
+      return tmp;
+    }
+    Iterator& operator--() {
+      --i;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator tmp(*this);
+      --i;
+      return tmp;
+    }
+
+    bool operator==(const Iterator& o) const { return i == o.i; }
+    bool operator!=(const Iterator& o) const { return i != o.i; }
+  };
+
+public:
+  typedef Iterator<false> iterator;
+  typedef Iterator<true> const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  split_flat_map() = default;
+  explicit split_flat_map(const Compare& c) : comp(c) {}
+
+  template <typename InputIterator>
+  split_flat_map(InputIterator first, InputIterator last) {
+    insert(first, last);
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  iterator end() { return iterator(this, keys.size()); }
+  const_iterator end() const { return const_iterator(this, keys.size()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crbegin() const { return rbegin(); }
+  const_reverse_iterator crend() const { return rend(); }
+
+  bool empty() const { return keys.empty(); }
+  size_type size() const { return keys.size(); }
+
+  key_compare key_comp() const { return comp; }
+
+  iterator lower_bound(const Key& x) {
+    return iterator(this, lowerBoundIndex(x));
+  }
+  const_iterator lower_bound(const Key& x) const {
+    return const_iterator(this, lowerBoundIndex(x));
+  }
+
+  iterator find(const Key& x) {
+    size_t i = lowerBoundIndex(x);
+    return iterator(this,
+                    (i < keys.size() && keyEq(keys[i], x)) ? i : keys.size());
+  }
+  const_iterator find(const Key& x) const {
+    size_t i = lowerBoundIndex(x);
+    return const_iterator(
+        this, (i < keys.size() && keyEq(keys[i], x)) ? i : keys.size());
+  }
+
+  size_type count(const Key& x) const { return find(x) == end() ? 0 : 1; }
+
+  /**
+   * Inserts (k, v) if k is not in the map.
+   *
+   * @returns iterator to the value of k and true if it was inserted
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(const Key& k, Args&&... args) {
+    size_t i = lowerBoundIndex(k);
+    if (i < keys.size() && keyEq(keys[i], k)) {
+      return std::make_pair(iterator(this, i), false);
+    }
+    keys.insert(keys.begin() + i, k);
+    values.emplace(values.begin() + i, std::forward<Args>(args)...);
+    rebuild();
+    return std::make_pair(iterator(this, i), true);
+  }
+
+  template <typename PairTy>
+  std::pair<iterator, bool> insert(const PairTy& x) {
+    return emplace(x.first, x.second);
+  }
+
+  template <typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  T& operator[](const Key& k) { return emplace(k).first->second; }
+
+  T& at(const Key& k) {
+    iterator i = find(k);
+    if (i == end())
+      throw std::out_of_range("split_flat_map::at");
+    return i->second;
+  }
+  const T& at(const Key& k) const {
+    const_iterator i = find(k);
+    if (i == end())
+      throw std::out_of_range("split_flat_map::at");
+    return i->second;
+  }
+
+  iterator erase(const_iterator pos) {
+    keys.erase(keys.begin() + pos.i);
+    values.erase(values.begin() + pos.i);
+    rebuild();
+    return iterator(this, pos.i);
+  }
+
+  size_type erase(const Key& k) {
+    const_iterator i = find(k);
+    if (i == end()) {
+      return 0;
+    }
+    erase(i);
+    return 1;
+  }
+
+  void clear() {
+    keys.clear();
+    values.clear();
+    eytzKeys.clear();
+    eytzRank.clear();
+  }
+
+  void swap(split_flat_map& o) {
+    keys.swap(o.keys);
+    values.swap(o.values);
+    eytzKeys.swap(o.eytzKeys);
+    eytzRank.swap(o.eytzRank);
+    std::swap(comp, o.comp);
+  }
+};
+
+} // namespace galois
+
 #endif
@@ -0,0 +1,199 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file Frontier.h
+ *
+ * Set of active nodes of a bulk-synchronous graph algorithm that switches
+ * between a sparse and a dense representation with its size.
+ */
+
+#ifndef GALOIS_FRONTIER_H
+#define GALOIS_FRONTIER_H
+
+#include <cstddef>
+
+#include "galois/config.h"
+#include "galois/Bag.h"
+#include "galois/DynamicBitset.h"
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+
+namespace galois {
+
+/**
+ * Frontier of a bulk-synchronous graph algorithm over nodes 0 to numNodes-1.
+ * The loop over the current frontier pushes the nodes of the next one, and
+ * advance() makes them current:
+ *
+ * @code
+ * galois::Frontier<GNode> frontier(graph.size());
+ * frontier.push(source);
+ * for (frontier.advance(); !frontier.empty(); frontier.advance()) {
+ *   frontier.do_all([&](GNode n) { ... frontier.push(dst); ... }, "Round");
+ * }
+ * @endcode
+ *
+ * Pushes are deduplicated by a bitmap over all nodes. A frontier with more
+ * than numNodes / denseDivisor nodes is dense: loops visit the bitmap a block
+ * of words at a time. Smaller ones are sparse: pushes also go to a bag, which
+ * loops visit instead. Pushes of the next frontier go to the bag only while
+ * the current one is sparse; when the density changes, advance() converts
+ * with one pass over the bag or one scan of the bitmap.
+ */
+template <typename NodeTy>
+class Frontier {
+  //! one of the current and next frontier
+  struct Buffer {
+    DynamicBitSet bits;
+    InsertBag<NodeTy> items;
+    //! number of nodes pushed while collected
+    GAccumulator<size_t> count;
+    //! items holds all nodes of bits
+    bool collected;
+  };
+
+  static const unsigned ChunkSize = 64;
+
+  size_t numNodes;
+  size_t denseThreshold;
+  Buffer buffers[2];
+  Buffer* curr;
+  Buffer* next;
+  size_t currSize = 0;
+  bool currDense  = false;
+
+  //! Empties buf in time proportional to its size
+  void clear(Buffer& buf) {
+    if (buf.collected) {
+      galois::do_all(
+          galois::iterate(buf.items),
+          [&](NodeTy n) { buf.bits.reset(n); }, galois::no_stats());
+    } else {
+      buf.bits.reset();
+    }
+    buf.items.clear();
+    buf.count.reset();
+  }
+
+public:
+  /**
+   * @param numNodes nodes are 0 to numNodes - 1
+   * @param denseDivisor frontiers with more than numNodes / denseDivisor
+   * nodes are dense; must not be 0
+   */
+  explicit Frontier(size_t numNodes, size_t denseDivisor = 20)
+      : numNodes(numNodes), curr(&buffers[0]), next(&buffers[1]) {
+    GALOIS_ASSERT(denseDivisor != 0, "denseDivisor of a Frontier must be > 0");
+    denseThreshold = numNodes / denseDivisor;
+    for (auto& buf : buffers) {
+      buf.bits.resize(numNodes);
+      buf.collected = true;
+    }
+  }
+
+  /**
+   * Adds n to the next frontier. Safe to call concurrently.
+   *
+   * @returns true if n was not in the next frontier yet
+   */
+  bool push(NodeTy n) {
+    // plain read first; most pushes of dense rounds find the bit set
+    if (next->bits.test(n) || next->bits.set(n)) {
+      return false;
+    }
+    if (next->collected) {
+      next->items.push(n);
+      next->count += 1;
+    }
+    return true;
+  }
+
+  //! Adds all nodes to the next frontier. Do NOT call in a parallel region.
+  void push_all() {
+    if (numNodes > denseThreshold) {
+      next->items.clear();
+      next->collected = false;
+    }
+    galois::do_all(
+        galois::iterate(size_t{0}, numNodes),
+        [&](size_t n) { push(n); }, galois::no_stats());
+  }
+
+  /**
+   * Makes the next frontier current and starts an empty next one, choosing
+   * the representation of the new current frontier by its size.
+   * Do NOT call in a parallel region.
+   */
+  void advance() {
+    clear(*curr);
+    std::swap(curr, next);
+
+    // dense pushes are not counted to keep them cheap
+    currSize  = curr->collected ? curr->count.reduce() : curr->bits.count();
+    currDense = currSize > denseThreshold;
+    if (!currDense && !curr->collected) {
+      curr->bits.do_all_set([&](size_t n) { curr->items.push(n); },
+                            galois::no_stats());
+      curr->collected = true;
+    } else if (currDense && curr->collected) {
+      curr->items.clear();
+      curr->collected = false;
+    }
+    // the next frontier is likely as dense as this one
+    next->collected = !currDense;
+  }
+
+  //! Number of nodes of the current frontier
+  size_t size() const { return currSize; }
+
+  bool empty() const { return currSize == 0; }
+
+  //! True if the current frontier is kept as a bitmap
+  bool dense() const { return currDense; }
+
+  //! True if n is in the current frontier
+  bool contains(NodeTy n) const { return curr->bits.test(n); }
+
+  //! Bitmap of the current frontier
+  const DynamicBitSet& bitset() const { return curr->bits; }
+
+  /**
+   * Calls fn(n) on every node n of the current frontier in parallel.
+   * Do NOT call in a parallel region.
+   *
+   * @param fn operator
+   * @param loopname name of the loop for statistics
+   */
+  template <typename F>
+  void do_all(const F& fn, const char* loopname = "ANON_LOOP") const {
+    if (currDense) {
+      curr->bits.do_all_set([&](size_t n) { fn(NodeTy(n)); },
+                            galois::loopname(loopname));
+    } else {
+      galois::do_all(galois::iterate(curr->items), fn, galois::steal(),
+                     galois::chunk_size<ChunkSize>(),
+                     galois::loopname(loopname));
+    }
+  }
+};
+
+} // namespace galois
+
+#endif
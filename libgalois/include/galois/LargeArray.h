@@ -34,15 +34,12 @@
 #include "galois/Galois.h"
 #include "galois/gIO.h"
 #include "galois/ParallelSTL.h"
+#include "galois/Threads.h"
 #include "galois/runtime/Mem.h"
 #include "galois/substrate/NumaMem.h"
 
 namespace galois {
 
-namespace runtime {
-extern unsigned activeThreads;
-} // end namespace runtime
-
 /**
  * Large array of objects with proper specialization for void type and
  * supporting various allocation and construction policies.
@@ -81,13 +78,13 @@ protected:
     switch (t) {
     case Blocked:
       galois::gDebug("Block-alloc'd");
-      m_realdata =
-          substrate::largeMallocBlocked(n * sizeof(T), runtime::activeThreads);
+      m_realdata = substrate::largeMallocBlocked(n * sizeof(T),
+                                                 galois::getActiveThreads());
       break;
     case Interleaved:
       galois::gDebug("Interleave-alloc'd");
-      m_realdata = substrate::largeMallocInterleaved(n * sizeof(T),
-                                                     runtime::activeThreads);
+      m_realdata = substrate::largeMallocInterleaved(
+          n * sizeof(T), galois::getActiveThreads());
       break;
     case Local:
       galois::gDebug("Local-allocd");
@@ -242,7 +239,7 @@ public:
     assert(!m_data);
 
     m_realdata = substrate::largeMallocSpecified(numberOfElements * sizeof(T),
-                                                 runtime::activeThreads,
+                                                 galois::getActiveThreads(),
                                                  threadRanges, sizeof(T));
 
     m_size = numberOfElements;
@@ -20,6 +20,8 @@
 #ifndef GALOIS_LOOPS_H
 #define GALOIS_LOOPS_H
 
+#include <type_traits>
+
 #include "galois/config.h"
 #include "galois/runtime/Executor_Deterministic.h"
 #include "galois/runtime/Executor_DoAll.h"
@@ -103,6 +105,46 @@ static inline void preAlloc(int num) {
   }
 }
 
+namespace internal {
+//! Size of graph data of type T; 0 for void
+template <typename T>
+constexpr size_t dataSize() {
+  if constexpr (std::is_void<T>::value) {
+    return 0;
+  } else {
+    return sizeof(T);
+  }
+}
+} // namespace internal
+
+/**
+ * Preallocates hugepages for the worklists and bags of a run on graph that
+ * hold up to itemsPerNode work items per node and itemsPerEdge per edge at
+ * once, plus one page per thread for partially filled chunks, but no more
+ * than the available memory of the host.
+ *
+ * @tparam WorkItem type of the work items; by default items are sized from
+ * the graph: a node and its data for node items and two nodes and the edge
+ * data for edge items
+ * @returns number of pages preallocated
+ */
+template <typename WorkItem = void, typename GraphTy>
+unsigned preAllocFor(const GraphTy& graph, double itemsPerNode = 1,
+                     double itemsPerEdge = 0) {
+  using Node = typename GraphTy::GraphNode;
+
+  size_t nodeItem =
+      sizeof(Node) + internal::dataSize<typename GraphTy::node_data_type>();
+  size_t edgeItem =
+      2 * sizeof(Node) + internal::dataSize<typename GraphTy::edge_data_type>();
+  if constexpr (!std::is_void<WorkItem>::value) {
+    nodeItem = edgeItem = sizeof(WorkItem);
+  }
+  return runtime::preAllocBytes(
+      size_t(graph.size() * itemsPerNode * nodeItem +
+             graph.sizeEdges() * itemsPerEdge * edgeItem));
+}
+
 /**
  * Reports number of hugepages allocated by the Galois system so far. The value
  * is printing using the statistics infrastructure.
@@ -113,15 +155,42 @@ static inline void reportPageAlloc(const char* label) {
   runtime::reportPageAlloc(label);
 }
 
+/**
+ * Reports the peak memory use of graph arrays, the page pool, worklist chunks
+ * and network buffers so far. The values are printed using the statistics
+ * infrastructure.
+ *
+ * @param label Label to associated with report at this program point
+ */
+static inline void reportMemUsage(const char* label) {
+  runtime::reportMemUsage(label);
+}
+
+/**
+ * Reports how quickly threads started working on parallel sections since the
+ * last report. The values are printed using the statistics infrastructure.
+ *
+ * @param label Label to associated with report at this program point
+ */
+static inline void reportWakeupStats(const char* label) {
+  runtime::reportWakeupStats(label);
+}
+
 /**
  * Galois ordered set iterator for stable source algorithms.
  *
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item. Comparison
  * function should conform to <code>bool r = cmp(item1, item2)</code> where r is
- * true if item1 is less than or equal to item2. Neighborhood function should
- * conform to <code>nhFunc(item)</code> and should visit every element in the
- * neighborhood of active element item.
+ * true if item1 has to run before item2 (a strict weak order). Neighborhood
+ * function should conform to <code>nhFunc(item)</code> and should visit every
+ * element in the neighborhood of active element item.
+ *
+ * The result is that of running the items one at a time in priority order,
+ * new items included. Iterations run speculatively out of order and are
+ * rolled back when an earlier one turns out to conflict with them, so the
+ * operator has to register the inverse of every change it makes with
+ * UserContext::addUndo.
  *
  * @param b begining of range of initial items
  * @param e end of range of initial items
@@ -142,11 +211,13 @@ void for_each_ordered(Iter b, Iter e, const Cmp& cmp, const NhFunc& nhFunc,
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item. Comparison
  * function should conform to <code>bool r = cmp(item1, item2)</code> where r is
- * true if item1 is less than or equal to item2. Neighborhood function should
- * conform to <code>nhFunc(item)</code> and should visit every element in the
- * neighborhood of active element item. The stability test should conform to
- * <code>bool r = stabilityTest(item)</code> where r is true if item is a stable
- * source.
+ * true if item1 has to run before item2 (a strict weak order). Neighborhood
+ * function should conform to <code>nhFunc(item)</code> and should visit every
+ * element in the neighborhood of active element item. The stability test
+ * should conform to <code>bool r = stabilityTest(item)</code> where r is true
+ * if item is a stable source, i.e., no pending or future item that comes
+ * before it can change what it does, so it may commit ahead of them. Changes
+ * of the operator have to be undoable as for the stable source version.
  *
  * @param b begining of range of initial items
  * @param e end of range of initial items
@@ -27,9 +27,16 @@
 #include "galois/Reduction.h"
 #include "galois/Traits.h"
 #include "galois/UserContext.h"
+#include "galois/substrate/NumaMem.h"
 #include "galois/Threads.h"
 #include "galois/worklists/Chunk.h"
 
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
 namespace galois {
 //! Parallel versions of STL library algorithms.
 // TODO: rename to gstl?
@@ -306,75 +313,442 @@ std::enable_if_t<!std::is_scalar<internal::Val_ty<I>>::value> destroy(I first,
 template <class I>
 std::enable_if_t<std::is_scalar<internal::Val_ty<I>>::value> destroy(I, I) {}
 
+namespace internal {
+
+//! Inputs shorter than this are handled serially
+constexpr size_t SERIAL_CUTOFF = 1 << 14;
+//! Bits of key sorted per radix sort pass
+constexpr unsigned RADIX_BITS = 8;
+constexpr size_t RADIX        = size_t{1} << RADIX_BITS;
+
+/**
+ * Number of blocks n elements are split into: a few per thread so that
+ * blocks can be stolen, but no fewer than minBlock elements each.
+ */
+inline size_t numBlocks(size_t n, size_t minBlock) {
+  size_t maxBlocks = 8 * galois::getActiveThreads();
+  return std::max<size_t>(1, std::min(maxBlocks, n / minBlock));
+}
+
+//! Elements [first, second) of block b of numBlocks over n elements
+inline std::pair<size_t, size_t> blockRange(size_t b, size_t numBlocks,
+                                            size_t n) {
+  size_t base = n / numBlocks;
+  size_t rem  = n % numBlocks;
+  size_t beg  = b * base + std::min(b, rem);
+  return std::make_pair(beg, beg + base + (b < rem));
+}
+
+//! Calls fn(b, begin, end) on every block in parallel
+template <typename F>
+void for_each_block(size_t n, size_t numBlocks, const F& fn) {
+  galois::do_all(
+      galois::iterate(size_t{0}, numBlocks),
+      [&](size_t b) {
+        auto r = blockRange(b, numBlocks, n);
+        fn(b, r.first, r.second);
+      },
+      galois::steal(), galois::no_stats());
+}
+
+//! Stand-in for the values of a radix sort of keys only
+struct NoValues {};
+
+/**
+ * LSD radix sort of keys[0, n) (and vals, if given) by the low bits bits of
+ * key(keys[i]). keysTmp and valsTmp are scratch space of n elements. Each
+ * pass counts digits per block, turns the counts into the position of every
+ * (digit, block) pair and moves each block to those positions in order, so
+ * the sort is stable. Passes where all keys have the same digit are skipped.
+ */
+template <typename T, typename V, typename KeyFn>
+void radixSort(T* keys, T* keysTmp, V* vals, V* valsTmp, size_t n,
+               const KeyFn& key, unsigned bits) {
+  constexpr bool HasValues = !std::is_same<V, NoValues>::value;
+  size_t blocks            = numBlocks(n, SERIAL_CUTOFF / 4);
+  std::vector<size_t> counts(blocks * RADIX);
+
+  T* src  = keys;
+  T* dst  = keysTmp;
+  V* vsrc = vals;
+  V* vdst = valsTmp;
+
+  for (unsigned shift = 0; shift < bits; shift += RADIX_BITS) {
+    auto digit = [&](const T& k) {
+      return (uint64_t(key(k)) >> shift) & (RADIX - 1);
+    };
+
+    for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+      size_t* c = &counts[b * RADIX];
+      std::fill(c, c + RADIX, 0);
+      for (size_t i = beg; i < end; ++i) {
+        ++c[digit(src[i])];
+      }
+    });
+
+    // positions by digit, then by block
+    size_t sum   = 0;
+    bool trivial = false;
+    for (size_t d = 0; d < RADIX; ++d) {
+      size_t start = sum;
+      for (size_t b = 0; b < blocks; ++b) {
+        size_t c              = counts[b * RADIX + d];
+        counts[b * RADIX + d] = sum;
+        sum += c;
+      }
+      trivial |= sum - start == n;
+    }
+    if (trivial) {
+      continue;
+    }
+
+    for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+      size_t* c = &counts[b * RADIX];
+      for (size_t i = beg; i < end; ++i) {
+        size_t j = c[digit(src[i])]++;
+        dst[j]   = std::move(src[i]);
+        if constexpr (HasValues) {
+          vdst[j] = std::move(vsrc[i]);
+        }
+      }
+    });
+    std::swap(src, dst);
+    std::swap(vsrc, vdst);
+  }
+
+  if (src != keys) {
+    for_each_block(n, blocks, [&](size_t, size_t beg, size_t end) {
+      std::move(src + beg, src + end, keys + beg);
+      if constexpr (HasValues) {
+        std::move(vsrc + beg, vsrc + end, vals + beg);
+      }
+    });
+  }
+}
+
+//! Number of bits needed to represent x
+inline unsigned bitWidth(uint64_t x) {
+  return x ? 64 - __builtin_clzll(x) : 0;
+}
+
+//! Scratch space of n elements for the radix sorts, interleaved over the
+//! NUMA nodes of the active threads like a LargeArray
+template <typename T>
+class ScratchArray {
+  size_t n;
+  substrate::LAptr mem;
+
+public:
+  explicit ScratchArray(size_t size)
+      : n(size), mem(substrate::largeMallocInterleaved(
+                     size * sizeof(T), galois::getActiveThreads())) {
+    if (!std::is_trivially_default_constructible<T>::value) {
+      galois::do_all(
+          galois::iterate(size_t{0}, n), [&](size_t i) { new (get() + i) T(); },
+          galois::no_stats());
+    }
+  }
+
+  ~ScratchArray() {
+    if (!std::is_trivially_destructible<T>::value) {
+      galois::do_all(
+          galois::iterate(size_t{0}, n), [&](size_t i) { get()[i].~T(); },
+          galois::no_stats());
+    }
+  }
+
+  T* get() { return static_cast<T*>(mem.get()); }
+};
+
+} // namespace internal
+
+/**
+ * Writes init, init op x0, init op x0 op x1, ... to d_first: the exclusive
+ * prefix scan of [first, last). Blocks of the input are reduced in parallel,
+ * the block sums are scanned serially and then every block is scanned from
+ * its offset, so the input is read twice and the output written once. The
+ * output may be the input. op must be associative.
+ *
+ * @returns iterator past the last element written
+ */
+template <class InputIt, class OutputIt, class T, class BinaryOp>
+OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt d_first, T init,
+                        BinaryOp op) {
+  size_t n = std::distance(first, last);
+  if (n < internal::SERIAL_CUTOFF) {
+    for (; first != last; ++first, ++d_first) {
+      T v      = *first;
+      *d_first = init;
+      init     = op(init, v);
+    }
+    return d_first;
+  }
+
+  size_t blocks = internal::numBlocks(n, internal::SERIAL_CUTOFF / 4);
+  std::vector<T> sums(blocks);
+  internal::for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+    T s = first[beg];
+    for (size_t i = beg + 1; i < end; ++i) {
+      s = op(s, first[i]);
+    }
+    sums[b] = s;
+  });
+
+  for (size_t b = 0; b < blocks; ++b) {
+    T s     = sums[b];
+    sums[b] = init;
+    init    = op(init, s);
+  }
+
+  internal::for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+    T s = sums[b];
+    for (size_t i = beg; i < end; ++i) {
+      T v        = first[i];
+      d_first[i] = s;
+      s          = op(s, v);
+    }
+  });
+  return d_first + n;
+}
+
+template <class InputIt, class OutputIt, class T>
+OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt d_first,
+                        T init) {
+  return galois::ParallelSTL::exclusive_scan(first, last, d_first, init,
+                                             std::plus<T>());
+}
+
+/**
+ * Writes x0, x0 op x1, ... to d_first: the inclusive prefix scan of
+ * [first, last). Works like exclusive_scan. The output may be the input.
+ *
+ * @returns iterator past the last element written
+ */
+template <class InputIt, class OutputIt, class BinaryOp>
+OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first,
+                        BinaryOp op) {
+  using T  = typename std::iterator_traits<InputIt>::value_type;
+  size_t n = std::distance(first, last);
+  if (n < internal::SERIAL_CUTOFF) {
+    return std::partial_sum(first, last, d_first, op);
+  }
+
+  size_t blocks = internal::numBlocks(n, internal::SERIAL_CUTOFF / 4);
+  std::vector<T> sums(blocks);
+  internal::for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+    T s = first[beg];
+    for (size_t i = beg + 1; i < end; ++i) {
+      s = op(s, first[i]);
+    }
+    sums[b] = s;
+  });
+
+  // sums[b] becomes the reduction of the blocks before b; sums[0] is unused
+  T running = sums[0];
+  for (size_t b = 1; b < blocks; ++b) {
+    T s     = sums[b];
+    sums[b] = running;
+    running = op(running, s);
+  }
+
+  internal::for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+    T s          = b == 0 ? T(first[beg]) : op(sums[b], first[beg]);
+    d_first[beg] = s;
+    for (size_t i = beg + 1; i < end; ++i) {
+      s          = op(s, first[i]);
+      d_first[i] = s;
+    }
+  });
+  return d_first + n;
+}
+
+template <class InputIt, class OutputIt>
+OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first) {
+  using T = typename std::iterator_traits<InputIt>::value_type;
+  return galois::ParallelSTL::inclusive_scan(first, last, d_first,
+                                             std::plus<T>());
+}
+
 /**
  * Does a partial sum from first -> last and writes the results to the d_first
- * iterator.
+ * iterator. Same as inclusive_scan with addition.
  */
 template <class InputIt, class OutputIt>
 OutputIt partial_sum(InputIt first, InputIt last, OutputIt d_first) {
-  using ValueType = typename std::iterator_traits<InputIt>::value_type;
-
-  size_t sizeOfVector = std::distance(first, last);
+  return galois::ParallelSTL::inclusive_scan(first, last, d_first);
+}
 
-  // only bother with parallel execution if vector is larger than some size
-  if (sizeOfVector >= 1024) {
-    const size_t numBlocks = galois::getActiveThreads();
-    const size_t blockSize = (sizeOfVector + numBlocks - 1) / numBlocks;
-    assert(numBlocks * blockSize >= sizeOfVector);
+/**
+ * Copies the elements of [first, last) for which pred is true to d_first,
+ * keeping their order (pack or filter). pred is called twice per element:
+ * once to count the elements each block keeps and once to copy them.
+ *
+ * @returns iterator past the last element written
+ */
+template <class InputIt, class OutputIt, class Predicate>
+OutputIt copy_if(InputIt first, InputIt last, OutputIt d_first,
+                 Predicate pred) {
+  size_t n = std::distance(first, last);
+  if (n < internal::SERIAL_CUTOFF) {
+    return std::copy_if(first, last, d_first, pred);
+  }
 
-    std::vector<ValueType> localSums(numBlocks);
+  size_t blocks = internal::numBlocks(n, internal::SERIAL_CUTOFF / 4);
+  std::vector<size_t> offsets(blocks);
+  internal::for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+    size_t c = 0;
+    for (size_t i = beg; i < end; ++i) {
+      c += bool(pred(first[i]));
+    }
+    offsets[b] = c;
+  });
+  size_t total = 0;
+  for (auto& o : offsets) {
+    size_t c = o;
+    o        = total;
+    total += c;
+  }
 
-    // get the block sums
-    galois::do_all(
-        galois::iterate((size_t)0, numBlocks), [&](const size_t& block) {
-          // block start can extend past sizeOfVector if doesn't divide evenly
-          size_t blockStart = std::min(block * blockSize, sizeOfVector);
-          size_t blockEnd   = std::min((block + 1) * blockSize, sizeOfVector);
-          assert(blockStart <= blockEnd);
-
-          // partial accumulation of each block done now
-          std::partial_sum(first + blockStart, first + blockEnd,
-                           d_first + blockStart);
-          // save the last number in this block: used for block prefix sum
-          if (blockEnd > 0) {
-            localSums[block] = *(d_first + blockEnd - 1);
-          } else {
-            localSums[block] = 0;
-          }
-        });
-
-    // bulkPrefix[i] holds the starting sum of a particular block i
-    std::vector<ValueType> bulkPrefix(numBlocks);
-    // exclusive scan on local sums to get number to add to each block's
-    // set of indices
-    // Not using std::exclusive_scan because apparently it doesn't work for
-    // some compilers
-    ValueType runningSum = 0;
-    for (size_t i = 0; i < numBlocks; i++) {
-      bulkPrefix[i] = runningSum;
-      runningSum += localSums[i];
+  internal::for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+    OutputIt out = d_first + offsets[b];
+    for (size_t i = beg; i < end; ++i) {
+      if (pred(first[i])) {
+        *out = first[i];
+        ++out;
+      }
     }
+  });
+  return d_first + total;
+}
 
+/**
+ * Sets counts[k] to the number of elements x of [first, last) with
+ * bin(x) == k, for k in [0, numBins). Few bins are counted in tables per
+ * block that are summed at the end; when the tables would outgrow the input,
+ * the counts are incremented atomically instead, so counts must then be
+ * integers in memory (e.g., a pointer or a LargeArray).
+ */
+template <class InputIt, class BinFn, class CountIt>
+void histogram(InputIt first, InputIt last, size_t numBins, BinFn bin,
+               CountIt counts) {
+  size_t n      = std::distance(first, last);
+  size_t blocks = internal::numBlocks(n, internal::SERIAL_CUTOFF / 4);
+
+  if (numBins * blocks <= n) {
+    std::vector<size_t> local(numBins * blocks);
+    internal::for_each_block(n, blocks, [&](size_t b, size_t beg, size_t end) {
+      size_t* c = &local[b * numBins];
+      for (size_t i = beg; i < end; ++i) {
+        ++c[bin(first[i])];
+      }
+    });
     galois::do_all(
-        galois::iterate((size_t)0, numBlocks), [&](const size_t& block) {
-          // add the sums of previous elements to blocks
-          ValueType numToAdd = bulkPrefix[block];
-          size_t blockStart  = std::min(block * blockSize, sizeOfVector);
-          size_t blockEnd    = std::min((block + 1) * blockSize, sizeOfVector);
-          assert(blockStart <= blockEnd);
-
-          // transform applies addition to appropriate range
-          std::transform(d_first + blockStart, d_first + blockEnd,
-                         d_first + blockStart,
-                         [&](ValueType& val) { return val + numToAdd; });
-        });
-
-    // return the iterator past the last element written
-    return d_first + sizeOfVector;
+        galois::iterate(size_t{0}, numBins),
+        [&](size_t k) {
+          size_t c = 0;
+          for (size_t b = 0; b < blocks; ++b) {
+            c += local[b * numBins + k];
+          }
+          counts[k] = c;
+        },
+        galois::no_stats());
   } else {
-    // vector is small; do it serially using standard library
-    return std::partial_sum(first, last, d_first);
+    galois::do_all(
+        galois::iterate(size_t{0}, numBins), [&](size_t k) { counts[k] = 0; },
+        galois::no_stats());
+    internal::for_each_block(n, blocks, [&](size_t, size_t beg, size_t end) {
+      for (size_t i = beg; i < end; ++i) {
+        __atomic_fetch_add(&counts[bin(first[i])], 1, __ATOMIC_RELAXED);
+      }
+    });
+  }
+}
+
+/**
+ * Stable LSD radix sort of [first, last) by the unsigned integer key(x),
+ * which must not exceed maxKey. Sorts 8 bits per pass, so the number of
+ * passes is the number of bytes of maxKey. Needs a scratch copy of the
+ * input, interleaved over the NUMA nodes; the iterators must point to
+ * contiguous memory.
+ */
+template <class RandomIt, class KeyFn>
+void radix_sort(RandomIt first, RandomIt last, KeyFn key, uint64_t maxKey) {
+  using T  = typename std::iterator_traits<RandomIt>::value_type;
+  size_t n = std::distance(first, last);
+  if (n < internal::SERIAL_CUTOFF) {
+    std::stable_sort(first, last, [&](const T& a, const T& b) {
+      return uint64_t(key(a)) < uint64_t(key(b));
+    });
+    return;
+  }
+  internal::ScratchArray<T> tmp(n);
+  internal::radixSort<T, internal::NoValues>(&*first, tmp.get(), nullptr,
+                                             nullptr, n, key,
+                                             internal::bitWidth(maxKey));
+}
+
+//! Radix sort of unsigned integers
+template <class RandomIt>
+void radix_sort(RandomIt first, RandomIt last) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  static_assert(std::is_unsigned<T>::value, "keys must be unsigned integers");
+  T maxKey = galois::ParallelSTL::accumulate(
+      first, last, T(0), [](const T& a, const T& b) { return std::max(a, b); });
+  galois::ParallelSTL::radix_sort(
+      first, last, [](const T& x) { return x; }, maxKey);
+}
+
+/**
+ * Stable radix sort of the unsigned integer keys [kfirst, klast) that moves
+ * the values starting at vfirst along with their keys. Both ranges must be
+ * contiguous.
+ */
+template <class KeyIt, class ValueIt>
+void radix_sort_by_key(KeyIt kfirst, KeyIt klast, ValueIt vfirst) {
+  using K  = typename std::iterator_traits<KeyIt>::value_type;
+  using V  = typename std::iterator_traits<ValueIt>::value_type;
+  size_t n = std::distance(kfirst, klast);
+  static_assert(std::is_unsigned<K>::value, "keys must be unsigned integers");
+  if (n == 0) {
+    return;
+  }
+  K maxKey = galois::ParallelSTL::accumulate(
+      kfirst, klast, K(0),
+      [](const K& a, const K& b) { return std::max(a, b); });
+  internal::ScratchArray<K> ktmp(n);
+  internal::ScratchArray<V> vtmp(n);
+  internal::radixSort(&*kfirst, ktmp.get(), &*vfirst, vtmp.get(), n,
+                      [](const K& x) { return x; },
+                      internal::bitWidth(maxKey));
+}
+
+/**
+ * Groups the elements of [first, last) by the integer key(x) < numKeys
+ * (semisort): afterwards elements with the same key are contiguous, groups
+ * are in increasing key order and each keeps the input order. Sets
+ * offsets[k] to the start of group k and offsets[numKeys] to the number of
+ * elements, like the edge index of a CSR graph.
+ */
+template <class RandomIt, class KeyFn, class OffsetIt>
+void semisort(RandomIt first, RandomIt last, size_t numKeys, KeyFn key,
+              OffsetIt offsets) {
+  size_t n = std::distance(first, last);
+  if (numKeys == 0) {
+    return;
   }
+  galois::ParallelSTL::radix_sort(first, last, key, numKeys - 1);
+
+  // each group start fills the offsets of the empty groups before it
+  galois::do_all(
+      galois::iterate(size_t{0}, n + 1),
+      [&](size_t i) {
+        size_t from = i == 0 ? 0 : size_t(key(first[i - 1])) + 1;
+        size_t to   = i == n ? numKeys : size_t(key(first[i]));
+        for (size_t k = from; k <= to; ++k) {
+          offsets[k] = i;
+        }
+      },
+      galois::no_stats());
 }
 
 } // end namespace ParallelSTL
@@ -20,10 +20,15 @@
 #ifndef GALOIS_REDUCTION_H
 #define GALOIS_REDUCTION_H
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <limits>
+#include <tuple>
+#include <vector>
 
 #include "galois/config.h"
+#include "galois/runtime/Executor_OnEach.h"
 #include "galois/substrate/PerThreadStorage.h"
 
 namespace galois {
@@ -224,5 +229,241 @@ public:
       : base_type(std::logical_or<bool>(), identity_value<bool, false>()) {}
 };
 
+/**
+ * An ArrayReducible stores per-thread arrays of numBins values of type T and
+ * merges them bin by bin into one array, e.g., a histogram or per-community
+ * weights. Threads update their own arrays without synchronization instead of
+ * updating shared atomics.
+ *
+ * A thread's array starts as a small open-addressing table of the bins it
+ * touched and becomes a dense array of all bins once it holds more than
+ * numBins / 16 bins; small arrays are dense from the start.
+ *
+ * reduce merges the arrays of all threads in a tree of log2(threads) rounds.
+ * Within a round, merges into dense arrays are split into ranges of bins that
+ * are merged by all threads in parallel.
+ *
+ * MergeFunc and IdFunc are as for Reducible, except that MergeFunc must be of
+ * the form T operator()(T lhs, T rhs).
+ */
+template <typename T, typename MergeFunc, typename IdFunc>
+class ArrayReducible : public MergeFunc, public IdFunc {
+  static constexpr size_t EMPTY = ~size_t{0};
+  //! Bins per parallel task when merging dense arrays
+  static constexpr size_t MERGE_CHUNK = 1 << 14;
+
+  struct Local {
+    //! bin of every slot of the sparse table or EMPTY
+    std::vector<size_t> keys;
+    //! values of the slots of the sparse table or of all bins when dense
+    std::vector<T> vals;
+    size_t used = 0;
+    bool dense  = false;
+
+    bool empty() const { return !dense && used == 0; }
+  };
+
+  //! Merge of src into dst; src is sparse or the bins [begin, end) of src
+  struct Task {
+    Local* dst;
+    Local* src;
+    size_t begin;
+    size_t end;
+  };
+
+  size_t numBins;
+  size_t sparseLimit;
+  unsigned logCapacity;
+  galois::substrate::PerThreadStorage<Local> data_;
+
+  void merge(T& lhs, const T& rhs) { lhs = MergeFunc::operator()(lhs, rhs); }
+
+  size_t slot(size_t bin) const {
+    return (uint64_t(bin) * 0x9E3779B97F4A7C15ULL) >> (64 - logCapacity);
+  }
+
+  void densify(Local& l) {
+    std::vector<T> all(numBins, IdFunc::operator()());
+    for (size_t s = 0; s < l.keys.size(); ++s) {
+      if (l.keys[s] != EMPTY) {
+        all[l.keys[s]] = l.vals[s];
+      }
+    }
+    l.vals.swap(all);
+    std::vector<size_t>().swap(l.keys);
+    l.used  = 0;
+    l.dense = true;
+  }
+
+  void updateSparse(Local& l, size_t bin, const T& value) {
+    if (l.keys.empty()) {
+      if (!sparseLimit) {
+        densify(l);
+        merge(l.vals[bin], value);
+        return;
+      }
+      l.keys.assign(size_t{1} << logCapacity, EMPTY);
+      l.vals.resize(size_t{1} << logCapacity);
+    }
+    size_t mask = l.keys.size() - 1;
+    for (size_t s = slot(bin);; s = (s + 1) & mask) {
+      if (l.keys[s] == bin) {
+        merge(l.vals[s], value);
+        return;
+      }
+      if (l.keys[s] == EMPTY) {
+        if (l.used == sparseLimit) {
+          densify(l);
+          merge(l.vals[bin], value);
+          return;
+        }
+        l.keys[s] = bin;
+        l.vals[s] = MergeFunc::operator()(IdFunc::operator()(), value);
+        ++l.used;
+        return;
+      }
+    }
+  }
+
+  void clearLocal(Local& l, size_t begin, size_t end) {
+    if (l.dense) {
+      std::fill(l.vals.begin() + begin, l.vals.begin() + end,
+                IdFunc::operator()());
+    } else if (l.used) {
+      std::fill(l.keys.begin(), l.keys.end(), EMPTY);
+      l.used = 0;
+    }
+  }
+
+  void run(const Task& t) {
+    if (!t.src->dense) {
+      for (size_t s = 0; s < t.src->keys.size(); ++s) {
+        if (t.src->keys[s] != EMPTY) {
+          mergeInto(*t.dst, t.src->keys[s], t.src->vals[s]);
+        }
+      }
+      clearLocal(*t.src, 0, 0);
+      return;
+    }
+    T* d       = t.dst->vals.data();
+    const T* s = t.src->vals.data();
+    for (size_t i = t.begin; i < t.end; ++i) {
+      d[i] = MergeFunc::operator()(d[i], s[i]);
+    }
+    clearLocal(*t.src, t.begin, t.end);
+  }
+
+  void mergeInto(Local& l, size_t bin, const T& value) {
+    if (l.dense) {
+      merge(l.vals[bin], value);
+    } else {
+      updateSparse(l, bin, value);
+    }
+  }
+
+  //! Calls fn(i) for i in [0, n) on all threads
+  template <typename F>
+  static void parallelFor(size_t n, const F& fn) {
+    galois::runtime::on_each_gen(
+        [&](unsigned tid, unsigned numThreads) {
+          for (size_t i = tid; i < n; i += numThreads) {
+            fn(i);
+          }
+        },
+        std::make_tuple(galois::no_stats()));
+  }
+
+public:
+  using value_type = T;
+
+  ArrayReducible(size_t numBins, MergeFunc merge_func, IdFunc id_func)
+      : MergeFunc(merge_func), IdFunc(id_func), numBins(numBins),
+        sparseLimit(numBins / 16 < 64 ? 0 : numBins / 16), logCapacity(0) {
+    while ((size_t{1} << logCapacity) < 2 * sparseLimit) {
+      ++logCapacity;
+    }
+  }
+
+  //! Number of bins
+  size_t size() const { return numBins; }
+
+  /**
+   * Updates bin of the thread local array by applying the reduction operator
+   * to the current and newly provided value
+   */
+  void update(size_t bin, const T& value) {
+    mergeInto(*data_.getLocal(), bin, value);
+  }
+
+  /**
+   * Returns the final reduction values of all bins. Only valid outside the
+   * parallel region. The values of the other threads are reset.
+   */
+  std::vector<T>& reduce() {
+    std::vector<Task> tasks;
+    for (size_t stride = 1; stride < data_.size(); stride *= 2) {
+      tasks.clear();
+      for (size_t i = 0; i + stride < data_.size(); i += 2 * stride) {
+        Local* dst = data_.getRemote(i);
+        Local* src = data_.getRemote(i + stride);
+        if (!src->empty()) {
+          tasks.push_back(Task{dst, src, 0, 0});
+        }
+      }
+      // targets of dense arrays become dense before the arrays are split
+      parallelFor(tasks.size(), [&](size_t i) {
+        if (tasks[i].src->dense && !tasks[i].dst->dense) {
+          densify(*tasks[i].dst);
+        }
+      });
+      size_t numPairs = tasks.size();
+      for (size_t i = 0; i < numPairs; ++i) {
+        if (!tasks[i].src->dense) {
+          continue;
+        }
+        tasks[i].end = std::min(numBins, MERGE_CHUNK);
+        for (size_t b = MERGE_CHUNK; b < numBins; b += MERGE_CHUNK) {
+          tasks.push_back(Task{tasks[i].dst, tasks[i].src, b,
+                               std::min(numBins, b + MERGE_CHUNK)});
+        }
+      }
+      parallelFor(tasks.size(), [&](size_t i) { run(tasks[i]); });
+    }
+
+    Local& result = *data_.getRemote(0);
+    if (!result.dense) {
+      densify(result);
+    }
+    return result.vals;
+  }
+
+  //! Resets all bins of all threads to the identity
+  void reset() {
+    parallelFor(data_.size(), [&](size_t i) {
+      clearLocal(*data_.getRemote(i), 0, numBins);
+    });
+  }
+};
+
+//! Array accumulator for T where accumulation is plus
+template <typename T>
+class GArrayAccumulator
+    : public ArrayReducible<T, std::plus<T>, identity_value_zero<T>> {
+  using base_type = ArrayReducible<T, std::plus<T>, identity_value_zero<T>>;
+
+public:
+  explicit GArrayAccumulator(size_t numBins)
+      : base_type(numBins, std::plus<T>(), identity_value_zero<T>()) {}
+};
+
+//! Histogram that counts how often every bin occurs
+class GHistogram : public GArrayAccumulator<uint64_t> {
+public:
+  explicit GHistogram(size_t numBins) : GArrayAccumulator(numBins) {}
+
+  //! Counts one occurrence of bin
+  void count(size_t bin) { update(bin, 1); }
+};
+
 } // namespace galois
 #endif // GALOIS_REDUCTION_H
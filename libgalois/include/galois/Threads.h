@@ -20,6 +20,9 @@
 #ifndef GALOIS_THREADS_H
 #define GALOIS_THREADS_H
 
+#include <functional>
+#include <vector>
+
 #include "galois/config.h"
 
 namespace galois {
@@ -37,5 +40,25 @@ unsigned int setActiveThreads(unsigned int num) noexcept;
  */
 unsigned int getActiveThreads() noexcept;
 
+/**
+ * Splits the active threads into sub-pools of the given sizes and calls
+ * fn(pool, numPools) on the first thread of every sub-pool at the same time.
+ * Galois loops started from fn only run on the threads of its sub-pool, with
+ * their own worklists, barrier and termination detection, so the loops of
+ * different sub-pools run concurrently. Inside fn, getActiveThreads() is the
+ * size of the sub-pool and thread ids start at 0. Per-thread data (e.g.,
+ * reducers) created outside of fn and used inside only covers the threads
+ * of the sub-pool when read from the sub-pool. Returns when every fn
+ * returned.
+ */
+void on_each_subpool(const std::vector<unsigned>& sizes,
+                     const std::function<void(unsigned, unsigned)>& fn);
+
+/**
+ * Returns the sizes of sub-pools that group the active threads by socket,
+ * for on_each_subpool.
+ */
+std::vector<unsigned> socketSubpoolSizes();
+
 } // namespace galois
 #endif
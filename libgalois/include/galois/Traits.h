@@ -277,6 +277,18 @@ struct fixed_neighborhood : public trait_has_type<bool>,
 struct intent_to_read_tag {};
 struct intent_to_read : public trait_has_type<bool>, intent_to_read_tag {};
 
+/**
+ * Runs a deterministic {@link galois::for_each} in performance mode. The
+ * window of iterations per round keeps adapting to the commit rate over the
+ * whole loop instead of starting small again with new work, and the
+ * neighborhood of an iteration is marked with a single compare-and-swap per
+ * element instead of taking its lock first. Results are deterministic but may
+ * differ from those of the default deterministic mode, which forms rounds
+ * differently.
+ */
+struct det_fast_tag {};
+struct det_fast : public trait_has_type<bool>, det_fast_tag {};
+
 /**
  * Indicates the operator has a function that visits the neighborhood of the
  * operator without modifying it.
@@ -366,6 +378,18 @@ public:
   chunk_size(unsigned cs = SZ) : trait_has_value(clamp(cs)) {}
 };
 
+/**
+ * Lets {@link do_all()} loops with {@link steal} tune the chunk size of each
+ * thread while running, starting from the {@link chunk_size} given. Chunks
+ * grow when they finish quickly and shrink when they take long or when
+ * other threads steal. The average chunk size is reported as the ChunkSize
+ * stat of the loop. For {@link for_each()}, use the Adaptive worklists in
+ * worklists/Chunk.h.
+ */
+struct adaptive_chunk_size_tag {};
+struct adaptive_chunk_size : public trait_has_type<bool>,
+                             adaptive_chunk_size_tag {};
+
 typedef worklists::PerSocketChunkFIFO<chunk_size<>::value> defaultWL;
 
 namespace internal {
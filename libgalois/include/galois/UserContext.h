@@ -21,6 +21,7 @@
 #define GALOIS_USERCONTEXT_H
 
 #include <functional>
+#include <vector>
 
 #include "galois/config.h"
 #include "galois/gdeque.h"
@@ -40,6 +41,7 @@ protected:
   typedef gdeque<T> PushBufferTy;
   static const unsigned int fastPushBackLimit = 64;
   typedef std::function<void(PushBufferTy&)> FastPushBack;
+  typedef std::vector<std::function<void()>> UndoLogTy;
 
   PushBufferTy pushBuffer;
   //! Allocator stuff
@@ -54,6 +56,10 @@ protected:
   bool firstPassFlag = false;
   void* localState   = nullptr;
 
+  //! used by ordered
+  UndoLogTy undoLog;
+  bool logUndo = false;
+
   void __resetAlloc() { IterationAllocatorBase.clear(); }
 
   void __setFirstPass(void) { firstPassFlag = true; }
@@ -68,6 +74,10 @@ protected:
 
   void __setFastPushBack(FastPushBack f) { fastPushBack = f; }
 
+  UndoLogTy& __getUndoLog() { return undoLog; }
+
+  void __setLogUndo(bool b) { logUndo = b; }
+
 public:
   UserContext()
       : IterationAllocatorBase(),
@@ -101,6 +111,18 @@ public:
     this->push(std::forward<Args>(args)...);
   }
 
+  /**
+   * Registers f as the inverse of a change the iteration just made. When an
+   * executor that speculates past the commit order (galois::for_each_ordered)
+   * rolls the iteration back, it calls the functions registered by it in
+   * reverse order. Other executors never roll back and drop them.
+   */
+  template <typename F>
+  void addUndo(F&& f) {
+    if (logUndo)
+      undoLog.emplace_back(std::forward<F>(f));
+  }
+
   //! Force the abort of this iteration
   void abort() { galois::runtime::signalConflict(); }
 
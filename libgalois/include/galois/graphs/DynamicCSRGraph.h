@@ -0,0 +1,602 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_DYNAMIC_CSR_GRAPH_H
+#define GALOIS_GRAPHS_DYNAMIC_CSR_GRAPH_H
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/runtime/Mem.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+namespace graphs {
+
+namespace internal {
+
+//! One edge stored in a DynamicCSRGraph
+template <typename GraphNode, typename EdgeTy>
+struct DynamicEdgeSlot {
+  GraphNode dst;
+  EdgeTy data;
+};
+
+template <typename GraphNode>
+struct DynamicEdgeSlot<GraphNode, void> {
+  GraphNode dst;
+};
+
+//! One edge insertion or deletion; data is ignored by deletions
+template <typename GraphNode, typename EdgeTy>
+struct DynamicEdgeUpdate {
+  GraphNode src;
+  GraphNode dst;
+  EdgeTy data;
+};
+
+template <typename GraphNode>
+struct DynamicEdgeUpdate<GraphNode, void> {
+  GraphNode src;
+  GraphNode dst;
+};
+
+} // namespace internal
+
+/**
+ * Local computation graph whose edge set can be updated in batches.
+ *
+ * Edges live in a CSR array in which every node owns a contiguous segment of
+ * slots, possibly with slack at its end. Insertions that do not fit in the
+ * slack of a node go to a per-node overflow block taken from the
+ * power-of-2 block heap, so a batch never moves the edges of other nodes.
+ * Deletions swap the removed edge with the last live edge of its segment.
+ * Iterating the edges of a node walks its CSR segment and then its overflow
+ * block; as long as most edges are in the CSR array, do_all kernels see the
+ * same access pattern as on LC_CSR_Graph. compact() periodically rebuilds the
+ * CSR array so that all edges are stored inline again.
+ *
+ * Node and edge data are not protected by locks; updates must not run
+ * concurrently with other operations on the graph, and they invalidate edge
+ * iterators.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ * @tparam UseNumaAlloc if true, use NUMA-aware allocation and the node ranges
+ * used when reading the graph as local ranges
+ */
+template <typename NodeTy, typename EdgeTy, bool UseNumaAlloc = false>
+class DynamicCSRGraph : private boost::noncopyable,
+                        public internal::LocalIteratorFeature<UseNumaAlloc> {
+public:
+  template <bool _use_numa_alloc>
+  struct with_numa_alloc {
+    typedef DynamicCSRGraph<NodeTy, EdgeTy, _use_numa_alloc> type;
+  };
+
+  template <typename _node_data>
+  struct with_node_data {
+    typedef DynamicCSRGraph<_node_data, EdgeTy, UseNumaAlloc> type;
+  };
+
+  template <typename _edge_data>
+  struct with_edge_data {
+    typedef DynamicCSRGraph<NodeTy, _edge_data, UseNumaAlloc> type;
+  };
+
+  typedef read_default_graph_tag read_tag;
+
+  typedef uint32_t GraphNode;
+  typedef EdgeTy edge_data_type;
+  typedef EdgeTy file_edge_data_type;
+  typedef NodeTy node_data_type;
+  typedef typename LargeArray<NodeTy>::reference node_data_reference;
+  typedef internal::DynamicEdgeSlot<GraphNode, EdgeTy> EdgeSlot;
+  typedef internal::DynamicEdgeUpdate<GraphNode, EdgeTy> EdgeUpdate;
+  typedef boost::counting_iterator<GraphNode> iterator;
+  typedef iterator const_iterator;
+  typedef iterator local_iterator;
+  typedef iterator const_local_iterator;
+
+  //! Forward iterator over the CSR segment and then the overflow block
+  class edge_iterator
+      : public boost::iterator_facade<edge_iterator, EdgeSlot,
+                                      std::forward_iterator_tag, EdgeSlot&> {
+    friend class boost::iterator_core_access;
+    friend class DynamicCSRGraph;
+
+    EdgeSlot* cur;
+    EdgeSlot* segEnd;
+    EdgeSlot* next;
+
+    edge_iterator(EdgeSlot* c, EdgeSlot* s, EdgeSlot* n)
+        : cur(c), segEnd(s), next(n) {}
+
+    void increment() {
+      if (++cur == segEnd) {
+        cur = next;
+      }
+    }
+    bool equal(const edge_iterator& o) const { return cur == o.cur; }
+    EdgeSlot& dereference() const { return *cur; }
+
+  public:
+    edge_iterator() : cur(nullptr), segEnd(nullptr), next(nullptr) {}
+  };
+
+private:
+  //! Where the edges of a node are stored
+  struct NodeEdges {
+    uint64_t begin;    //!< first CSR slot of the node
+    uint32_t size;     //!< live edges in the CSR segment
+    uint32_t capacity; //!< CSR slots owned by the node
+    uint32_t ovfSize;  //!< live edges in the overflow block
+    uint32_t ovfCap;   //!< size of the overflow block
+    EdgeSlot* ovf;     //!< overflow block or nullptr
+  };
+
+  typedef LargeArray<NodeTy> NodeData;
+  typedef LargeArray<NodeEdges> EdgeIndData;
+  typedef LargeArray<EdgeSlot> EdgeSlots;
+
+  NodeData nodeData;
+  EdgeIndData edgeIndData;
+  EdgeSlots slots;
+
+  uint64_t numNodes = 0;
+  uint64_t numEdges = 0;
+
+  runtime::Pow_2_BlockAllocator<EdgeSlot> ovfAlloc;
+  //! per-thread flags used to mark updates already applied to a node
+  substrate::PerThreadStorage<std::vector<char>> scratch;
+
+  static bool compareUpdate(const EdgeUpdate& a, const EdgeUpdate& b) {
+    return a.src < b.src || (a.src == b.src && a.dst < b.dst);
+  }
+
+  static void setData(EdgeSlot& s, const EdgeUpdate& u) {
+    if constexpr (!std::is_void<EdgeTy>::value) {
+      s.data = u.data;
+    }
+  }
+
+  edge_iterator makeEdgeIterator(GraphNode n, bool atEnd) {
+    NodeEdges& ne = edgeIndData[n];
+    // an empty CSR segment is skipped altogether so that its end can never
+    // alias a pointer into the overflow block
+    EdgeSlot* segBegin = ne.size ? slots.data() + ne.begin : nullptr;
+    EdgeSlot* segEnd   = segBegin ? segBegin + ne.size : nullptr;
+    EdgeSlot* next     = ne.ovfSize ? ne.ovf : segEnd;
+    if (atEnd) {
+      return edge_iterator(ne.ovfSize ? ne.ovf + ne.ovfSize : segEnd, segEnd,
+                           next);
+    }
+    return edge_iterator(segBegin ? segBegin : next, segEnd, next);
+  }
+
+  void freeOverflow(NodeEdges& ne) {
+    if (ne.ovf) {
+      ovfAlloc.deallocate(ne.ovf, ne.ovfCap);
+    }
+    ne.ovf     = nullptr;
+    ne.ovfSize = 0;
+    ne.ovfCap  = 0;
+  }
+
+  //! Appends an edge to the slack of a node or to its overflow block
+  void appendEdge(NodeEdges& ne, const EdgeUpdate& u) {
+    EdgeSlot* slot;
+    if (ne.size < ne.capacity) {
+      slot = &slots[ne.begin + ne.size++];
+    } else {
+      if (ne.ovfSize == ne.ovfCap) {
+        uint32_t newCap = std::max<uint32_t>(4, ne.ovfCap * 2);
+        EdgeSlot* block = ovfAlloc.allocate(newCap);
+        std::copy(ne.ovf, ne.ovf + ne.ovfSize, block);
+        if (ne.ovf) {
+          ovfAlloc.deallocate(ne.ovf, ne.ovfCap);
+        }
+        ne.ovf    = block;
+        ne.ovfCap = newCap;
+      }
+      slot = &ne.ovf[ne.ovfSize++];
+    }
+    slot->dst = u.dst;
+    setData(*slot, u);
+  }
+
+  //! Removes every edge of a segment whose destination is in [b, e)
+  template <typename It>
+  static uint64_t removeFromSegment(EdgeSlot* seg, uint32_t& size, It b,
+                                    It e) {
+    uint64_t removed = 0;
+    for (uint32_t i = 0; i < size;) {
+      if (findUpdate(b, e, seg[i].dst) != e) {
+        seg[i] = seg[--size];
+        ++removed;
+      } else {
+        ++i;
+      }
+    }
+    return removed;
+  }
+
+  template <typename It>
+  static It findUpdate(It b, It e, GraphNode dst) {
+    It ii = std::lower_bound(
+        b, e, dst, [](const EdgeUpdate& u, GraphNode d) { return u.dst < d; });
+    return (ii != e && ii->dst == dst) ? ii : e;
+  }
+
+  /**
+   * Sorts a batch by source and calls fn(node, begin, end) in parallel for
+   * every source, where [begin, end) are the updates of that source sorted
+   * by destination.
+   */
+  template <typename Fn>
+  void forEachSource(std::vector<EdgeUpdate>& batch, const char* loopname,
+                     const Fn& fn) {
+    galois::ParallelSTL::sort(batch.begin(), batch.end(), compareUpdate);
+    const size_t size = batch.size();
+    galois::do_all(
+        galois::iterate(size_t{0}, size),
+        [&](size_t i) {
+          if (i != 0 && batch[i - 1].src == batch[i].src) {
+            return;
+          }
+          size_t end = i + 1;
+          while (end < size && batch[end].src == batch[i].src) {
+            ++end;
+          }
+          if (batch[i].src >= numNodes) {
+            GALOIS_DIE("edge update source ", batch[i].src, " out of range");
+          }
+          // the updates of a source are sorted by destination
+          if (batch[end - 1].dst >= numNodes) {
+            GALOIS_DIE("edge update ", batch[i].src, " -> ", batch[end - 1].dst,
+                       " out of range");
+          }
+          fn(batch[i].src, batch.begin() + i, batch.begin() + end);
+        },
+        galois::steal(), galois::no_stats(), galois::loopname(loopname));
+  }
+
+public:
+  DynamicCSRGraph() = default;
+
+  //! Creates a graph with numNodes nodes and no edges
+  explicit DynamicCSRGraph(uint64_t nNodes) {
+    allocateFrom(nNodes, 0);
+    constructNodes();
+  }
+
+  ~DynamicCSRGraph() {
+    if (edgeIndData.size()) {
+      galois::do_all(
+          galois::iterate(size_t{0}, edgeIndData.size()),
+          [&](size_t n) { freeOverflow(edgeIndData[n]); }, galois::no_stats());
+    }
+  }
+
+  node_data_reference getData(GraphNode N,
+                              MethodFlag GALOIS_UNUSED(mflag) =
+                                  MethodFlag::UNPROTECTED) {
+    return nodeData[N];
+  }
+
+  template <typename E                                            = EdgeTy,
+            std::enable_if_t<!std::is_void<E>::value, int>* = nullptr>
+  E& getEdgeData(edge_iterator ni, MethodFlag GALOIS_UNUSED(mflag) =
+                                       MethodFlag::UNPROTECTED) {
+    return ni->data;
+  }
+
+  GraphNode getEdgeDst(edge_iterator ni) { return ni->dst; }
+
+  size_t size() const { return numNodes; }
+  size_t sizeEdges() const { return numEdges; }
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(numNodes); }
+
+  const_local_iterator local_begin() const {
+    return const_local_iterator(this->localBegin(numNodes));
+  }
+  const_local_iterator local_end() const {
+    return const_local_iterator(this->localEnd(numNodes));
+  }
+  local_iterator local_begin() {
+    return local_iterator(this->localBegin(numNodes));
+  }
+  local_iterator local_end() { return local_iterator(this->localEnd(numNodes)); }
+
+  edge_iterator edge_begin(GraphNode N, MethodFlag GALOIS_UNUSED(mflag) =
+                                            MethodFlag::UNPROTECTED) {
+    return makeEdgeIterator(N, false);
+  }
+
+  edge_iterator edge_end(GraphNode N, MethodFlag GALOIS_UNUSED(mflag) =
+                                          MethodFlag::UNPROTECTED) {
+    return makeEdgeIterator(N, true);
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  edges(GraphNode N, MethodFlag mflag = MethodFlag::UNPROTECTED) {
+    return internal::make_no_deref_range(edge_begin(N, mflag),
+                                         edge_end(N, mflag));
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  out_edges(GraphNode N, MethodFlag mflag = MethodFlag::UNPROTECTED) {
+    return edges(N, mflag);
+  }
+
+  //! Number of out edges of a node
+  size_t getDegree(GraphNode N) const {
+    const NodeEdges& ne = edgeIndData[N];
+    return size_t{ne.size} + ne.ovfSize;
+  }
+
+  //! Returns an edge from N to dst, or edge_end(N) if there is none
+  edge_iterator findEdge(GraphNode N, GraphNode dst) {
+    for (auto ii = edge_begin(N), ei = edge_end(N); ii != ei; ++ii) {
+      if (ii->dst == dst) {
+        return ii;
+      }
+    }
+    return edge_end(N);
+  }
+
+  //! Number of edges that are stored in overflow blocks
+  uint64_t sizeOverflowEdges() {
+    galois::GAccumulator<uint64_t> ovf;
+    galois::do_all(
+        galois::iterate(size_t{0}, size_t(numNodes)),
+        [&](size_t n) { ovf += edgeIndData[n].ovfSize; }, galois::no_stats());
+    return ovf.reduce();
+  }
+
+  /**
+   * Inserts a batch of edges in parallel. The batch is reordered.
+   *
+   * If checkExisting is true, an update whose edge already exists overwrites
+   * the data of the existing edge(s) instead of adding a parallel edge, and
+   * updates of the same edge within the batch are inserted once with the
+   * data of one of them. With checkExisting false, every update becomes a new
+   * edge.
+   *
+   * @returns number of edges added to the graph
+   */
+  uint64_t insertEdges(std::vector<EdgeUpdate>& batch,
+                       bool checkExisting = true) {
+    galois::GAccumulator<uint64_t> added;
+
+    forEachSource(batch, "DynamicGraphInsert", [&](GraphNode n, auto b,
+                                                   auto e) {
+      NodeEdges& ne = edgeIndData[n];
+      if (!checkExisting) {
+        for (auto ii = b; ii != e; ++ii) {
+          appendEdge(ne, *ii);
+        }
+        added += e - b;
+        return;
+      }
+
+      std::vector<char>& applied = *scratch.getLocal();
+      applied.assign(e - b, 0);
+      // updates of the same destination: all but the last one are skipped
+      for (auto ii = b; ii + 1 < e; ++ii) {
+        if (ii->dst == (ii + 1)->dst) {
+          applied[ii - b] = 1;
+        }
+      }
+      for (auto ei = edge_begin(n), ee = edge_end(n); ei != ee; ++ei) {
+        auto ii = findUpdate(b, e, ei->dst);
+        if (ii != e) {
+          // findUpdate returns the first of a run of equal destinations
+          while (ii + 1 < e && (ii + 1)->dst == ii->dst) {
+            ++ii;
+          }
+          setData(*ei, *ii);
+          applied[ii - b] = 1;
+        }
+      }
+
+      uint64_t count = 0;
+      for (auto ii = b; ii != e; ++ii) {
+        if (!applied[ii - b]) {
+          appendEdge(ne, *ii);
+          ++count;
+        }
+      }
+      added += count;
+    });
+
+    uint64_t total = added.reduce();
+    numEdges += total;
+    return total;
+  }
+
+  /**
+   * Deletes a batch of edges in parallel. Every edge from src to dst is
+   * removed, including parallel edges; updates of missing edges are ignored.
+   * The batch is reordered.
+   *
+   * @returns number of edges removed from the graph
+   */
+  uint64_t deleteEdges(std::vector<EdgeUpdate>& batch) {
+    galois::GAccumulator<uint64_t> removed;
+
+    forEachSource(batch, "DynamicGraphDelete",
+                  [&](GraphNode n, auto b, auto e) {
+                    NodeEdges& ne = edgeIndData[n];
+                    uint64_t count =
+                        removeFromSegment(slots.data() + ne.begin, ne.size, b, e);
+                    if (ne.ovfSize) {
+                      count += removeFromSegment(ne.ovf, ne.ovfSize, b, e);
+                      if (ne.ovfSize == 0) {
+                        freeOverflow(ne);
+                      }
+                    }
+                    removed += count;
+                  });
+
+    uint64_t total = removed.reduce();
+    numEdges -= total;
+    return total;
+  }
+
+  /**
+   * Rebuilds the CSR array so that every node stores its edges inline and
+   * releases all overflow blocks. Each node gets slack * degree extra slots
+   * for future insertions.
+   */
+  void compact(double slack = 0.0) {
+    LargeArray<uint64_t> offsets;
+    offsets.allocateBlocked(numNodes);
+    galois::do_all(
+        galois::iterate(size_t{0}, size_t(numNodes)),
+        [&](size_t n) {
+          uint64_t degree = getDegree(n);
+          offsets[n]      = degree + uint64_t(degree * slack);
+        },
+        galois::no_stats());
+    galois::ParallelSTL::partial_sum(offsets.begin(), offsets.end(),
+                                     offsets.begin());
+
+    uint64_t numSlots = numNodes ? offsets[numNodes - 1] : 0;
+    EdgeSlots newSlots;
+    if (UseNumaAlloc) {
+      newSlots.allocateBlocked(numSlots);
+    } else {
+      newSlots.allocateInterleaved(numSlots);
+    }
+
+    galois::do_all(
+        galois::iterate(size_t{0}, size_t(numNodes)),
+        [&](size_t n) {
+          NodeEdges& ne  = edgeIndData[n];
+          uint64_t begin = n ? offsets[n - 1] : 0;
+          EdgeSlot* out  = newSlots.data() + begin;
+          EdgeSlot* seg  = slots.data() + ne.begin;
+          out            = std::copy(seg, seg + ne.size, out);
+          std::copy(ne.ovf, ne.ovf + ne.ovfSize, out);
+
+          uint32_t degree = ne.size + ne.ovfSize;
+          freeOverflow(ne);
+          ne.begin    = begin;
+          ne.size     = degree;
+          ne.capacity = offsets[n] - begin;
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("DynamicGraphCompact"));
+
+    slots = std::move(newSlots);
+  }
+
+  /**
+   * Compacts the graph if more than maxOverflowRatio of its edges are in
+   * overflow blocks.
+   *
+   * @returns true if the graph was compacted
+   */
+  bool compactIfNeeded(double maxOverflowRatio, double slack = 0.0) {
+    if (numEdges == 0 ||
+        sizeOverflowEdges() <= uint64_t(maxOverflowRatio * numEdges)) {
+      return false;
+    }
+    compact(slack);
+    return true;
+  }
+
+  void allocateFrom(const FileGraph& graph) {
+    allocateFrom(graph.size(), graph.sizeEdges());
+  }
+
+  void allocateFrom(uint64_t nNodes, uint64_t nEdges) {
+    numNodes = nNodes;
+    numEdges = nEdges;
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      edgeIndData.allocateBlocked(numNodes);
+      slots.allocateBlocked(numEdges);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeIndData.allocateInterleaved(numNodes);
+      slots.allocateInterleaved(numEdges);
+    }
+  }
+
+  //! Constructs node data and empty edge lists for all nodes
+  void constructNodes() {
+    galois::do_all(
+        galois::iterate(size_t{0}, size_t(numNodes)),
+        [&](size_t n) {
+          nodeData.constructAt(n);
+          edgeIndData[n] = NodeEdges{0, 0, 0, 0, 0, nullptr};
+        },
+        galois::no_stats());
+  }
+
+  void constructFrom(FileGraph& graph, unsigned tid, unsigned total,
+                     const bool readUnweighted = false) {
+    auto r = graph
+                 .divideByNode(sizeof(NodeTy) + sizeof(NodeEdges),
+                               sizeof(EdgeSlot), tid, total)
+                 .first;
+
+    this->setLocalRange(*r.first, *r.second);
+
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      nodeData.constructAt(*ii);
+      uint64_t begin   = *graph.edge_begin(*ii);
+      uint32_t degree  = *graph.edge_end(*ii) - begin;
+      edgeIndData[*ii] = NodeEdges{begin, degree, degree, 0, 0, nullptr};
+
+      for (FileGraph::edge_iterator nn = graph.edge_begin(*ii),
+                                    en = graph.edge_end(*ii);
+           nn != en; ++nn) {
+        slots[*nn].dst = graph.getEdgeDst(nn);
+        if constexpr (!std::is_void<EdgeTy>::value) {
+          slots[*nn].data = readUnweighted
+                                ? EdgeTy{}
+                                : graph.getEdgeData<file_edge_data_type>(nn);
+        } else {
+          (void)readUnweighted;
+        }
+      }
+    }
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
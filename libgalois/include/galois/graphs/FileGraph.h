@@ -715,6 +715,20 @@ public:
   //! Marks the transition to next phase of parsing, adding edges
   void phase2();
 
+  //! Edge index to fill in directly after phase1 instead of counting degrees
+  //! and calling phase2: entry n is the end of the edges of node n
+  uint64_t* edgeEndArray() { return outIdx; }
+
+  //! Edge destinations to fill in directly after phase1: uint32_t if there
+  //! are at most 2^32 - 1 nodes (version 1), uint64_t otherwise (version 2)
+  void* edgeDstArray() { return outs; }
+
+  //! Edge data to fill in directly after phase1
+  template <typename T>
+  T* edgeDataArray() {
+    return reinterpret_cast<T*>(edgeData);
+  }
+
   //! Adds a neighbor between src and dst
   size_t addNeighbor(size_t src, size_t dst) {
     size_t base = src ? outIdx[src - 1] : 0;
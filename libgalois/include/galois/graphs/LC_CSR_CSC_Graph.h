@@ -157,9 +157,8 @@ protected:
                    });
 
     // prefix sum calculation of the edge index array
-    for (uint32_t n = 1; n < BaseGraph::numNodes; ++n) {
-      dataBuffer[n] += dataBuffer[n - 1];
-    }
+    galois::ParallelSTL::inclusive_scan(dataBuffer.begin(), dataBuffer.end(),
+                                        dataBuffer.begin());
 
     // copy over the new tranposed edge index data
     inEdgeIndData.allocateInterleaved(BaseGraph::numNodes);
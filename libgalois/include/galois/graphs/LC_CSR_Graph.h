@@ -21,6 +21,7 @@
 #define GALOIS_GRAPHS_LC_CSR_GRAPH_H
 
 #include <fstream>
+#include <memory>
 #include <type_traits>
 
 #include <boost/archive/binary_oarchive.hpp>
@@ -34,7 +35,9 @@
 #include "galois/graphs/Details.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/graphs/GraphHelpers.h"
+#include "galois/graphs/MappedGraphFile.h"
 #include "galois/PODResizeableArray.h"
+#include "galois/ParallelSTL.h"
 
 namespace galois::graphs {
 /**
@@ -157,6 +160,8 @@ public:
   typedef iterator const_local_iterator;
 
 protected:
+  //! File whose arrays the graph uses in place; see mapGraphFromGRFile
+  std::unique_ptr<MappedGraphFile> mappedFile;
   NodeData nodeData;
   EdgeIndData edgeIndData;
   EdgeDst edgeDst;
@@ -598,6 +603,8 @@ public:
 
     edgeData.deallocate();
     edgeData.destroy();
+
+    mappedFile.reset();
   }
 
   void constructEdge(uint64_t e, uint32_t dst,
@@ -656,11 +663,10 @@ public:
         },
         galois::no_stats(), galois::loopname("TRANSPOSE_EDGEINTDATA_INC"));
 
-    // TODO is it worth doing parallel prefix sum?
     // prefix sum calculation of the edge index array
-    for (uint32_t n = 1; n < numNodes; ++n) {
-      edgeIndData_temp[n] += edgeIndData_temp[n - 1];
-    }
+    galois::ParallelSTL::inclusive_scan(edgeIndData_temp.begin(),
+                                        edgeIndData_temp.end(),
+                                        edgeIndData_temp.begin());
 
     // copy over the new tranposed edge index data
     galois::do_all(
@@ -1010,6 +1016,59 @@ public:
     graphFile.close();
   }
 
+  /**
+   * Uses the arrays of the GR file filename in place instead of reading them
+   * into new arrays. The file is mapped read-only and shared, so processes
+   * reading the same file share one copy, but the edges and edge data of the
+   * graph must not be modified (e.g., by sortEdges). Node data is allocated
+   * as usual. Edge destinations of version 2 files are 64 bits wide and are
+   * copied into a new array.
+   */
+  void mapGraphFromGRFile(const std::string& filename,
+                          const MappedGraphFile::Options& options = {}) {
+    deallocate();
+    mappedFile = std::make_unique<MappedGraphFile>(filename, options);
+    if (EdgeData::has_value &&
+        mappedFile->sizeofEdgeData() != EdgeData::size_of::value) {
+      GALOIS_DIE("'", filename, "' has ", mappedFile->sizeofEdgeData(),
+                 " bytes of edge data instead of ", EdgeData::size_of::value);
+    }
+    numNodes = mappedFile->size();
+    numEdges = mappedFile->sizeEdges();
+    galois::gPrint("Number of Nodes: ", numNodes,
+                   ", Number of Edges: ", numEdges, "\n");
+
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      this->outOfLineAllocateBlocked(numNodes);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+    constructNodes();
+
+    // the arrays wrap the mapping and do not free it
+    EdgeIndData index(const_cast<uint64_t*>(mappedFile->edgeIndex()),
+                      numNodes);
+    swap(edgeIndData, index);
+    if (mappedFile->getVersion() == 1) {
+      EdgeDst dsts(const_cast<void*>(mappedFile->edgeDst()), numEdges);
+      swap(edgeDst, dsts);
+    } else {
+      const uint64_t* dsts =
+          static_cast<const uint64_t*>(mappedFile->edgeDst());
+      edgeDst.allocateInterleaved(numEdges);
+      galois::do_all(
+          galois::iterate(UINT64_C(0), numEdges),
+          [&](uint64_t e) { edgeDst[e] = dsts[e]; }, galois::no_stats(),
+          galois::loopname("NarrowEdgeDst"));
+    }
+    EdgeData data(const_cast<void*>(mappedFile->edgeData()), numEdges);
+    swap(edgeData, data);
+
+    initializeLocalRanges();
+  }
+
   /**
    * Given a manually created graph, initialize the local ranges on this graph
    * so that threads can iterate over a balanced number of vertices.
@@ -34,6 +34,7 @@
 #include "galois/graphs/FileGraph.h"
 #include "galois/graphs/GraphHelpers.h"
 #include "galois/PODResizeableArray.h"
+#include "galois/ParallelSTL.h"
 
 namespace galois {
 namespace graphs {
@@ -641,11 +642,10 @@ public:
         },
         galois::no_stats(), galois::loopname("TRANSPOSE_EDGEINTDATA_INC"));
 
-    // TODO is it worth doing parallel prefix sum?
     // prefix sum calculation of the edge index array
-    for (uint32_t n = 1; n < numNodes; ++n) {
-      edgeIndData_temp[n] += edgeIndData_temp[n - 1];
-    }
+    galois::ParallelSTL::partial_sum(edgeIndData_temp.begin(),
+                                     edgeIndData_temp.end(),
+                                     edgeIndData_temp.begin());
 
     // copy over the new tranposed edge index data
     galois::do_all(
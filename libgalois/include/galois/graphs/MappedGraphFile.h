@@ -0,0 +1,89 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_MAPPEDGRAPHFILE_H
+#define GALOIS_GRAPHS_MAPPEDGRAPHFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "galois/config.h"
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Read-only shared mapping of a binary graph file (.gr, version 1 or 2).
+ * The arrays of the file are used in place, so processes that map the same
+ * file share one copy in the page cache and nothing is copied on load.
+ * Because nothing is converted from the little-endian file format either,
+ * mapping a file dies on big-endian hosts; use FileGraph there.
+ */
+class MappedGraphFile {
+public:
+  //! Expected access pattern, passed to madvise
+  enum class Advice { Normal, Sequential, Random, WillNeed };
+
+  struct Options {
+    //! Fault in the whole file while mapping it
+    bool populate = false;
+    /**
+     * Interleave the pages of the file over the NUMA nodes and fault them in
+     * from all threads. Pages already in the page cache stay where they are.
+     */
+    bool interleave = false;
+    Advice advice = Advice::Normal;
+  };
+
+private:
+  void* base    = nullptr;
+  size_t length = 0;
+
+  uint64_t version;
+  uint64_t sizeofEdge;
+  uint64_t numNodes;
+  uint64_t numEdges;
+
+public:
+  //! Maps filename; dies if it cannot be read or is not a graph
+  MappedGraphFile(const std::string& filename, const Options& options);
+  ~MappedGraphFile();
+
+  MappedGraphFile(const MappedGraphFile&) = delete;
+  MappedGraphFile& operator=(const MappedGraphFile&) = delete;
+
+  //! File version: 1 for 32-bit and 2 for 64-bit edge destinations
+  uint64_t getVersion() const { return version; }
+  uint64_t sizeofEdgeData() const { return sizeofEdge; }
+  uint64_t size() const { return numNodes; }
+  uint64_t sizeEdges() const { return numEdges; }
+
+  //! End of the edges of every node
+  const uint64_t* edgeIndex() const;
+  //! Edge destinations: uint32_t for version 1 and uint64_t for version 2
+  const void* edgeDst() const;
+  //! Edge data or nullptr if the edges have no data
+  const void* edgeData() const;
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
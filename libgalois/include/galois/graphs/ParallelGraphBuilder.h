@@ -0,0 +1,439 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_PARALLEL_GRAPH_BUILDER_H
+#define GALOIS_GRAPHS_PARALLEL_GRAPH_BUILDER_H
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+namespace graphs {
+
+namespace internal {
+
+//! One edge of a ParallelGraphBuilder; ids are narrowed to 32 bits for
+//! sorting when the graph is small enough
+template <typename EdgeTy, typename IdTy = uint64_t>
+struct BuilderEdge {
+  IdTy src;
+  IdTy dst;
+  EdgeTy data;
+};
+
+template <typename IdTy>
+struct BuilderEdge<void, IdTy> {
+  IdTy src;
+  IdTy dst;
+};
+
+//! Duplicate edge reduction that keeps the data of the first edge
+struct KeepFirstEdgeData {
+  template <typename T>
+  void operator()(T&, const T&) const {}
+};
+
+} // namespace internal
+
+/**
+ * Builds a CSR graph from an unsorted list of edges in parallel. Edges can be
+ * streamed in with addEdge from any number of threads and given in bulk with
+ * addEdges. build() then
+ *
+ * 1. gathers the edges into one array, adding the reverse of every edge that
+ *    is not a self loop if symmetrizing; node ids are stored in 32 bits if
+ *    the number of nodes allows, as in LC_CSR_Graph, which halves the memory
+ *    of the array and of the sort for all but the largest graphs,
+ * 2. sorts them by source and destination with a parallel radix sort,
+ * 3. removes self loops and reduces duplicate edges within each node and
+ * 4. turns the remaining degrees into the edge index with a prefix scan,
+ *
+ * after which the graph can be written to a .gr file with toFile or loaded
+ * into an LC_CSR_Graph with toGraph. Every step is parallel. Edges of a node
+ * come out sorted by destination.
+ *
+ * The number of nodes is one more than the largest node id seen, or the
+ * number set with setNumNodes if that is larger.
+ *
+ * @tparam EdgeTy type of edge data; void for none
+ */
+template <typename EdgeTy = void>
+class ParallelGraphBuilder {
+public:
+  //! Type of edges kept by the builder
+  using Edge = internal::BuilderEdge<EdgeTy>;
+
+private:
+  using EdgeArray = LargeArray<Edge>;
+  using NarrowEdge = internal::BuilderEdge<EdgeTy, uint32_t>;
+
+  //! edges added with addEdge by each thread
+  substrate::PerThreadStorage<std::vector<Edge>> streams;
+  //! edges added with addEdges
+  std::deque<EdgeArray> chunks;
+
+  //! all edges, in the narrow array if ids fit in 32 bits; after build, the
+  //! kept edges of node n start at starts[n]
+  EdgeArray edges;
+  LargeArray<NarrowEdge> narrowEdges;
+  bool narrow = false;
+  //! start of the edges of each node in edges
+  LargeArray<uint64_t> starts;
+  //! end of the kept edges of each node in the built graph
+  LargeArray<uint64_t> ends;
+
+  uint64_t numNodes = 0;
+  uint64_t numEdges = 0;
+  bool built        = false;
+
+  bool symmetrize      = false;
+  bool removeSelfLoops = false;
+  bool removeDupEdges  = false;
+
+  //! Spans of all added edges
+  std::vector<std::pair<const Edge*, size_t>> sources() {
+    std::vector<std::pair<const Edge*, size_t>> sources;
+    for (unsigned t = 0; t < streams.size(); ++t) {
+      auto& s = *streams.getRemote(t);
+      if (!s.empty()) {
+        sources.emplace_back(s.data(), s.size());
+      }
+    }
+    for (auto& c : chunks) {
+      sources.emplace_back(c.data(), c.size());
+    }
+    return sources;
+  }
+
+  //! Calls fn with the array that holds the edges
+  template <typename F>
+  void withEdges(const F& fn) {
+    if (narrow) {
+      fn(narrowEdges);
+    } else {
+      fn(edges);
+    }
+  }
+
+  /**
+   * Moves every edge into array, freeing the added edges; returns the number
+   * of edges
+   */
+  template <typename Array>
+  uint64_t gather(Array& array) {
+    using E    = typename Array::value_type;
+    using IdTy = decltype(E::src);
+
+    auto spans     = sources();
+    uint64_t total = 0;
+    for (auto& s : spans) {
+      total += s.second;
+    }
+
+    array.allocateInterleaved(symmetrize ? 2 * total : total);
+    uint64_t offset = 0;
+    for (auto& s : spans) {
+      const Edge* src = s.first;
+      galois::do_all(
+          galois::iterate(uint64_t{0}, uint64_t(s.second)),
+          [&](uint64_t i) {
+            E& e  = array[offset + i];
+            e.src = IdTy(src[i].src);
+            e.dst = IdTy(src[i].dst);
+            if constexpr (!std::is_void<EdgeTy>::value) {
+              e.data = src[i].data;
+            }
+          },
+          galois::no_stats(), galois::loopname("BuilderGather"));
+      offset += s.second;
+    }
+
+    galois::on_each([&](unsigned tid, unsigned) {
+      std::vector<Edge>().swap(*streams.getRemote(tid));
+    });
+    chunks.clear();
+
+    if (!symmetrize) {
+      return total;
+    }
+
+    // reverse edges of everything but self loops, as makeSymmetric does
+    E* reverse = array.data() + total;
+    E* reverseEnd =
+        galois::ParallelSTL::copy_if(array.data(), array.data() + total,
+                                     reverse,
+                                     [](const E& e) { return e.src != e.dst; });
+    uint64_t numReverse = reverseEnd - reverse;
+    galois::do_all(
+        galois::iterate(uint64_t{0}, numReverse),
+        [&](uint64_t i) { std::swap(reverse[i].src, reverse[i].dst); },
+        galois::no_stats(), galois::loopname("BuilderSymmetrize"));
+    return total + numReverse;
+  }
+
+  //! Radix sorts array[0, n) by source and then destination
+  template <typename Array>
+  void sortEdges(Array& array, uint64_t n) {
+    using E = typename Array::value_type;
+    unsigned nodeBits =
+        galois::ParallelSTL::internal::bitWidth(numNodes ? numNodes - 1 : 0);
+    E* first = array.data();
+    E* last  = first + n;
+    if (2 * nodeBits <= 64) {
+      // both ids fit in one key, so one sort does it
+      uint64_t maxId = numNodes ? numNodes - 1 : 0;
+      galois::ParallelSTL::radix_sort(
+          first, last,
+          [=](const E& e) { return (uint64_t(e.src) << nodeBits) | e.dst; },
+          (maxId << nodeBits) | maxId);
+    } else {
+      galois::ParallelSTL::radix_sort(
+          first, last, [](const E& e) { return uint64_t(e.dst); },
+          numNodes - 1);
+      galois::ParallelSTL::radix_sort(
+          first, last, [](const E& e) { return uint64_t(e.src); },
+          numNodes - 1);
+    }
+  }
+
+  //! Makes the edge index of the sorted array[0, n)
+  template <typename Array>
+  void findStarts(Array& array, uint64_t n) {
+    using E = typename Array::value_type;
+    starts.allocateInterleaved(numNodes + 1);
+    galois::ParallelSTL::histogram(
+        array.data(), array.data() + n, numNodes,
+        [](const E& e) { return e.src; }, starts.data());
+    starts[numNodes] = 0;
+    galois::ParallelSTL::exclusive_scan(starts.begin(), starts.end(),
+                                        starts.begin(), uint64_t{0});
+  }
+
+  /**
+   * Removes self loops and duplicate edges from the sorted edges of every
+   * node in place and sets the ends array to the edge index of what is left.
+   */
+  template <typename Array, typename ReduceFn>
+  void compactEdges(Array& array, ReduceFn& reduce) {
+    ends.allocateInterleaved(numNodes);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, numNodes),
+        [&](uint64_t n) {
+          uint64_t out = starts[n];
+          for (uint64_t i = starts[n], ie = starts[n + 1]; i < ie; ++i) {
+            if (removeSelfLoops && array[i].src == array[i].dst) {
+              continue;
+            }
+            if (removeDupEdges && out > starts[n] &&
+                array[out - 1].dst == array[i].dst) {
+              if constexpr (!std::is_void<EdgeTy>::value) {
+                reduce(array[out - 1].data, array[i].data);
+              }
+              continue;
+            }
+            if (out != i) {
+              array[out] = array[i];
+            }
+            ++out;
+          }
+          ends[n] = out - starts[n];
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("BuilderCompact"));
+
+    galois::ParallelSTL::partial_sum(ends.begin(), ends.end(), ends.begin());
+    numEdges = numNodes ? ends[numNodes - 1] : 0;
+  }
+
+  //! Calls fn(n, e, edge) for the e-th edge of the built graph
+  template <typename F>
+  void forEachEdge(const F& fn) {
+    withEdges([&](auto& array) {
+      galois::do_all(
+          galois::iterate(uint64_t{0}, numNodes),
+          [&](uint64_t n) {
+            uint64_t e = n ? ends[n - 1] : 0;
+            for (uint64_t i = starts[n]; e < ends[n]; ++i, ++e) {
+              fn(n, e, array[i]);
+            }
+          },
+          galois::steal(), galois::no_stats(),
+          galois::loopname("BuilderCopyEdges"));
+    });
+  }
+
+public:
+  //! Adds the reverse of every edge that is not a self loop when building
+  void setSymmetrize(bool v = true) { symmetrize = v; }
+  //! Drops edges from a node to itself when building
+  void setRemoveSelfLoops(bool v = true) { removeSelfLoops = v; }
+  //! Keeps one edge per (source, destination) pair when building; the data
+  //! of duplicates is combined with the reduction given to build
+  void setRemoveDuplicates(bool v = true) { removeDupEdges = v; }
+  //! Makes the graph have at least n nodes
+  void setNumNodes(uint64_t n) { numNodes = n; }
+
+  /**
+   * Adds an edge. Thread safe: every thread appends to its own buffer.
+   */
+  template <typename T = EdgeTy,
+            typename std::enable_if<std::is_void<T>::value>::type* = nullptr>
+  void addEdge(uint64_t src, uint64_t dst) {
+    streams.getLocal()->push_back(Edge{src, dst});
+  }
+
+  template <typename T = EdgeTy,
+            typename std::enable_if<!std::is_void<T>::value>::type* = nullptr>
+  void addEdge(uint64_t src, uint64_t dst, const T& data) {
+    streams.getLocal()->push_back(Edge{src, dst, data});
+  }
+
+  /**
+   * Adds n edges in parallel: edge i is edgeAt(i), which must return an
+   * Edge. Use this for edges already in memory (e.g., arrays of sources and
+   * destinations) to skip the per-thread buffers.
+   */
+  template <typename F>
+  void addEdges(uint64_t n, const F& edgeAt) {
+    chunks.emplace_back();
+    EdgeArray& chunk = chunks.back();
+    chunk.allocateInterleaved(n);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, n),
+        [&](uint64_t i) { chunk[i] = edgeAt(i); }, galois::no_stats(),
+        galois::loopname("BuilderAddEdges"));
+  }
+
+  /**
+   * Builds the graph from the edges added so far. Duplicate edges are
+   * combined with reduce(kept, other), which may update the data of the kept
+   * edge. Called by toFile and toGraph if not called before.
+   */
+  template <typename ReduceFn = internal::KeepFirstEdgeData>
+  void build(ReduceFn reduce = ReduceFn()) {
+    // the number of nodes decides how wide the ids of the sorted edges are
+    galois::GReduceMax<uint64_t> maxId;
+    bool any = false;
+    for (auto& s : sources()) {
+      const Edge* src = s.first;
+      galois::do_all(
+          galois::iterate(uint64_t{0}, uint64_t(s.second)),
+          [&](uint64_t i) { maxId.update(std::max(src[i].src, src[i].dst)); },
+          galois::no_stats(), galois::loopname("BuilderMaxId"));
+      any = any || s.second;
+    }
+    if (any) {
+      numNodes = std::max(numNodes, maxId.reduce() + 1);
+    }
+    narrow = numNodes <= uint64_t(std::numeric_limits<uint32_t>::max()) + 1;
+
+    withEdges([&](auto& array) {
+      uint64_t n = gather(array);
+      sortEdges(array, n);
+      findStarts(array, n);
+      compactEdges(array, reduce);
+    });
+    built = true;
+  }
+
+  //! Number of nodes of the built graph
+  uint64_t size() const { return numNodes; }
+  //! Number of edges of the built graph
+  uint64_t sizeEdges() const { return numEdges; }
+
+  /**
+   * Writes the built graph to a .gr file.
+   */
+  void toFile(const std::string& filename) {
+    if (!built) {
+      build();
+    }
+
+    FileGraphWriter writer;
+    writer.setNumNodes(numNodes);
+    writer.setNumEdges<EdgeTy>(numEdges);
+    writer.phase1();
+
+    uint64_t* outIdx = writer.edgeEndArray();
+    galois::do_all(
+        galois::iterate(uint64_t{0}, numNodes),
+        [&](uint64_t n) { outIdx[n] = ends[n]; }, galois::no_stats(),
+        galois::loopname("BuilderCopyIndex"));
+
+    bool v1 = numNodes <= std::numeric_limits<uint32_t>::max();
+    void* outs = writer.edgeDstArray();
+    forEachEdge([&](uint64_t, uint64_t e, const auto& edge) {
+      if (v1) {
+        static_cast<uint32_t*>(outs)[e] = edge.dst;
+      } else {
+        static_cast<uint64_t*>(outs)[e] = edge.dst;
+      }
+      if constexpr (!std::is_void<EdgeTy>::value) {
+        writer.template edgeDataArray<EdgeTy>()[e] = edge.data;
+      }
+    });
+
+    writer.finish();
+    writer.toFile(filename);
+  }
+
+  /**
+   * Loads the built graph into graph, an LC_CSR_Graph or a graph with the
+   * same construction interface.
+   */
+  template <typename GraphTy>
+  void toGraph(GraphTy& graph) {
+    if (!built) {
+      build();
+    }
+    GALOIS_ASSERT(numNodes <= std::numeric_limits<uint32_t>::max(),
+                  "too many nodes for LC_CSR_Graph");
+
+    graph.allocateFrom(numNodes, numEdges);
+    graph.constructNodes();
+    galois::do_all(
+        galois::iterate(uint64_t{0}, numNodes),
+        [&](uint64_t n) { graph.fixEndEdge(n, ends[n]); }, galois::no_stats(),
+        galois::loopname("BuilderCopyIndex"));
+    forEachEdge([&](uint64_t, uint64_t e, const auto& edge) {
+      if constexpr (std::is_void<EdgeTy>::value) {
+        graph.constructEdge(e, edge.dst);
+      } else {
+        graph.constructEdge(e, edge.dst, edge.data);
+      }
+    });
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,277 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_PARALLEL_TEXT_READER_H
+#define GALOIS_GRAPHS_PARALLEL_TEXT_READER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// floating point from_chars needs libstdc++ 11 or newer
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Read-only view of a memory-mapped text file that is parsed line by line in
+ * parallel. The file is split into a few chunks per thread at newline
+ * boundaries, and the lines of every chunk are counted up front so that each
+ * line knows its line number without a serial pass over the file.
+ *
+ * Lines are given to the caller as [begin, end) without the newline (or a
+ * trailing carriage return); nothing is copied.
+ */
+class ParallelTextReader {
+  const char* data = nullptr;
+  size_t length    = 0;
+  //! start of each chunk and the end of the text
+  std::vector<const char*> bounds;
+  //! line number of the first line of each chunk and the number of lines
+  std::vector<uint64_t> firstLine;
+
+  void split(const char* begin);
+
+public:
+  //! Maps filename; dies if it cannot be read
+  explicit ParallelTextReader(const std::string& filename);
+  ~ParallelTextReader();
+
+  ParallelTextReader(const ParallelTextReader&) = delete;
+  ParallelTextReader& operator=(const ParallelTextReader&) = delete;
+
+  //! Number of bytes of the file
+  size_t size() const { return length; }
+  //! Start of the text
+  const char* begin() const { return data; }
+  //! End of the text
+  const char* end() const { return data + length; }
+
+  /**
+   * Makes the following calls ignore everything before p, e.g., a header
+   * that was parsed serially. p must be the start of a line.
+   */
+  void skipTo(const char* p) { split(p); }
+
+  //! Number of lines after the skipped part
+  uint64_t numLines() const { return firstLine.back(); }
+
+  /**
+   * Calls fn(lineNumber, begin, end) on every line in parallel. Line numbers
+   * start at 0 after the skipped part.
+   */
+  template <typename F>
+  void forEachLine(const F& fn) const {
+    galois::do_all(
+        galois::iterate(size_t{0}, bounds.size() - 1),
+        [&](size_t c) {
+          uint64_t line   = firstLine[c];
+          const char* p   = bounds[c];
+          const char* end = bounds[c + 1];
+          while (p < end) {
+            const char* nl =
+                static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* le = nl ? nl : end;
+            const char* e  = (le > p && le[-1] == '\r') ? le - 1 : le;
+            fn(line++, p, e);
+            p = le + 1;
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("ParallelTextReader"));
+  }
+};
+
+//! Helpers for parsing numbers from lines given by ParallelTextReader
+namespace text {
+
+//! Skips spaces and tabs
+inline const char* skipSpace(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t')) {
+    ++p;
+  }
+  return p;
+}
+
+/**
+ * True if the 8 bytes at p are all decimal digits. The checks and the
+ * conversion below work on all 8 bytes at once in a 64-bit register.
+ */
+inline bool isEightDigits(const char* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return (((v & 0xF0F0F0F0F0F0F0F0) |
+           (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+          0x3333333333333333);
+}
+
+//! Value of the 8 decimal digits at p (little-endian hosts only)
+inline uint64_t parseEightDigits(const char* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  v = ((v & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+  v = ((v & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+  return ((v & 0x0000FFFF0000FFFF) * 42949672960001) >> 32;
+}
+
+/**
+ * Parses an unsigned decimal integer at p, after optional spaces.
+ *
+ * @returns pointer past the number or nullptr if there is none or it does
+ * not fit in 64 bits
+ */
+inline const char* parseUint(const char* p, const char* end, uint64_t& out) {
+  p = skipSpace(p, end);
+  if (p == end || unsigned(*p - '0') > 9) {
+    return nullptr;
+  }
+  uint64_t v = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - p >= 8 && isEightDigits(p)) {
+    if (__builtin_mul_overflow(v, 100000000, &v) ||
+        __builtin_add_overflow(v, parseEightDigits(p), &v)) {
+      return nullptr;
+    }
+    p += 8;
+  }
+#endif
+  while (p < end && unsigned(*p - '0') <= 9) {
+    if (__builtin_mul_overflow(v, 10, &v) ||
+        __builtin_add_overflow(v, *p - '0', &v)) {
+      return nullptr;
+    }
+    ++p;
+  }
+  out = v;
+  return p;
+}
+
+/**
+ * Parses a decimal or scientific floating point number at p. Uses from_chars
+ * where the standard library has it for floating point and strtod and
+ * friends on a NUL-terminated copy of the number otherwise.
+ *
+ * @returns pointer past the number or nullptr if there is none or it is out
+ * of the range of T
+ */
+template <typename T>
+const char* parseFloat(const char* p, const char* end, T& out) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  auto r = std::from_chars(p, end, out);
+  return r.ec == std::errc() ? r.ptr : nullptr;
+#else
+  // numbers that do not fit in buf fail below
+  char buf[64];
+  size_t len = std::min<size_t>(end - p, sizeof(buf) - 1);
+  std::memcpy(buf, p, len);
+  buf[len] = '\0';
+  // from_chars takes neither a second sign nor hexadecimal numbers, of which
+  // it only reads the leading 0
+  char* digits = buf + (buf[0] == '-');
+  if (*digits == '+' || *digits == '-') {
+    return nullptr;
+  }
+  if (digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+    digits[1] = '\0';
+  }
+
+  char* last;
+  errno = 0;
+  if constexpr (std::is_same<T, float>::value) {
+    out = std::strtof(buf, &last);
+  } else if constexpr (std::is_same<T, double>::value) {
+    out = std::strtod(buf, &last);
+  } else {
+    out = std::strtold(buf, &last);
+  }
+  bool truncated = size_t(last - buf) == len && len < size_t(end - p);
+  if (last == buf || errno == ERANGE || truncated) {
+    return nullptr;
+  }
+  return p + (last - buf);
+#endif
+}
+
+/**
+ * Parses a number of type T at p, after optional spaces: an optionally
+ * signed integer for integral types and a decimal or scientific number for
+ * floating point types.
+ *
+ * @returns pointer past the number or nullptr if there is none, its
+ * magnitude does not fit in T or it is negative and T is unsigned
+ */
+template <typename T>
+const char* parseNumber(const char* p, const char* end, T& out) {
+  p = skipSpace(p, end);
+  if constexpr (std::is_floating_point<T>::value) {
+    if (p < end && *p == '+') {
+      ++p;
+    }
+    return parseFloat(p, end, out);
+  } else {
+    bool negative = p < end && *p == '-';
+    if (negative && std::is_unsigned<T>::value) {
+      return nullptr;
+    }
+    if (p < end && (*p == '-' || *p == '+')) {
+      ++p;
+    }
+    uint64_t v;
+    p = parseUint(p, end, v);
+    if (!p) {
+      return nullptr;
+    }
+    // the magnitude of the most negative value is one more than the maximum
+    uint64_t max = std::numeric_limits<T>::max();
+    if (v > max + (std::is_signed<T>::value && negative)) {
+      return nullptr;
+    }
+    out = negative ? T(-v) : T(v);
+    return p;
+  }
+}
+
+/**
+ * Expects c at p, after optional spaces.
+ *
+ * @returns pointer past c or nullptr if it is not there
+ */
+inline const char* expectChar(const char* p, const char* end, char c) {
+  p = skipSpace(p, end);
+  return (p < end && *p == c) ? p + 1 : nullptr;
+}
+
+} // namespace text
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_RUNTIME_ADAPTIVECHUNKSIZE_H
+#define GALOIS_RUNTIME_ADAPTIVECHUNKSIZE_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "galois/config.h"
+#include "galois/runtime/EventTrace.h"
+#include "galois/runtime/Statistics.h"
+
+namespace galois::runtime {
+
+/**
+ * Chunk size of one thread tuned while a loop runs. A chunk should take
+ * about TARGET_TICKS time stamp counter ticks: long enough that taking it
+ * costs little, short enough that idle threads find work to steal. The size
+ * doubles after a chunk that took less than half of that and halves after
+ * one that took more than twice as long, in both cases extrapolated to a
+ * full chunk. Other threads having to steal work halve it too.
+ */
+class AdaptiveChunkSize {
+  unsigned m_size;
+  unsigned m_max;
+  uint64_t m_start  = 0;
+  uint64_t m_chunks = 0;
+  uint64_t m_items  = 0;
+
+public:
+  //! about 10us on current machines
+  static constexpr uint64_t TARGET_TICKS = 1 << 15;
+
+  explicit AdaptiveChunkSize(unsigned initial = 32, unsigned max = 4096)
+      : m_size(std::max(1u, std::min(initial, max))), m_max(max) {}
+
+  unsigned get() const { return m_size; }
+
+  //! A chunk starts
+  void start() { m_start = readTSC(); }
+
+  //! The chunk that started last had items items and is done
+  void stop(unsigned items) {
+    if (items != 0) {
+      stop(items, readTSC() - m_start);
+    }
+  }
+
+  //! A chunk of items items took elapsed ticks
+  void stop(unsigned items, uint64_t elapsed) {
+    if (items == 0) {
+      return;
+    }
+    ++m_chunks;
+    m_items += items;
+
+    uint64_t full = elapsed / items * m_size;
+    if (full < TARGET_TICKS / 2) {
+      m_size = std::min(m_max, m_size * 2);
+    } else if (full > TARGET_TICKS * 2) {
+      m_size = std::max(1u, m_size / 2);
+    }
+  }
+
+  //! Another thread had to steal a chunk
+  void contended() { m_size = std::max(1u, m_size / 2); }
+
+  /**
+   * Reports the average number of items per chunk of this thread as
+   * "ChunkSize" (TAVG) and the number of chunks as "Chunks" (TSUM) of region
+   * loopname.
+   */
+  void report(const char* loopname) const {
+    if (m_chunks > 0) {
+      reportStat_Tavg(loopname, "ChunkSize", double(m_items) / m_chunks);
+      reportStat_Tsum(loopname, "Chunks", m_chunks);
+    }
+  }
+};
+
+} // namespace galois::runtime
+
+#endif
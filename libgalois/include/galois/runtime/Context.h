@@ -109,6 +109,12 @@ protected:
     return lockable->owner.CAS(other, this);
   }
 
+  //! tryLock and setOwner of an unowned lockable in one atomic step
+  inline bool tryLockAndSetOwner(Lockable* lockable) {
+    assert(lockable != nullptr);
+    return lockable->owner.CAS_and_lock(nullptr, this);
+  }
+
   inline void setOwner(Lockable* lockable) {
     assert(lockable != nullptr);
     assert(!lockable->owner.getValue());
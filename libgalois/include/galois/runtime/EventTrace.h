@@ -0,0 +1,170 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file EventTrace.h
+ *
+ * Per-thread event recorder for looking at loops over time. Setting the
+ * environment variable GALOIS_EVENT_TRACE to a file name makes the runtime
+ * record loop begin/end, worklist chunk pushes and pops, steal attempts,
+ * idle phases and barrier waits of every thread into a fixed-size ring
+ * buffer (GALOIS_EVENT_TRACE_SIZE events per thread, 65536 by default; older
+ * events are overwritten). The buffers are written as Chrome trace-event
+ * JSON, which chrome://tracing and Perfetto display, when the statistics are
+ * printed. When tracing is off, recording an event is a load and a branch.
+ */
+
+#ifndef GALOIS_RUNTIME_EVENTTRACE_H
+#define GALOIS_RUNTIME_EVENTTRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+#if defined(__i386__) || defined(__amd64__)
+#include <x86intrin.h>
+#endif
+
+#include "galois/config.h"
+#include "galois/substrate/Barrier.h"
+#include "galois/substrate/ThreadPool.h"
+
+namespace galois::runtime {
+
+enum class TraceEvent : uint32_t {
+  LoopBegin,    //!< thread starts working on a loop; has a name
+  LoopEnd,      //!< thread is done with a loop
+  WorklistPush, //!< a full chunk of arg items was published
+  WorklistPop,  //!< a chunk of arg items was taken from a worklist
+  Steal,        //!< a steal attempt that got arg items (0 if it failed)
+  IdleBegin,    //!< thread ran out of work and is looking for more
+  IdleEnd,      //!< thread found work again or left the loop
+  BarrierBegin, //!< thread arrives at a barrier
+  BarrierEnd    //!< thread leaves a barrier
+};
+
+namespace internal {
+
+struct TraceRecord {
+  uint64_t tsc;
+  uint64_t arg;
+  const char* name;
+  TraceEvent type;
+};
+
+//! Ring buffer of one thread; only its owner writes it
+struct EventRing {
+  TraceRecord* records;
+  uint64_t mask;
+  uint64_t next;
+
+  void record(uint64_t tsc, TraceEvent type, const char* name, uint64_t arg) {
+    TraceRecord& r = records[next & mask];
+    r.tsc          = tsc;
+    r.arg          = arg;
+    r.name         = name;
+    r.type         = type;
+    ++next;
+  }
+};
+
+extern bool eventTraceOn;
+extern EventRing** eventRings;
+
+//! Allocates the ring of the calling thread on first use
+EventRing* makeEventRing(unsigned tid);
+
+//! Copy of name that lives until the trace is written
+const char* internTraceName(const char* name);
+
+//! Starts recording if GALOIS_EVENT_TRACE is set
+void initEventTrace();
+//! Writes the trace to the file named by GALOIS_EVENT_TRACE, if recording
+void printEventTrace();
+void finishEventTrace();
+
+//! Writes s as a quoted JSON string
+void writeJSONString(std::ostream& out, const char* s);
+
+} // namespace internal
+
+//! Time stamp counter, or nanoseconds where there is none
+inline uint64_t readTSC() {
+#if defined(__i386__) || defined(__amd64__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+//! True if events are being recorded
+inline bool eventTraceEnabled() { return internal::eventTraceOn; }
+
+/**
+ * Records an event of the calling thread at time tsc. Only loop begin events
+ * keep their name, which may be a temporary.
+ */
+inline void traceEventAt(uint64_t tsc, TraceEvent type, uint64_t arg = 0,
+                         const char* name = nullptr) {
+  if (__builtin_expect(!internal::eventTraceOn, 1)) {
+    return;
+  }
+  unsigned tid              = substrate::ThreadPool::getMachineTID();
+  internal::EventRing* ring = internal::eventRings[tid];
+  if (!ring) {
+    ring = internal::makeEventRing(tid);
+  }
+  if (type == TraceEvent::LoopBegin) {
+    name = internal::internTraceName(name);
+  }
+  ring->record(tsc, type, name, arg);
+}
+
+//! Records an event of the calling thread now
+inline void traceEvent(TraceEvent type, uint64_t arg = 0,
+                       const char* name = nullptr) {
+  if (__builtin_expect(!internal::eventTraceOn, 1)) {
+    return;
+  }
+  traceEventAt(readTSC(), type, arg, name);
+}
+
+//! Waits at barrier b, recording the wait
+inline void tracedBarrierWait(substrate::Barrier& b) {
+  traceEvent(TraceEvent::BarrierBegin);
+  b.wait();
+  traceEvent(TraceEvent::BarrierEnd);
+}
+
+/**
+ * Writes the recorded events of all threads as Chrome trace-event JSON.
+ * Spans (loops, idle phases, barrier waits) become complete events on the
+ * track of their thread; chunk pushes/pops and steals become instant events
+ * with the number of items. Must be called while no loop is running.
+ */
+void writeEventTrace(std::ostream& out);
+
+//! Number of events lost because ring buffers wrapped around
+uint64_t droppedTraceEvents();
+
+} // namespace galois::runtime
+
+#endif
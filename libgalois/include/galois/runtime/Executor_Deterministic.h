@@ -134,6 +134,10 @@ public:
   bool isReady() { return !notReady; }
 
   virtual void alwaysAcquire(Lockable* lockable, galois::MethodFlag) {
+    if (OptionsTy::fastMode) {
+      mark(lockable);
+      return;
+    }
 
     if (this->tryLock(lockable))
       this->addToNhood(lockable);
@@ -160,6 +164,31 @@ public:
     }
   }
 
+  /**
+   * Same outcome as the default acquire, but the owner word of the lockable
+   * is the only mark: the first iteration to touch it takes it with one CAS
+   * (and releases it at the end of the round), later ones with a smaller id
+   * steal it with one CAS.
+   */
+  void mark(Lockable* lockable) {
+    DeterministicContextBase* other;
+    while ((other = static_cast<DeterministicContextBase*>(
+                this->getOwner(lockable))) != this) {
+      if (!other) {
+        if (this->tryLockAndSetOwner(lockable)) {
+          this->addToNhood(lockable);
+          return;
+        }
+      } else if (other->item.id < this->item.id) {
+        notReady = true;
+        return;
+      } else if (this->stealByCAS(lockable, other)) {
+        other->notReady = true;
+        return;
+      }
+    }
+  }
+
   static void initialize() {}
 };
 
@@ -473,6 +502,7 @@ struct OptionsCommon {
       has_trait<fixed_neighborhood_tag, ArgsTy>();
   constexpr static bool hasIntentToRead =
       has_trait<intent_to_read_tag, ArgsTy>();
+  constexpr static bool fastMode = has_trait<det_fast_tag, ArgsTy>();
 
   static const int ChunkSize             = 32;
   static const unsigned InitialNumRounds = 100;
@@ -556,8 +586,8 @@ class DAGManagerBase<OptionsTy, true> {
 
 public:
   DAGManagerBase()
-      : term(substrate::getSystemTermination(activeThreads)),
-        barrier(getBarrier(activeThreads)) {}
+      : term(substrate::getSystemTermination(galois::getActiveThreads())),
+        barrier(getBarrier(galois::getActiveThreads())) {}
 
   void destroyDAGManager() { data.getLocal()->heap.clear(); }
 
@@ -750,7 +780,7 @@ class BreakManagerBase<OptionsTy, true> {
 public:
   BreakManagerBase(const OptionsTy& o)
       : breakFn(get_trait_value<det_parallel_break_tag>(o.args).value),
-        barrier(getBarrier(activeThreads)) {}
+        barrier(getBarrier(galois::getActiveThreads())) {}
 
   bool checkBreak() {
     if (substrate::ThreadPool::getTID() == 0)
@@ -780,7 +810,7 @@ class IntentToReadManagerBase<OptionsTy, true> {
   substrate::Barrier& barrier;
 
 public:
-  IntentToReadManagerBase() : barrier(getBarrier(activeThreads)) {}
+  IntentToReadManagerBase() : barrier(getBarrier(galois::getActiveThreads())) {}
 
   void pushIntentToReadTask(Context* ctx) {
     pending.getLocal()->push_back(ctx);
@@ -838,11 +868,14 @@ public:
   ThreadLocalData& getLocalWindowManager() { return *data.getLocal(); }
 
   size_t nextWindow(size_t dist, size_t atleast, size_t base = 0) {
-    if (false) {
-      // This, which tries to continue delta with new work, seems to result in
-      // more conflicts (although less total rounds) and more time
+    if (OptionsTy::fastMode) {
+      // Continue delta with new work rather than ramping the window up again
+      // from dist / InitialNumRounds after every outer round
       ThreadLocalData& local = *data.getLocal();
-      return local.nextWindow(true);
+      size_t w     = std::max(local.delta, atleast);
+      local.delta  = std::min(w, std::max(dist, atleast));
+      local.window = local.delta + base;
+      return local.window;
     } else {
       return initialWindow(dist, atleast, base);
     }
@@ -876,7 +909,12 @@ public:
     else if (allcommitted == 0) {
       assert((alliterations == 0) && "someone should have committed");
       local.delta += local.delta;
-    } else
+    } else if (OptionsTy::fastMode)
+      // shrink gradually: one round with many conflicts should not throw
+      // away a window that worked for many rounds
+      local.delta = std::max(local.delta / 4,
+                             size_t(commitRatio / target * local.delta));
+    else
       local.delta = commitRatio / target * local.delta;
 
     if (!inner) {
@@ -1248,7 +1286,7 @@ class NewWorkManager : public IdManager<OptionsTy> {
 public:
   NewWorkManager(const OptionsTy& o)
       : IdManager<OptionsTy>(o), alloc(&heap), mergeBuf(alloc),
-        distributeBuf(alloc), barrier(getBarrier(activeThreads)) {
+        distributeBuf(alloc), barrier(getBarrier(galois::getActiveThreads())) {
     numActive = getActiveThreads();
   }
 
@@ -1376,7 +1414,7 @@ class Executor : public BreakManager<OptionsTy>,
 public:
   Executor(const OptionsTy& o)
       : BreakManager<OptionsTy>(o), NewWorkManager<OptionsTy>(o), options(o),
-        barrier(getBarrier(activeThreads)),
+        barrier(getBarrier(galois::getActiveThreads())),
         loopname(galois::internal::getLoopName(o.args)) {
     static_assert(!OptionsTy::needsBreak || OptionsTy::hasBreak,
                   "need to use break function to break loop");
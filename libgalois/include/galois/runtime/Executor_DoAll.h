@@ -22,8 +22,12 @@
 
 #include "galois/config.h"
 #include "galois/gIO.h"
+#include "galois/Threads.h"
+#include "galois/runtime/AdaptiveChunkSize.h"
+#include "galois/runtime/EventTrace.h"
 #include "galois/runtime/Executor_OnEach.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/runtime/Statistics.h"
 #include "galois/substrate/Barrier.h"
 #include "galois/substrate/CompilerSpecific.h"
@@ -50,6 +54,8 @@ class DoAllStealingExec {
   constexpr static const bool MORE_STATS =
       NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
   constexpr static const bool USE_TERM = false;
+  constexpr static const bool ADAPTIVE =
+      has_trait<adaptive_chunk_size_tag, ArgsTuple>();
 
   struct ThreadContext {
 
@@ -61,18 +67,26 @@ class DoAllStealingExec {
     Diff_ty m_size;
     size_t num_iter;
 
+    // chunk size of this thread if ADAPTIVE
+    AdaptiveChunkSize adaptive;
+    // times other threads stole from this one, and the count last seen
+    unsigned num_stolen;
+    unsigned seen_stolen;
+
     // Stats
 
     ThreadContext()
         : work_mutex(), id(substrate::getThreadPool().getMaxThreads()),
-          shared_beg(), shared_end(), m_size(0), num_iter(0) {
+          shared_beg(), shared_end(), m_size(0), num_iter(0), num_stolen(0),
+          seen_stolen(0) {
       // TODO: fix this initialization problem,
       // see initThread
     }
 
-    ThreadContext(unsigned id, Iter beg, Iter end)
+    ThreadContext(unsigned id, Iter beg, Iter end, unsigned chunk_size)
         : work_mutex(), id(id), shared_beg(beg), shared_end(end),
-          m_size(std::distance(beg, end)), num_iter(0) {}
+          m_size(std::distance(beg, end)), num_iter(0), adaptive(chunk_size),
+          num_stolen(0), seen_stolen(0) {}
 
     bool doWork(F func, const unsigned chunk_size) {
       Iter beg(shared_beg);
@@ -80,16 +94,27 @@ class DoAllStealingExec {
 
       bool didwork = false;
 
-      while (getWork(beg, end, chunk_size)) {
+      while (getWork(beg, end, ADAPTIVE ? adaptive.get() : chunk_size)) {
 
-        didwork = true;
+        didwork        = true;
+        unsigned items = 0;
+        if (ADAPTIVE) {
+          adaptive.start();
+        }
 
         for (; beg != end; ++beg) {
           if (NEED_STATS) {
             ++num_iter;
           }
+          if (ADAPTIVE) {
+            ++items;
+          }
           func(*beg);
         }
+
+        if (ADAPTIVE) {
+          adaptive.stop(items);
+        }
       }
 
       return didwork;
@@ -119,6 +144,11 @@ class DoAllStealingExec {
 
       work_mutex.lock();
       {
+        if (ADAPTIVE && seen_stolen != num_stolen) {
+          seen_stolen = num_stolen;
+          adaptive.contended();
+        }
+
         if (hasWorkWeak()) {
           succ = true;
 
@@ -183,6 +213,7 @@ class DoAllStealingExec {
 
         if (hasWorkWeak()) {
           succ = true;
+          ++num_stolen;
 
           if (amount == HALF && m_size > (Diff_ty)chunk_size) {
             steal_size = m_size / 2;
@@ -371,7 +402,7 @@ public:
       : range(_range), func(_func),
         loopname(galois::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(substrate::getSystemTermination(activeThreads)),
+        term(substrate::getSystemTermination(galois::getActiveThreads())),
         totalTime(loopname, "Total"), initTime(loopname, "Init"),
         execTime(loopname, "Execute"), stealTime(loopname, "Steal"),
         termTime(loopname, "Term") {
@@ -387,7 +418,7 @@ public:
     unsigned id = substrate::ThreadPool::getTID();
 
     *workers.getLocal(id) =
-        ThreadContext(id, range.local_begin(), range.local_end());
+        ThreadContext(id, range.local_begin(), range.local_end(), chunk_size);
 
     initTime.stop();
   }
@@ -407,7 +438,10 @@ public:
   void operator()(void) {
 
     ThreadContext& ctx = *workers.getLocal();
+    LoopPerfCounters<NEED_STATS> counters;
+    counters.start();
     totalTime.start();
+    traceEvent(TraceEvent::LoopBegin, 0, loopname);
 
     while (true) {
       bool workHappened = false;
@@ -422,9 +456,12 @@ public:
 
       assert(!ctx.hasWork());
 
+      traceEvent(TraceEvent::IdleBegin);
       stealTime.start();
       bool stole = trySteal(ctx);
       stealTime.stop();
+      traceEvent(TraceEvent::Steal, stole ? ctx.m_size : 0);
+      traceEvent(TraceEvent::IdleEnd);
 
       if (stole) {
         continue;
@@ -448,11 +485,16 @@ public:
       }
     }
 
+    traceEvent(TraceEvent::LoopEnd);
     totalTime.stop();
+    counters.stop(loopname);
     assert(!ctx.hasWork());
 
     if (NEED_STATS) {
       galois::runtime::reportStat_Tsum(loopname, "Iterations", ctx.num_iter);
+      if (ADAPTIVE) {
+        ctx.adaptive.report(loopname);
+      }
     }
   }
 };
@@ -467,11 +509,11 @@ struct ChooseDoAllImpl {
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
         exec(range, std::forward<F>(func), argsTuple);
 
-    substrate::Barrier& barrier = getBarrier(activeThreads);
+    substrate::Barrier& barrier = getBarrier(galois::getActiveThreads());
 
     substrate::getThreadPool().run(
-        activeThreads, [&exec](void) { exec.initThread(); }, std::ref(barrier),
-        std::ref(exec));
+        galois::getActiveThreads(), [&exec](void) { exec.initThread(); },
+        [&barrier](void) { tracedBarrierWait(barrier); }, std::ref(exec));
   }
 };
 
@@ -493,8 +535,11 @@ struct ChooseDoAllImpl<false> {
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
+          LoopPerfCounters<NEED_STATS> counters;
 
+          counters.start();
           totalTime.start();
+          traceEvent(TraceEvent::LoopBegin, 0, loopname);
           initTime.start();
 
           auto begin     = range.local_begin();
@@ -514,7 +559,9 @@ struct ChooseDoAllImpl<false> {
           }
           execTime.stop();
 
+          traceEvent(TraceEvent::LoopEnd);
           totalTime.stop();
+          counters.stop(loopname);
 
           if (NEED_STATS) {
             galois::runtime::reportStat_Tsum(loopname, "Iterations", iter);
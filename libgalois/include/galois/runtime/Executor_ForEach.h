@@ -29,8 +29,10 @@
 #include "galois/gIO.h"
 #include "galois/Mem.h"
 #include "galois/runtime/Context.h"
+#include "galois/runtime/EventTrace.h"
 #include "galois/runtime/LoopStatistics.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/runtime/Range.h"
 #include "galois/runtime/Statistics.h"
 #include "galois/runtime/Substrate.h"
@@ -303,9 +305,19 @@ protected:
     return wl.empty();
   }
 
+  void reportWorklistStats(WorkListTy&, ...) {}
+
+  template <typename WL>
+  auto reportWorklistStats(WL& wl, int)
+      -> decltype(wl.reportStats(loopname), void()) {
+    wl.reportStats(loopname);
+  }
+
   template <bool couldAbort, bool isLeader>
   void go() {
 
+    LoopPerfCounters<needStats> counters;
+    counters.start();
     execTime.start();
 
     // Thread-local data goes on the local stack to be NUMA friendly
@@ -317,10 +329,14 @@ protected:
     if (needsPush && !couldAbort)
       tld.facing.setFastPushBack(std::bind(&ForEachExecutor::fastPushBack, this,
                                            std::placeholders::_1));
+    traceEvent(TraceEvent::LoopBegin, 0, loopname);
+    // only tracked while tracing; an idle phase ends when a round finds work
+    bool idle = false;
 
     while (true) {
       do {
-        bool didWork = false;
+        bool didWork        = false;
+        uint64_t roundStart = idle ? readTSC() : 0;
 
         // Run some iterations
         if (couldAbort || needsBreak) {
@@ -337,11 +353,24 @@ protected:
           didWork = b || didWork;
         }
 
+        if (didWork && idle) {
+          traceEventAt(roundStart, TraceEvent::IdleEnd);
+          idle = false;
+        } else if (!didWork && !idle && eventTraceEnabled()) {
+          traceEvent(TraceEvent::IdleBegin);
+          idle = true;
+        }
+
         // Update node color and prop token
         term.localTermination(didWork);
         substrate::asmPause(); // Let token propagate
       } while (!term.globalTermination() && (!needsBreak || !broke));
 
+      if (idle) {
+        traceEvent(TraceEvent::IdleEnd);
+        idle = false;
+      }
+
       if (checkEmpty(wl, tld, 0)) {
         execTime.stop();
         break;
@@ -353,11 +382,15 @@ protected:
       }
 
       term.initializeThread();
-      barrier.wait();
+      tracedBarrierWait(barrier);
     }
 
+    traceEvent(TraceEvent::LoopEnd);
     if (couldAbort)
       setThreadContext(0);
+    if (needStats)
+      reportWorklistStats(wl, 0);
+    counters.stop(loopname);
   }
 
   struct T1 {};
@@ -365,8 +398,9 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(substrate::getSystemTermination(activeThreads)),
-        barrier(getBarrier(activeThreads)), wl(std::forward<WArgsTy>(wargs)...),
+      : term(substrate::getSystemTermination(galois::getActiveThreads())),
+        barrier(getBarrier(galois::getActiveThreads())),
+        wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f), loopname(galois::internal::getLoopName(args)),
         broke(false), initTime(loopname, "Init"),
         execTime(loopname, "Execute") {}
@@ -403,7 +437,7 @@ public:
 
   void operator()() {
     bool isLeader   = substrate::ThreadPool::isLeader();
-    bool couldAbort = needsAborts && activeThreads > 1;
+    bool couldAbort = needsAborts && galois::getActiveThreads() > 1;
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -450,13 +484,13 @@ void for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier      = getBarrier(activeThreads);
+  auto& barrier      = getBarrier(galois::getActiveThreads());
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
   substrate::getThreadPool().run(
-      activeThreads, [&W, &range]() { W.initThread(range); }, std::ref(barrier),
-      std::ref(W));
+      galois::getActiveThreads(), [&W, &range]() { W.initThread(range); },
+      [&barrier]() { tracedBarrierWait(barrier); }, std::ref(W));
 }
 
 // TODO: Need to decide whether user should provide num_run tag or
@@ -22,7 +22,9 @@
 
 #include "galois/config.h"
 #include "galois/gIO.h"
+#include "galois/runtime/EventTrace.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/runtime/Statistics.h"
 #include "galois/runtime/ThreadTimer.h"
 #include "galois/substrate/ThreadPool.h"
@@ -56,11 +58,20 @@ inline void on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
   OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))> fn_ref = fn;
 
   auto runFun = [&] {
+    LoopPerfCounters<NEEDS_STATS> counters;
+    counters.start();
     execTime.start();
+    if (NEEDS_STATS) {
+      traceEvent(TraceEvent::LoopBegin, 0, loopname);
+    }
 
     fn_ref(substrate::ThreadPool::getTID(), numT);
 
+    if (NEEDS_STATS) {
+      traceEvent(TraceEvent::LoopEnd);
+    }
     execTime.stop();
+    counters.stop(loopname);
   };
 
   timer.start();
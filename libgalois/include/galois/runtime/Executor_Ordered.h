@@ -17,34 +17,436 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+/**
+ * @file Executor_Ordered.h
+ *
+ * Speculative executor of galois::for_each_ordered. Iterations run in
+ * rounds over a window of the smallest pending items. A round
+ *  1. runs the neighborhood function of every item of the window, marking
+ *     each lockable it touches with the smallest item (by position in the
+ *     window) that touches it,
+ *  2. runs the operator of every item that kept all of its marks, in
+ *     parallel and out of order; the operator logs how to undo its changes
+ *     with UserContext::addUndo,
+ *  3. commits the iterations in priority order until the first one that did
+ *     not run or that comes after an item pushed by an earlier committed
+ *     one (unless the stability test says it cannot be affected anymore),
+ *  4. rolls back the iterations that ran but did not commit and returns
+ *     their items to the pending set.
+ * The window grows while whole windows commit and shrinks to about the
+ * number of commits otherwise. An item that keeps aborting when it is the only
+ * one in the window (e.g., one calling UserContext::abort) stops the program.
+ */
+
 #ifndef GALOIS_RUNTIME_EXECUTOR_ORDERED_H
 #define GALOIS_RUNTIME_EXECUTOR_ORDERED_H
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
 #include "galois/config.h"
+#include "galois/gIO.h"
+#include "galois/runtime/Context.h"
+#include "galois/runtime/Executor_OnEach.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/runtime/Substrate.h"
+#include "galois/runtime/UserContextAccess.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/Threads.h"
+#include "galois/Traits.h"
 
 namespace galois {
 namespace runtime {
 
-// TODO(ddn): Pull in and integrate in executors from exp
+namespace internal {
+
+//! One iteration of a round; its address is its mark on lockables
+template <typename T>
+class OrderedTask : public SimpleRuntimeContext {
+public:
+  T item;
+  //! position in the window, smaller runs first
+  size_t rank;
+  bool inspecting;
+  bool notReady;
+  bool executed;
+  bool committed;
+  //! index of the smallest push, pushes.size() if none
+  size_t minPush;
+  std::vector<T> pushes;
+  typename UserContextAccess<T>::UndoLogTy undoLog;
+
+  OrderedTask() : SimpleRuntimeContext(true) {}
+
+  void reset(const T& v, size_t r) {
+    item       = v;
+    rank       = r;
+    inspecting = false;
+    notReady   = false;
+    executed   = false;
+    committed  = false;
+    minPush    = 0;
+    pushes.clear();
+    undoLog.clear();
+  }
+
+  void rollback() {
+    for (auto ii = undoLog.rbegin(), ei = undoLog.rend(); ii != ei; ++ii) {
+      (*ii)();
+    }
+    undoLog.clear();
+  }
+
+protected:
+  virtual void subAcquire(Lockable* lockable, galois::MethodFlag) {
+    if (inspecting) {
+      mark(lockable);
+    } else {
+      take(lockable);
+    }
+  }
+
+  //! Marks lockable unless an earlier iteration has; steals later marks
+  void mark(Lockable* lockable) {
+    OrderedTask* other;
+    while ((other = static_cast<OrderedTask*>(getOwner(lockable))) != this) {
+      if (!other) {
+        if (this->tryLockAndSetOwner(lockable)) {
+          this->addToNhood(lockable);
+          return;
+        }
+      } else if (other->rank < rank) {
+        notReady = true;
+        return;
+      } else if (this->stealByCAS(lockable, other)) {
+        other->notReady = true;
+        return;
+      }
+    }
+  }
+
+  //! Lockables outside of the neighborhood are only free if unmarked
+  void take(Lockable* lockable) {
+    OrderedTask* other;
+    while ((other = static_cast<OrderedTask*>(getOwner(lockable))) != this) {
+      if (other) {
+        signalConflict(lockable);
+      }
+      if (this->tryLockAndSetOwner(lockable)) {
+        this->addToNhood(lockable);
+        return;
+      }
+    }
+  }
+};
+
+//! Stability test of stable-source algorithms: sources stay sources
+struct NoStabilityTest {
+  template <typename T>
+  bool operator()(const T&) const {
+    return false;
+  }
+};
+
+template <typename T, typename Cmp, typename NhFunc, typename OpFunc,
+          typename StableTest>
+class OrderedExecutor {
+  using Task = OrderedTask<T>;
+
+  //! tasks are handed out in chunks of this many
+  static const size_t ChunkSize = 8;
+  static const size_t MaxWindow = 1 << 16;
+  //! rounds in a row an item may fail alone before the loop gives up
+  static constexpr size_t MaxSoloAborts = 64;
+
+  struct HeapCmp {
+    const Cmp& cmp;
+    //! std heaps keep the largest element on top
+    bool operator()(const T& a, const T& b) const { return cmp(b, a); }
+  };
+
+  const Cmp& cmp;
+  const NhFunc& nhFunc;
+  const OpFunc& opFunc;
+  const StableTest& stabilityTest;
+  const char* loopname;
+
+  substrate::Barrier& barrier;
+  substrate::PerThreadStorage<UserContextAccess<T>> facing;
+  bool broke = false;
+
+  //! items not in the current window, as a heap
+  std::vector<T> pending;
+  std::deque<Task> tasks;
+  size_t numTasks = 0;
+  size_t window;
+  size_t minWindow;
+  //! rounds in a row whose window of one item did not commit
+  size_t soloAborts = 0;
+
+  std::atomic<size_t> nextInspect;
+  std::atomic<size_t> nextExecute;
+  std::atomic<size_t> nextFinish;
+
+  size_t rounds     = 0;
+  size_t iterations = 0;
+  size_t commits    = 0;
+  size_t rollbacks  = 0;
+  size_t pushes     = 0;
+
+  template <typename F>
+  void forEachTask(std::atomic<size_t>& next, const F& fn) {
+    size_t b;
+    while ((b = next.fetch_add(ChunkSize)) < numTasks) {
+      for (size_t i = b, e = std::min(numTasks, b + ChunkSize); i < e; ++i) {
+        fn(tasks[i]);
+      }
+    }
+  }
+
+  //! Moves the smallest pending items into the window
+  void beginRound() {
+    numTasks = std::min(window, pending.size());
+    while (tasks.size() < numTasks) {
+      tasks.emplace_back();
+    }
+    for (size_t i = 0; i < numTasks; ++i) {
+      std::pop_heap(pending.begin(), pending.end(), HeapCmp{cmp});
+      tasks[i].reset(pending.back(), i);
+      pending.pop_back();
+    }
+    nextInspect = 0;
+    nextExecute = 0;
+    nextFinish  = 0;
+  }
+
+  void inspect(Task& task) {
+    setThreadContext(&task);
+    task.inspecting = true;
+    nhFunc(task.item);
+    task.inspecting = false;
+    setThreadContext(nullptr);
+  }
+
+  void execute(Task& task, UserContextAccess<T>& uctx) {
+    if (task.notReady) {
+      return;
+    }
+    setThreadContext(&task);
+    int result = 0;
+#ifdef GALOIS_USE_LONGJMP_ABORT
+    if ((result = setjmp(execFrame)) == 0) {
+#elif defined(GALOIS_USE_EXCEPTION_ABORT)
+    try {
+#endif
+      opFunc(task.item, uctx.data());
+#ifdef GALOIS_USE_LONGJMP_ABORT
+    } else {
+      clearConflictLock();
+    }
+#elif defined(GALOIS_USE_EXCEPTION_ABORT)
+    } catch (const ConflictFlag& flag) {
+      clearConflictLock();
+      result = flag;
+    }
+#endif
+    setThreadContext(nullptr);
+
+    switch (result) {
+    case 0:
+      break;
+    case CONFLICT:
+      break;
+    default:
+      GALOIS_DIE("unknown conflict flag");
+      break;
+    }
+
+    task.undoLog.swap(uctx.getUndoLog());
+    uctx.getUndoLog().clear();
+    auto& pb = uctx.getPushBuffer();
+    if (result == 0) {
+      task.executed = true;
+      task.pushes.assign(pb.begin(), pb.end());
+      task.minPush = std::min_element(task.pushes.begin(), task.pushes.end(),
+                                      cmp) -
+                     task.pushes.begin();
+    } else {
+      task.rollback();
+    }
+    uctx.resetPushBuffer();
+    uctx.resetAlloc();
+  }
+
+  //! Commits the longest prefix of the window that is in priority order
+  void decideCommits() {
+    const T* minPushed = nullptr;
+    bool inOrder       = true;
+    for (size_t i = 0; i < numTasks; ++i) {
+      Task& task = tasks[i];
+      if (!task.executed) {
+        inOrder = false;
+        continue;
+      }
+      task.committed =
+          (inOrder && !(minPushed && cmp(*minPushed, task.item))) ||
+          stabilityTest(task.item);
+      if (!task.committed) {
+        inOrder = false;
+        continue;
+      }
+      if (task.minPush < task.pushes.size() &&
+          (!minPushed || cmp(task.pushes[task.minPush], *minPushed))) {
+        minPushed = &task.pushes[task.minPush];
+      }
+    }
+  }
+
+  void finish(Task& task) {
+    if (task.executed && !task.committed) {
+      task.rollback();
+    }
+    task.commitIteration();
+  }
+
+  //! Returns new work and aborted items to the pending set
+  void endRound() {
+    size_t numCommits = 0;
+    for (size_t i = 0; i < numTasks; ++i) {
+      Task& task = tasks[i];
+      if (task.committed) {
+        ++numCommits;
+        pushes += task.pushes.size();
+        for (auto& p : task.pushes) {
+          pending.push_back(p);
+          std::push_heap(pending.begin(), pending.end(), HeapCmp{cmp});
+        }
+      } else {
+        rollbacks += task.executed;
+        pending.push_back(task.item);
+        std::push_heap(pending.begin(), pending.end(), HeapCmp{cmp});
+      }
+    }
+
+    ++rounds;
+    iterations += numTasks;
+    commits += numCommits;
+    if (numCommits > 0) {
+      soloAborts = 0;
+    }
+
+    if (numCommits == 0) {
+      // the first item only conflicts when it takes a lockable marked by a
+      // later one; alone it only fails if the operator itself aborts, which
+      // would repeat forever
+      if (numTasks == 1 && ++soloAborts == MaxSoloAborts) {
+        GALOIS_DIE("iteration of ", loopname, " aborted ", MaxSoloAborts,
+                   " times while running alone");
+      }
+      window = 1;
+    } else if (numCommits == numTasks) {
+      window = std::min(MaxWindow, std::max(minWindow, 2 * window));
+    } else {
+      window = std::max(minWindow, numCommits + numCommits / 4);
+    }
+  }
+
+public:
+  OrderedExecutor(const Cmp& c, const NhFunc& nh, const OpFunc& op,
+                  const StableTest& st, const char* ln)
+      : cmp(c), nhFunc(nh), opFunc(op), stabilityTest(st),
+        loopname(ln ? ln : "ANON_LOOP"),
+        barrier(getBarrier(galois::getActiveThreads())) {
+    minWindow = galois::getActiveThreads();
+    window    = 4 * minWindow;
+  }
+
+  template <typename Iter>
+  void initialize(Iter b, Iter e) {
+    pending.assign(b, e);
+    std::make_heap(pending.begin(), pending.end(), HeapCmp{cmp});
+  }
+
+  void operator()() {
+    bool master = substrate::ThreadPool::getTID() == 0;
+    UserContextAccess<T>& uctx = *facing.getLocal();
+    uctx.setBreakFlag(&broke);
+    uctx.setLogUndo(true);
+
+    while (true) {
+      if (master) {
+        beginRound();
+      }
+      barrier.wait();
+      if (numTasks == 0) {
+        break;
+      }
+
+      forEachTask(nextInspect, [&](Task& t) { inspect(t); });
+      barrier.wait();
+      forEachTask(nextExecute, [&](Task& t) { execute(t, uctx); });
+      barrier.wait();
+      if (master) {
+        decideCommits();
+      }
+      barrier.wait();
+      forEachTask(nextFinish, [&](Task& t) { finish(t); });
+      barrier.wait();
+      if (master) {
+        endRound();
+      }
+    }
+
+    uctx.setLogUndo(false);
+  }
+
+  void reportStats() {
+    reportStat_Single(loopname, "Rounds", rounds);
+    reportStat_Single(loopname, "Iterations", iterations);
+    reportStat_Single(loopname, "Commits", commits);
+    reportStat_Single(loopname, "RolledBack", rollbacks);
+    reportStat_Single(loopname, "Pushes", pushes);
+  }
+};
+
+template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc,
+          typename StableTest>
+void for_each_ordered_spec(Iter beg, Iter end, const Cmp& cmp,
+                           const NhFunc& nhFunc, const OpFunc& opFunc,
+                           const StableTest& stabilityTest,
+                           const char* loopname) {
+  using T = typename std::iterator_traits<Iter>::value_type;
+  OrderedExecutor<T, Cmp, NhFunc, OpFunc, StableTest> e(
+      cmp, nhFunc, opFunc, stabilityTest, loopname);
+  e.initialize(beg, end);
+  on_each_gen([&](unsigned, unsigned) { e(); },
+              std::make_tuple(galois::loopname(loopname)));
+  e.reportStats();
+}
+
+} // namespace internal
 
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
-void for_each_ordered_impl(Iter GALOIS_UNUSED(beg), Iter GALOIS_UNUSED(end),
-                           const Cmp& GALOIS_UNUSED(cmp),
-                           const NhFunc& GALOIS_UNUSED(nhFunc),
-                           const OpFunc& GALOIS_UNUSED(opFunc),
-                           const char* GALOIS_UNUSED(loopname)) {
-  GALOIS_DIE("not yet implemented");
+void for_each_ordered_impl(Iter beg, Iter end, const Cmp& cmp,
+                           const NhFunc& nhFunc, const OpFunc& opFunc,
+                           const char* loopname) {
+  internal::for_each_ordered_spec(beg, end, cmp, nhFunc, opFunc,
+                                  internal::NoStabilityTest(), loopname);
 }
 
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc,
           typename StableTest>
-void for_each_ordered_impl(Iter GALOIS_UNUSED(beg), Iter GALOIS_UNUSED(end),
-                           const Cmp& GALOIS_UNUSED(cmp),
-                           const NhFunc& GALOIS_UNUSED(nhFunc),
-                           const OpFunc& GALOIS_UNUSED(opFunc),
-                           const StableTest& GALOIS_UNUSED(stabilityTest),
-                           const char* GALOIS_UNUSED(loopname)) {
-  GALOIS_DIE("not yet implemented");
+void for_each_ordered_impl(Iter beg, Iter end, const Cmp& cmp,
+                           const NhFunc& nhFunc, const OpFunc& opFunc,
+                           const StableTest& stabilityTest,
+                           const char* loopname) {
+  internal::for_each_ordered_spec(beg, end, cmp, nhFunc, opFunc,
+                                  stabilityTest, loopname);
 }
 
 } // end namespace runtime
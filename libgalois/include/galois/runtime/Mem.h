@@ -31,6 +31,7 @@
 #include <boost/utility.hpp>
 
 #include "galois/config.h"
+#include "galois/Threads.h"
 #include "galois/gIO.h"
 #include "galois/runtime/PagePool.h"
 #include "galois/substrate/CacheLineStorage.h"
@@ -42,12 +43,20 @@
 namespace galois {
 namespace runtime {
 
-extern unsigned activeThreads;
-
 //! Memory management functionality.
 
 void preAlloc_impl(unsigned num);
 
+/**
+ * Preallocates one page per thread plus enough pages for bytes of heap data,
+ * but not more than the available memory of the host (MemAvailable, which
+ * counts reclaimable page cache). The total is rounded to a multiple of the
+ * number of active threads, which all get the same share.
+ *
+ * @returns number of pages preallocated
+ */
+unsigned preAllocBytes(size_t bytes);
+
 // const size_t hugePageSize = 2*1024*1024;
 
 //! Preallocate numpages large pages for each thread
@@ -439,6 +448,122 @@ public:
   inline void deallocate(void*) {}
 };
 
+/**
+ * Bump pointer allocation through chunks of memory that can be rewound to
+ * an earlier checkpoint, releasing everything allocated since in O(1).
+ * Chunks are kept after a rewind and bumped through again by the following
+ * allocations, so a heap that is rewound after every loop iteration stops
+ * asking SourceHeap for memory once it has grown to the largest iteration.
+ * Allocations that do not fit in a chunk fall back to malloc and are freed
+ * by the rewind.
+ *
+ * Counts the bytes it hands out and the number of rewinds.
+ */
+template <typename SourceHeap>
+class ArenaHeap : public SourceHeap {
+  struct Block {
+    Block* next;
+  };
+
+  static constexpr size_t ALIGN  = alignof(std::max_align_t);
+  static constexpr size_t HEADER = (sizeof(Block) + ALIGN - 1) & ~(ALIGN - 1);
+
+  //! chunks in the order they were first used
+  Block* first;
+  Block* current;
+  size_t offset;
+  //! malloc fallback allocations, newest first
+  Block* large;
+
+  size_t served;
+  size_t rewinds;
+
+  void nextBlock() {
+    Block* B = current ? current->next : first;
+    if (!B) {
+      B       = (Block*)SourceHeap::allocate(SourceHeap::AllocSize);
+      B->next = nullptr;
+      if (current) {
+        current->next = B;
+      } else {
+        first = B;
+      }
+    }
+    current = B;
+    offset  = HEADER;
+  }
+
+public:
+  enum { AllocSize = 0 };
+
+  //! Position of the bump pointer as returned by checkpoint
+  struct Checkpoint {
+    Block* block;
+    size_t offset;
+    Block* large;
+  };
+
+  ArenaHeap()
+      : SourceHeap(), first(nullptr), current(nullptr), offset(0),
+        large(nullptr), served(0), rewinds(0) {}
+
+  ~ArenaHeap() { clear(); }
+
+  inline void* allocate(size_t size) {
+    size_t alignedSize = (size + ALIGN - 1) & ~(ALIGN - 1);
+    served += alignedSize;
+    if (HEADER + alignedSize > SourceHeap::AllocSize) {
+      Block* B = (Block*)malloc(HEADER + alignedSize);
+      if (!B) {
+        throw std::bad_alloc();
+      }
+      B->next = large;
+      large   = B;
+      return (char*)B + HEADER;
+    }
+    if (!current || offset + alignedSize > SourceHeap::AllocSize) {
+      nextBlock();
+    }
+    char* retval = (char*)current + offset;
+    offset += alignedSize;
+    return retval;
+  }
+
+  inline void deallocate(void*) {}
+
+  Checkpoint checkpoint() const { return Checkpoint{current, offset, large}; }
+
+  //! Frees everything allocated after c was taken
+  void rewind(const Checkpoint& c) {
+    while (large != c.large) {
+      Block* B = large;
+      large    = B->next;
+      free(B);
+    }
+    current = c.block;
+    offset  = c.offset;
+    ++rewinds;
+  }
+
+  //! Frees everything but keeps the chunks for reuse
+  void reset() { rewind(Checkpoint{nullptr, 0, nullptr}); }
+
+  //! Frees everything and returns the chunks to SourceHeap
+  void clear() {
+    reset();
+    while (first) {
+      Block* B = first;
+      first    = B->next;
+      SourceHeap::deallocate(B);
+    }
+  }
+
+  //! Bytes allocated so far, including alignment
+  size_t bytesServed() const { return served; }
+  //! Number of rewinds and resets so far
+  size_t numRewinds() const { return rewinds; }
+};
+
 /**
  * This implements a bump pointer though chunks of memory that falls back
  * to malloc if the source heap cannot accommodate an allocation.
@@ -682,7 +807,8 @@ public:
   enum { AllocSize = 0 };
 
   void* allocate(size_t size) {
-    auto ptr = substrate::largeMallocInterleaved(size + offset, activeThreads);
+    auto ptr = substrate::largeMallocInterleaved(size + offset,
+                                                 galois::getActiveThreads());
     substrate::LAptr* header =
         new ((char*)ptr.get()) substrate::LAptr{std::move(ptr)};
     return (char*)(header->get()) + offset;
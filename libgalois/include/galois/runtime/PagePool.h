@@ -30,6 +30,7 @@
 #include "galois/config.h"
 #include "galois/gIO.h"
 #include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/SimpleLock.h"
 #include "galois/substrate/PageAlloc.h"
 #include "galois/substrate/PtrLock.h"
@@ -73,7 +74,9 @@ class PageAllocState {
   void* allocFromOS() {
     void* ptr = galois::substrate::allocPages(1, true);
     assert(ptr);
-    auto tid = galois::substrate::ThreadPool::getTID();
+    galois::substrate::memAccountAlloc(galois::substrate::MemCategory::PagePool,
+                                       galois::substrate::allocSize());
+    auto tid = galois::substrate::ThreadPool::getMachineTID();
     counts[tid] += 1;
     std::lock_guard<galois::substrate::SimpleLock> lg(mapLock);
     ownerMap[ptr] = tid;
@@ -94,7 +97,7 @@ public:
   }
 
   void* pageAlloc() {
-    auto tid    = galois::substrate::ThreadPool::getTID();
+    auto tid    = galois::substrate::ThreadPool::getMachineTID();
     HeadPtr& hp = pool[tid].data;
     if (hp.getValue()) {
       hp.lock();
@@ -0,0 +1,111 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file PerfCounters.h
+ *
+ * Hardware counters per loop using Linux perf_event_open, which needs no
+ * extra libraries. Setting the environment variable GALOIS_PERF_COUNTERS
+ * makes every thread count cycles, instructions, last-level cache misses,
+ * dTLB misses, remote DRAM loads and page faults, and every named loop
+ * report what each thread counted while running it as TSUM stats (e.g.,
+ * "Cycles" of region "BFS"). Counters the kernel or hardware does not
+ * provide are left out. Remote DRAM loads use the generic NUMA node miss
+ * event unless GALOIS_PERF_REMOTE_DRAM_EVENT gives a raw event code (hex).
+ * Counting is restricted to user space so that it works with the default
+ * perf_event_paranoid setting.
+ */
+
+#ifndef GALOIS_RUNTIME_PERFCOUNTERS_H
+#define GALOIS_RUNTIME_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "galois/config.h"
+
+namespace galois::runtime {
+
+namespace internal {
+
+constexpr unsigned MAX_PERF_COUNTERS = 8;
+
+struct PerfSample {
+  bool valid;
+  uint64_t enabled; //!< time the counters were enabled
+  uint64_t running; //!< time the counters were on the PMU
+  uint64_t values[MAX_PERF_COUNTERS];
+};
+
+extern bool perfCountersOn;
+
+//! Reads the counters of the calling thread, opening them on first use
+void readPerfCounters(PerfSample& sample);
+
+//! Reports the difference between two samples of the calling thread
+void reportPerfCounters(const char* region, const PerfSample& begin,
+                        const PerfSample& end);
+
+//! Starts counting if GALOIS_PERF_COUNTERS is set
+void initPerfCounters();
+void finishPerfCounters();
+
+} // namespace internal
+
+//! Names of the counters that could be opened, empty if counting is off
+std::vector<std::string> perfCounterNames();
+
+/**
+ * Counters of one thread over one loop. start and stop are called by the
+ * thread running the loop.
+ */
+template <bool Enabled>
+class LoopPerfCounters {
+  internal::PerfSample begin;
+
+public:
+  LoopPerfCounters() { begin.valid = false; }
+
+  void start() {
+    if (internal::perfCountersOn) {
+      internal::readPerfCounters(begin);
+    }
+  }
+
+  void stop(const char* region) {
+    if (internal::perfCountersOn && begin.valid) {
+      internal::PerfSample end;
+      internal::readPerfCounters(end);
+      internal::reportPerfCounters(region, begin, end);
+    }
+  }
+};
+
+template <>
+class LoopPerfCounters<false> {
+public:
+  void start() const {}
+
+  void stop(const char*) const {}
+};
+
+} // namespace galois::runtime
+
+#endif
@@ -23,7 +23,9 @@
 #include <string>
 
 #include "galois/config.h"
+#include "galois/runtime/EventTrace.h"
 #include "galois/runtime/PagePool.h"
+#include "galois/runtime/PerfCounters.h"
 #include "galois/runtime/Statistics.h"
 #include "galois/substrate/SharedMem.h"
 
@@ -38,10 +40,15 @@ public:
   explicit SharedMem() : m_pa(), m_sm() {
     internal::setPagePoolState(&m_pa);
     internal::setSysStatManager(&m_sm);
+    internal::initEventTrace();
+    internal::initPerfCounters();
   }
 
   ~SharedMem() {
+    reportMemUsage("MemoryUsage");
     m_sm.print();
+    internal::finishEventTrace();
+    internal::finishPerfCounters();
     internal::setSysStatManager(nullptr);
     internal::setPagePoolState(nullptr);
   }
@@ -341,6 +341,8 @@ public:
   static constexpr const char* const TSTAT_SEP     = "; ";
   static constexpr const char* const TSTAT_NAME    = "ThreadValues";
   static constexpr const char* const TSTAT_ENV_VAR = "PRINT_PER_THREAD_STATS";
+  //! names a file to which print() also writes the stats as JSON
+  static constexpr const char* const JSON_ENV_VAR = "GALOIS_STATS_JSON";
 
   static bool printingThreadVals(void);
 
@@ -413,6 +415,8 @@ private:
       thrdVals = this->stat(i).values();
     }
 
+    void printJSON(std::ostream& out, const char*& sep) const;
+
     void print(std::ostream& out) const {
 
       for (auto i = cbegin(), end_i = cend(); i != end_i; ++i) {
@@ -502,6 +506,13 @@ public:
 
   void setStatFile(const std::string& outfile);
 
+  /**
+   * Writes the stats of this host as a JSON object with a "stats" array;
+   * each entry has kind, region, category, totalType, total and
+   * threadValues.
+   */
+  void printStatsJSON(std::ostream& out);
+
   template <typename S1, typename S2, typename T,
             typename = std::enable_if_t<std::is_integral<T>::value ||
                                         std::is_floating_point<T>::value>>
@@ -629,6 +640,14 @@ void reportRUsage(const std::string& id);
 void reportPageAlloc(const char* category);
 //! Reports NUMA memory stats for all NUMA nodes
 void reportNumaAlloc(const char* category);
+//! Reports the peak number of bytes of every memory category (see
+//! substrate::MemCategory) and of all categories under region
+void reportMemUsage(const char* region);
+//! Reports how many parallel sections each thread joined since the last call
+//! ("Wakeups"), how often it had blocked before ("Sleeps") and how long it
+//! took to start working ("WakeupLatencyNs", "MaxWakeupLatencyNs") under
+//! region
+void reportWakeupStats(const char* region);
 
 } // end namespace runtime
 } // end namespace galois
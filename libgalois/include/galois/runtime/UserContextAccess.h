@@ -33,6 +33,7 @@ public:
   typedef galois::UserContext<T> SuperTy;
   typedef typename SuperTy::PushBufferTy PushBufferTy;
   typedef typename SuperTy::FastPushBack FastPushBack;
+  typedef typename SuperTy::UndoLogTy UndoLogTy;
 
   void resetAlloc() { SuperTy::__resetAlloc(); }
   PushBufferTy& getPushBuffer() { return SuperTy::__getPushBuffer(); }
@@ -40,6 +41,8 @@ public:
   SuperTy& data() { return *static_cast<SuperTy*>(this); }
   void setLocalState(void* p) { SuperTy::__setLocalState(p); }
   void setFastPushBack(FastPushBack f) { SuperTy::__setFastPushBack(f); }
+  UndoLogTy& getUndoLog() { return SuperTy::__getUndoLog(); }
+  void setLogUndo(bool b) { SuperTy::__setLogUndo(b); }
   void setBreakFlag(bool* b) {
     SuperTy::didBreak = b;
   } // NOLINT(readability-non-const-parameter)
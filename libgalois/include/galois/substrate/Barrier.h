@@ -22,6 +22,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "galois/config.h"
 #include "galois/gIO.h"
@@ -77,16 +78,34 @@ template <typename _UNUSED = void>
 struct BarrierInstance {
   unsigned m_num_threads;
   std::unique_ptr<Barrier> m_barrier;
+  //! barrier of each sub-pool, by its first thread
+  std::vector<unsigned> m_pool_num_threads;
+  std::vector<std::unique_ptr<Barrier>> m_pool_barriers;
 
   BarrierInstance(void) {
     m_num_threads = getThreadPool().getMaxThreads();
     m_barrier     = createTopoBarrier(m_num_threads);
+    m_pool_num_threads.resize(m_num_threads);
+    m_pool_barriers.resize(m_num_threads);
   }
 
   Barrier& get(unsigned numT) {
     GALOIS_ASSERT(numT > 0,
                   "substrate::getBarrier() number of threads must be > 0");
 
+    if (ThreadPool::inSubPool()) {
+      numT = std::min(numT, getThreadPool().getPoolSize());
+      unsigned base = ThreadPool::getPoolBase();
+      auto& b       = m_pool_barriers[base];
+      if (!b) {
+        b = createTopoBarrier(numT);
+      } else if (numT != m_pool_num_threads[base]) {
+        b->reinit(numT);
+      }
+      m_pool_num_threads[base] = numT;
+      return *b;
+    }
+
     numT = std::min(numT, getThreadPool().getMaxUsableThreads());
     numT = std::max(numT, 1u);
 
@@ -0,0 +1,69 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_SUBSTRATE_MEMACCOUNTING_H
+#define GALOIS_SUBSTRATE_MEMACCOUNTING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "galois/config.h"
+
+namespace galois {
+namespace substrate {
+
+/**
+ * Kinds of memory counted by the memory accounting. WorklistChunks are
+ * carved out of PagePool pages and are not part of the total.
+ */
+enum class MemCategory : unsigned {
+  LargeArrays,    //!< largeMalloc* allocations, e.g., graph arrays
+  PagePool,       //!< pages taken from the OS for the per-thread heaps
+  WorklistChunks, //!< chunks of the chunked worklists
+  CommBuffers,    //!< network send and receive buffers
+  NumCategories
+};
+
+//! Name of c as used in statistics
+const char* memCategoryName(MemCategory c);
+
+/**
+ * Counts bytes as allocated for c. Threads collect small changes locally and
+ * publish them once they add up to 1 MB, so the counts may miss up to 1 MB
+ * per thread and category.
+ */
+void memAccountAlloc(MemCategory c, size_t bytes);
+//! Counts bytes allocated for c as freed
+void memAccountFree(MemCategory c, size_t bytes);
+
+//! Bytes currently allocated for c
+int64_t memCurrentBytes(MemCategory c);
+//! Largest number of bytes allocated for c at any time since the last reset
+int64_t memPeakBytes(MemCategory c);
+//! Bytes currently allocated for all categories
+int64_t memTotalCurrentBytes();
+//! Largest number of bytes allocated for all categories at any time
+int64_t memTotalPeakBytes();
+//! Sets all peaks to the current values
+void resetMemPeaks();
+
+} // namespace substrate
+} // namespace galois
+
+#endif // GALOIS_SUBSTRATE_MEMACCOUNTING_H
@@ -137,26 +137,28 @@ public:
 
   //! Like getLocal() but optimized for when you already know the thread id
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getPoolBase() + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getPoolBase() + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
+  //! Slot of thread of the current sub-pool (see ThreadPool::runSubPools)
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getPoolBase() + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getPoolBase() + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
-  unsigned size() const { return getThreadPool().getMaxThreads(); }
+  //! Number of slots seen from the current sub-pool
+  unsigned size() const { return getThreadPool().getPoolSize(); }
 };
 
 template <typename T>
@@ -168,7 +170,8 @@ protected:
   void destruct() {
     auto& tp = getThreadPool();
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n)
-      reinterpret_cast<T*>(b.getRemote(tp.getLeaderForSocket(n), offset))->~T();
+      reinterpret_cast<T*>(b.getRemote(tp.getMachineLeaderForSocket(n), offset))
+          ->~T();
     b.deallocOffset(offset, sizeof(T));
   }
 
@@ -182,7 +185,7 @@ public:
     offset   = b.allocOffset(sizeof(T));
     auto& tp = getThreadPool();
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n)
-      new (b.getRemote(tp.getLeaderForSocket(n), offset))
+      new (b.getRemote(tp.getMachineLeaderForSocket(n), offset))
           T(std::forward<Args>(args)...);
   }
 
@@ -211,36 +214,35 @@ public:
 
   //! Like getLocal() but optimized for when you already know the thread id
   T* getLocal(unsigned int thread) {
-    void* ditem = b.getLocal(offset, thread);
+    void* ditem = b.getLocal(offset, ThreadPool::getPoolBase() + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b.getLocal(offset, thread);
+    void* ditem = b.getLocal(offset, ThreadPool::getPoolBase() + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemote(unsigned int thread) {
-    void* ditem = b.getRemote(thread, offset);
+    void* ditem = b.getRemote(ThreadPool::getPoolBase() + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b.getRemote(thread, offset);
+    void* ditem = b.getRemote(ThreadPool::getPoolBase() + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
+  // every thread of a socket shares the slot of the socket
   T* getRemoteByPkg(unsigned int pkg) {
-    void* ditem = b.getRemote(getThreadPool().getLeaderForSocket(pkg), offset);
-    return reinterpret_cast<T*>(ditem);
+    return getRemote(getThreadPool().getLeaderForSocket(pkg));
   }
 
   const T* getRemoteByPkg(unsigned int pkg) const {
-    void* ditem = b.getRemote(getThreadPool().getLeaderForSocket(pkg), offset);
-    return reinterpret_cast<T*>(ditem);
+    return getRemote(getThreadPool().getLeaderForSocket(pkg));
   }
 
-  unsigned size() const { return getThreadPool().getMaxThreads(); }
+  unsigned size() const { return getThreadPool().getPoolSize(); }
 };
 
 } // namespace substrate
@@ -127,6 +127,13 @@ public:
     uintptr_t old = 1 | (uintptr_t)oldval;
     return _lock.compare_exchange_strong(old, 1 | (uintptr_t)newval);
   }
+
+  //! CAS from an unlocked oldval that leaves newval locked
+  inline bool CAS_and_lock(T* oldval, T* newval) {
+    assert(!((uintptr_t)oldval & 1) && !((uintptr_t)newval & 1));
+    uintptr_t old = (uintptr_t)oldval;
+    return _lock.compare_exchange_strong(old, 1 | (uintptr_t)newval);
+  }
 };
 
 template <typename T>
@@ -152,6 +159,7 @@ public:
     return false;
   }
   inline bool stealing_CAS(T* oldval, T* newval) { return CAS(oldval, newval); }
+  inline bool CAS_and_lock(T* oldval, T* newval) { return CAS(oldval, newval); }
 };
 
 } // end namespace substrate
@@ -21,6 +21,8 @@
 #define GALOIS_SUBSTRATE_TERMINATION_H
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #include "galois/config.h"
 #include "galois/substrate/PerThreadStorage.h"
@@ -254,7 +256,185 @@ public:
   }
 };
 
+/**
+ * Two-level termination detection that follows the socket topology. Rounds
+ * are run by thread 0: every thread acknowledges a round on a counter of
+ * its socket the next time it is idle, and the first thread of each socket
+ * reports the socket to thread 0 on a global counter once all its threads
+ * have. A thread taints (blackens) its acknowledgment if it did work since
+ * its previous one. As with the token ring, two clean rounds in a row mean
+ * global termination, but the threads of a socket acknowledge in parallel
+ * and only one thread per socket touches cross-socket cache lines, so
+ * detection takes a few cache misses per socket instead of a token hop per
+ * thread.
+ */
+template <typename _UNUSED = void>
+class HierarchicalTerminationDetection : public TerminationDetection {
+
+  struct SocketState {
+    //! round the threads of the socket acknowledge
+    std::atomic<unsigned> round;
+    //! threads that still have to acknowledge round
+    std::atomic<unsigned> pending;
+    //! some thread did work during round
+    std::atomic<bool> isBlack;
+    unsigned size;
+    // only used by the first thread of the socket
+    unsigned globalRound;
+    unsigned reported;
+  };
+
+  struct ThreadState {
+    unsigned acked;
+    bool processIsBlack;
+    bool lastWasWhite; // only used by the master
+  };
+
+  PerSocketStorage<SocketState> sockets;
+  PerThreadStorage<ThreadState> data;
+
+  CacheLineStorage<std::atomic<unsigned>> globalRound;
+  CacheLineStorage<std::atomic<unsigned>> globalPending;
+  CacheLineStorage<std::atomic<bool>> globalIsBlack;
+
+  unsigned numSockets;
+
+  bool isSysMaster() const { return ThreadPool::getTID() == 0; }
+
+  //! first thread of a socket: starts the socket's part of a new round
+  void startSocketRound(SocketState& ss) {
+    unsigned g = globalRound.data.load(std::memory_order_acquire);
+    if (g == ss.globalRound) {
+      return;
+    }
+    ss.globalRound = g;
+    ss.isBlack.store(false, std::memory_order_relaxed);
+    ss.pending.store(ss.size, std::memory_order_relaxed);
+    ss.round.store(g, std::memory_order_release);
+  }
+
+  //! first thread of a socket: reports the socket once all threads acked
+  void reportSocket(SocketState& ss) {
+    if (ss.reported == ss.globalRound ||
+        ss.pending.load(std::memory_order_acquire)) {
+      return;
+    }
+    ss.reported = ss.globalRound;
+    if (ss.isBlack.load(std::memory_order_relaxed)) {
+      globalIsBlack.data.store(true, std::memory_order_relaxed);
+    }
+    globalPending.data.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  //! master: decides on a finished round and starts the next one
+  void finishRound(ThreadState& th) {
+    if (globalPending.data.load(std::memory_order_acquire)) {
+      return;
+    }
+    bool black = globalIsBlack.data.load(std::memory_order_relaxed);
+    if (th.lastWasWhite && !black) {
+      // This was the second success
+      globalTerm = true;
+      return;
+    }
+    th.lastWasWhite = !black;
+    globalIsBlack.data.store(false, std::memory_order_relaxed);
+    globalPending.data.store(numSockets, std::memory_order_relaxed);
+    globalRound.data.fetch_add(1, std::memory_order_release);
+  }
+
+protected:
+  virtual void init(unsigned aThreads) {
+    auto& tp   = getThreadPool();
+    numSockets = tp.getCumulativeMaxSocket(aThreads - 1) + 1;
+    for (unsigned i = 0; i < numSockets; ++i) {
+      sockets.getRemoteByPkg(i)->size = 0;
+    }
+    for (unsigned i = 0; i < aThreads; ++i) {
+      ++sockets.getRemoteByPkg(tp.getSocket(i))->size;
+    }
+  }
+
+public:
+  HierarchicalTerminationDetection() : numSockets(0) {}
+
+  // the state of a socket is reset by its first thread and the global state
+  // by the master; callers wait on a barrier before localTermination
+  virtual void initializeThread() {
+    ThreadState& th   = *data.getLocal();
+    th.acked          = 0;
+    th.processIsBlack = true;
+    th.lastWasWhite   = false;
+    globalTerm        = false;
+    if (ThreadPool::isLeader()) {
+      SocketState& ss = *sockets.getLocal();
+      ss.round        = 1;
+      ss.pending      = ss.size;
+      ss.isBlack      = false;
+      ss.globalRound  = 1;
+      ss.reported     = 0;
+    }
+    if (isSysMaster()) {
+      globalRound   = 1;
+      globalPending = numSockets;
+      globalIsBlack = false;
+    }
+  }
+
+  virtual void localTermination(bool workHappened) {
+    assert(!(workHappened && globalTerm.get()));
+    ThreadState& th = *data.getLocal();
+    th.processIsBlack |= workHappened;
+
+    SocketState& ss = *sockets.getLocal();
+    bool leader     = ThreadPool::isLeader();
+    if (leader) {
+      startSocketRound(ss);
+    }
+
+    unsigned r = ss.round.load(std::memory_order_acquire);
+    if (r != th.acked) {
+      th.acked = r;
+      if (th.processIsBlack) {
+        ss.isBlack.store(true, std::memory_order_relaxed);
+        th.processIsBlack = false;
+      }
+      ss.pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    if (leader) {
+      reportSocket(ss);
+      if (isSysMaster()) {
+        finishRound(th);
+      }
+    }
+  }
+};
+
 void setTermDetect(TerminationDetection* term);
+
+//! Termination detection selected by GALOIS_TERMINATION (ring, tree or
+//! hierarchical, the default)
+std::unique_ptr<TerminationDetection> makeTerminationDetection();
+
+//! Termination detection of each sub-pool, by its first thread (see
+//! ThreadPool::runSubPools)
+template <typename _UNUSED = void>
+struct SubPoolTermination {
+  std::vector<std::unique_ptr<TerminationDetection>> terms;
+
+  SubPoolTermination() : terms(getThreadPool().getMaxThreads()) {}
+
+  TerminationDetection& get(unsigned base) {
+    auto& t = terms[base];
+    if (!t) {
+      t = makeTerminationDetection();
+    }
+    return *t;
+  }
+};
+
+void setSubPoolTermDetect(SubPoolTermination<>* terms);
 } // end namespace internal
 
 } // namespace substrate
@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
@@ -50,51 +51,65 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 
 namespace galois::substrate {
 
+//! How threads wait for work between parallel sections
+enum class IdlePolicy {
+  Sleep,  //!< block in the kernel right away; cheapest, slowest to wake up
+  Spin,   //!< busy wait; fastest to wake up, keeps cores busy
+  Hybrid, //!< spin for a short window, then block
+};
+
 class ThreadPool {
   friend class SharedMem;
 
 protected:
   struct shutdown_ty {}; //! type for shutting down thread
-  struct fastmode_ty {
-    bool mode;
-  }; //! type for setting fastmode
   struct dedicated_ty {
     std::function<void(void)> fn;
   }; //! type to switch to dedicated mode
 
+  //! Threads [base, base + size) running loops on their own; see runSubPools
+  struct SubPool {
+    unsigned base;
+    unsigned size;
+    //! topology of each thread as seen from inside the sub-pool
+    std::vector<ThreadTopoInfo> views;
+    std::function<void(void)> work;
+    //! threads of the current parallel section
+    unsigned num;
+    bool running;
+    bool exit;
+    //! bumped by the first thread to start a parallel section or to exit
+    std::atomic<unsigned> generation;
+    //! threads still working on the current parallel section
+    std::atomic<unsigned> pending;
+  };
+
   //! Per-thread mailboxes for notification
   struct per_signal {
+#ifndef __linux__
     std::condition_variable cv;
     std::mutex m;
+#endif
     unsigned wbegin, wend;
     std::atomic<int> done;
-    std::atomic<int> fastRelease;
+    //! 0: waiting, 1: released, 2: owner is blocked in the kernel
+    std::atomic<int> release;
+    //! pause instructions to spin before blocking; ~0 spins forever
+    std::atomic<uint64_t> spinIters;
+    // wake-up statistics, written by the owner only
+    uint64_t wakeups;
+    uint64_t sleeps;
+    uint64_t totalLatencyNs;
+    uint64_t maxLatencyNs;
     ThreadTopoInfo topo;
+    //! topo as seen from the sub-pool the thread is in, or topo
+    ThreadTopoInfo view;
+    SubPool* pool;
 
-    void wakeup(bool fastmode) {
-      if (fastmode) {
-        done        = 0;
-        fastRelease = 1;
-      } else {
-        std::lock_guard<std::mutex> lg(m);
-        done = 0;
-        cv.notify_one();
-        // start.release();
-      }
-    }
+    void wakeup();
 
-    void wait(bool fastmode) {
-      if (fastmode) {
-        while (!fastRelease.load(std::memory_order_relaxed)) {
-          asmPause();
-        }
-        fastRelease = 0;
-      } else {
-        std::unique_lock<std::mutex> lg(m);
-        cv.wait(lg, [=] { return !done; });
-        // start.acquire();
-      }
-    }
+    //! returns true if the thread had to block
+    bool wait();
   };
 
   thread_local static per_signal my_box;
@@ -103,10 +118,27 @@ protected:
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
   unsigned reserved;
-  unsigned masterFastmode;
   bool running;
   std::function<void(void)> work;
 
+  IdlePolicy policy;
+  unsigned spinMicros;
+  //! calibrated number of pause instructions per microsecond
+  double pausesPerMicro;
+  //! threads [0, pinned) always spin
+  unsigned pinned;
+  //! when the current run started, to measure wake-up latency
+  uint64_t runStartNs;
+
+  //! spin window of thread tid under the current policy
+  uint64_t idleSpinIters(unsigned tid) const;
+
+  //! publish the spin windows to the threads
+  void applyIdlePolicy();
+
+  //! make idle threads re-read their spin window
+  void cycleThreads(unsigned num);
+
   //! destroy all threads
   void destroyCommon();
 
@@ -117,11 +149,23 @@ protected:
   void threadLoop(unsigned tid);
 
   //! spin up for run
-  void cascade(bool fastmode);
+  void cascade();
 
   //! spin down after run
   void decascade();
 
+  //! execute work of pool on num of its threads
+  void runSubPool(SubPool& pool, unsigned num);
+
+  //! wait for and execute parallel sections of pool
+  void subPoolLoop(SubPool& pool);
+
+  //! topology of thread tid of the current (sub-)pool
+  const ThreadTopoInfo& view(unsigned tid) const {
+    SubPool* pool = my_box.pool;
+    return pool ? pool->views[tid] : signals[tid]->topo;
+  }
+
   //! execute work on num threads
   void runInternal(unsigned num);
 
@@ -154,22 +198,76 @@ public:
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
-    work = std::ref(lwork);
     // work =
     // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
     assert(num <= getMaxThreads());
-    runInternal(num);
+    if (SubPool* pool = my_box.pool) {
+      pool->work = std::ref(lwork);
+      runSubPool(*pool, num);
+    } else {
+      work = std::ref(lwork);
+      runInternal(num);
+    }
   }
 
+  /**
+   * Splits the first threads of the pool into sub-pools of the given sizes
+   * and calls fn(i) on the first thread of every sub-pool i at the same time.
+   * Parallel sections started from fn, and so Galois loops, only run on the
+   * threads of its sub-pool and can run concurrently with those of other
+   * sub-pools. Inside a sub-pool, threads and sockets are numbered from 0
+   * (getTID(), getSocket(), ...), PerThreadStorage only shows the slots of
+   * the threads of the sub-pool, and each sub-pool has its own barrier and
+   * termination detection. Returns when all fn calls returned.
+   */
+  void runSubPools(const std::vector<unsigned>& sizes,
+                   const std::function<void(unsigned)>& fn);
+
   //! run function in a dedicated thread until the threadpool exits
   void runDedicated(std::function<void(void)>& f);
 
-  // experimental: busy wait for work
-  void burnPower(unsigned num);
-  // experimental: leave busy wait
-  void beKind();
+  /**
+   * Sets how idle threads wait for the next parallel section. With
+   * IdlePolicy::Hybrid, a thread spins for spinMicros microseconds after a
+   * parallel section ends and then blocks until it is woken up. The initial
+   * policy comes from the environment variables GALOIS_IDLE_POLICY (spin,
+   * sleep or hybrid; sleep by default) and GALOIS_IDLE_SPIN_US (50 by
+   * default).
+   */
+  void setIdlePolicy(IdlePolicy p, unsigned spinMicros);
+  IdlePolicy getIdlePolicy() const { return policy; }
+  unsigned getIdleSpinMicros() const { return spinMicros; }
+
+  /**
+   * Keeps threads 0 to num - 1 spinning while idle, whatever the idle
+   * policy, so that loops on up to num threads start with the lowest
+   * latency. The other threads follow the idle policy. pinThreads(0) undoes
+   * it.
+   */
+  void pinThreads(unsigned num);
+  unsigned getPinnedThreads() const { return pinned; }
+
+  // busy wait for work; same as pinThreads(num)
+  void burnPower(unsigned num) { pinThreads(num); }
+  // leave busy wait; same as pinThreads(0)
+  void beKind() { pinThreads(0); }
+
+  //! How long thread tid took to start working on parallel sections
+  struct WakeupStats {
+    uint64_t wakeups;        //!< number of parallel sections joined
+    uint64_t sleeps;         //!< times the thread had blocked before that
+    uint64_t totalLatencyNs; //!< time from the start of run to joining
+    uint64_t maxLatencyNs;
+  };
+
+  //! Wake-up stats of thread tid; only valid outside of parallel sections
+  WakeupStats getWakeupStats(unsigned tid) const;
+  void resetWakeupStats();
 
-  bool isRunning() const { return running; }
+  bool isRunning() const {
+    SubPool* pool = my_box.pool;
+    return pool ? pool->running : running;
+  }
 
   //! return the number of non-reserved threads in the pool
   unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
@@ -180,35 +278,51 @@ public:
   unsigned getMaxSockets() const { return mi.maxSockets; }
   unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
 
+  //! number of threads of the current sub-pool, or of the machine
+  unsigned getPoolSize() const {
+    SubPool* pool = my_box.pool;
+    return pool ? pool->size : mi.maxThreads;
+  }
+  //! machine thread id of thread 0 of the current sub-pool
+  static unsigned getPoolBase() {
+    SubPool* pool = my_box.pool;
+    return pool ? pool->base : 0;
+  }
+  static bool inSubPool() { return my_box.pool; }
+
   unsigned getLeaderForSocket(unsigned pid) const {
-    for (unsigned i = 0; i < getMaxThreads(); ++i)
+    for (unsigned i = 0; i < getPoolSize(); ++i)
       if (getSocket(i) == pid && isLeader(i))
         return i;
     abort();
   }
 
-  bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
-  }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
-  unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+  //! machine thread id of the first thread of machine socket pid
+  unsigned getMachineLeaderForSocket(unsigned pid) const {
+    for (unsigned i = 0; i < getMaxThreads(); ++i)
+      if (signals[i]->topo.socket == pid && signals[i]->topo.socketLeader == i)
+        return i;
+    abort();
   }
+
+  bool isLeader(unsigned tid) const { return view(tid).socketLeader == tid; }
+  unsigned getSocket(unsigned tid) const { return view(tid).socket; }
+  unsigned getLeader(unsigned tid) const { return view(tid).socketLeader; }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return view(tid).cumulativeMaxSocket;
   }
-  unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
-  }
-
-  static unsigned getTID() { return my_box.topo.tid; }
-  static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
-  static unsigned getLeader() { return my_box.topo.socketLeader; }
-  static unsigned getSocket() { return my_box.topo.socket; }
+  unsigned getNumaNode(unsigned tid) const { return view(tid).numaNode; }
+
+  static unsigned getTID() { return my_box.view.tid; }
+  //! thread id in the whole pool, even inside a sub-pool
+  static unsigned getMachineTID() { return my_box.topo.tid; }
+  static bool isLeader() { return my_box.view.tid == my_box.view.socketLeader; }
+  static unsigned getLeader() { return my_box.view.socketLeader; }
+  static unsigned getSocket() { return my_box.view.socket; }
   static unsigned getCumulativeMaxSocket() {
-    return my_box.topo.cumulativeMaxSocket;
+    return my_box.view.cumulativeMaxSocket;
   }
-  static unsigned getNumaNode() { return my_box.topo.numaNode; }
+  static unsigned getNumaNode() { return my_box.view.numaNode; }
 };
 
 /**
@@ -30,6 +30,7 @@
 #include "galois/config.h"
 
 #include "galois/FlatMap.h"
+#include "galois/Threads.h"
 #include "galois/Timer.h"
 #include "galois/substrate/PaddedLock.h"
 #include "galois/substrate/PerThreadStorage.h"
@@ -357,7 +358,7 @@ private:
       Index minOfMin                       = p.minPrio;
       Index maxOfMax                       = p.maxPrio;
       p.cleanup();
-      for (unsigned i = 1; i < runtime::activeThreads; ++i) {
+      for (unsigned i = 1, e = galois::getActiveThreads(); i < e; ++i) {
         while (!data.getRemote(i)->lock.try_lock())
           ;
 
@@ -409,7 +410,7 @@ private:
           delta = 0;
 
         p.cleanup();
-        for (unsigned i = 1; i < runtime::activeThreads; ++i) {
+        for (unsigned i = 1, e = galois::getActiveThreads(); i < e; ++i) {
           while (!data.getRemote(i)->lock.try_lock())
             ;
           data.getRemote(i)->cleanup();
@@ -429,7 +430,7 @@ private:
     if (BSP && !UseMonotonic) {
       msS = p.scanStart;
       if (localLeader || uniformBSP) {
-        for (unsigned i = 0; i < runtime::activeThreads; ++i) {
+        for (unsigned i = 0, e = galois::getActiveThreads(); i < e; ++i) {
           msS = std::min(msS, data.getRemote(i)->scanStart);
         }
       } else {
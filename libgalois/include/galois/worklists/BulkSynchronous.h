@@ -23,6 +23,7 @@
 #include <atomic>
 
 #include "galois/config.h"
+#include "galois/Threads.h"
 #include "galois/runtime/Substrate.h"
 #include "galois/worklists/Chunk.h"
 #include "galois/worklists/WLCompileCheck.h"
@@ -67,7 +68,7 @@ public:
   typedef T value_type;
 
   BulkSynchronous()
-      : barrier(runtime::getBarrier(runtime::activeThreads)), some(false),
+      : barrier(runtime::getBarrier(galois::getActiveThreads())), some(false),
         isEmpty(false) {}
 
   void push(const value_type& val) {
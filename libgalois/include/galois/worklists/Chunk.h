@@ -22,15 +22,21 @@
 
 #include "galois/config.h"
 #include "galois/FixedSizeRing.h"
+#include "galois/Threads.h"
+#include "galois/runtime/AdaptiveChunkSize.h"
+#include "galois/runtime/EventTrace.h"
 #include "galois/runtime/Mem.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/PaddedLock.h"
 #include "galois/worklists/WLCompileCheck.h"
 #include "galois/worklists/WorkListHelpers.h"
 
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
 namespace galois {
-namespace runtime {
-extern unsigned activeThreads;
-}
 namespace worklists {
 
 namespace internal {
@@ -42,7 +48,7 @@ struct squeue {
   TQ& get(int i) { return *queues.getRemote(i); }
   TQ& get() { return *queues.getLocal(); }
   int myEffectiveID() { return substrate::ThreadPool::getTID(); }
-  int size() { return runtime::activeThreads; }
+  int size() { return galois::getActiveThreads(); }
 };
 
 template <template <typename> class PS, typename TQ>
@@ -54,89 +60,271 @@ struct squeue<false, PS, TQ> {
   int size() { return 0; }
 };
 
-//! Common functionality to all chunked worklists
+/**
+ * Common functionality to all chunked worklists. If Adaptive, ChunkSize is
+ * the largest chunk and each thread publishes chunks once they hold as many
+ * items as its {@link runtime::AdaptiveChunkSize} says, which adapts to the
+ * time the thread takes per chunk and shrinks when threads have to steal.
+ * Adaptive chunks are allocated with room for that many items rounded up to a
+ * power of two rather than for ChunkSize items.
+ */
 template <typename T, template <typename, bool> class QT, bool Distributed,
-          bool IsStack, int ChunkSize, bool Concurrent>
+          bool IsStack, int ChunkSize, bool Concurrent, bool Adaptive = false>
 struct ChunkMaster {
   template <typename _T>
-  using retype =
-      ChunkMaster<_T, QT, Distributed, IsStack, ChunkSize, Concurrent>;
+  using retype = ChunkMaster<_T, QT, Distributed, IsStack, ChunkSize,
+                             Concurrent, Adaptive>;
 
   template <int _chunk_size>
-  using with_chunk_size =
-      ChunkMaster<T, QT, Distributed, IsStack, _chunk_size, Concurrent>;
+  using with_chunk_size = ChunkMaster<T, QT, Distributed, IsStack,
+                                      _chunk_size, Concurrent, Adaptive>;
 
   template <bool _Concurrent>
-  using rethread =
-      ChunkMaster<T, QT, Distributed, IsStack, ChunkSize, _Concurrent>;
+  using rethread = ChunkMaster<T, QT, Distributed, IsStack, ChunkSize,
+                               _Concurrent, Adaptive>;
 
 private:
-  class Chunk : public FixedSizeRing<T, ChunkSize>,
-                public QT<Chunk, Concurrent>::ListNode {};
+  class FixedChunk : public FixedSizeRing<T, ChunkSize>,
+                     public QT<FixedChunk, Concurrent>::ListNode {};
+
+  /**
+   * Ring of items of an adaptive worklist. The items are stored right behind
+   * the chunk, which is allocated with room for capacity of them.
+   */
+  class AdaptiveChunk : public QT<AdaptiveChunk, Concurrent>::ListNode {
+    unsigned capacity;
+    unsigned start = 0;
+    unsigned count = 0;
+
+    T* at(unsigned i) {
+      return reinterpret_cast<T*>(reinterpret_cast<char*>(this) +
+                                  DATA_OFFSET) +
+             i;
+    }
+
+  public:
+    explicit AdaptiveChunk(unsigned c) : capacity(c) {}
+    AdaptiveChunk(const AdaptiveChunk&) = delete;
+    AdaptiveChunk& operator=(const AdaptiveChunk&) = delete;
+
+    ~AdaptiveChunk() {
+      while (count)
+        pop_back();
+    }
+
+    unsigned getCapacity() const { return capacity; }
+    unsigned size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    template <typename... Args>
+    T* emplace_back(Args&&... args) {
+      if (count == capacity)
+        return 0;
+      T* r = at((start + count) % capacity);
+      new (r) T(std::forward<Args>(args)...);
+      ++count;
+      return r;
+    }
+
+    T& front() {
+      assert(!empty());
+      return *at(start);
+    }
+
+    T& back() {
+      assert(!empty());
+      return *at((start + count - 1) % capacity);
+    }
+
+    void pop_front() {
+      front().~T();
+      start = (start + 1) % capacity;
+      --count;
+    }
 
-  runtime::FixedSizeAllocator<Chunk> alloc;
+    void pop_back() {
+      back().~T();
+      --count;
+    }
+
+    galois::optional<T> extract_front() {
+      if (empty())
+        return galois::optional<T>();
+      galois::optional<T> r(front());
+      pop_front();
+      return r;
+    }
+
+    galois::optional<T> extract_back() {
+      if (empty())
+        return galois::optional<T>();
+      galois::optional<T> r(back());
+      pop_back();
+      return r;
+    }
+  };
+
+  using Chunk = std::conditional_t<Adaptive, AdaptiveChunk, FixedChunk>;
+
+  //! offset of the items behind an AdaptiveChunk
+  static constexpr size_t DATA_OFFSET =
+      (sizeof(AdaptiveChunk) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+  //! initial chunk size of adaptive worklists
+  static constexpr unsigned ADAPTIVE_INITIAL = ChunkSize < 32 ? ChunkSize : 32;
+
+  //! number of power of two capacities of adaptive chunks, 1 to ChunkSize
+  static constexpr unsigned NUM_CLASSES = [] {
+    unsigned n = 1;
+    while ((1u << (n - 1)) < unsigned(ChunkSize))
+      ++n;
+    return n;
+  }();
+
+  runtime::FixedSizeAllocator<FixedChunk> alloc;
+  //! heaps of adaptive chunks by capacity class if Adaptive
+  std::vector<runtime::FixedSizeHeap> heaps;
+
+  //! class of the smallest capacity of at least size items
+  static unsigned classOf(unsigned size) {
+    unsigned c = 0;
+    while ((1u << c) < size)
+      ++c;
+    return c;
+  }
+
+  static unsigned capacityOf(unsigned c) {
+    return std::min(1u << c, unsigned(ChunkSize));
+  }
+
+  static size_t bytesOf(unsigned c) {
+    return DATA_OFFSET + capacityOf(c) * sizeof(T);
+  }
 
   struct p {
     Chunk* cur;
     Chunk* next;
-    p() : cur(0), next(0) {}
+    runtime::AdaptiveChunkSize adaptive;
+    unsigned curItems;  //!< items in the chunk being worked on if Adaptive
+    unsigned seenSteal; //!< value of steals when last looked at
+    p()
+        : cur(0), next(0), adaptive(ADAPTIVE_INITIAL, ChunkSize), curItems(0),
+          seenSteal(0) {}
   };
 
   typedef QT<Chunk, Concurrent> LevelItem;
 
   squeue<Concurrent, substrate::PerThreadStorage, p> data;
   squeue<Distributed, substrate::PerSocketStorage, LevelItem> Q;
-
-  Chunk* mkChunk() {
-    Chunk* ptr = alloc.allocate(1);
-    alloc.construct(ptr);
-    return ptr;
+  //! number of chunks threads stole from other queues if Adaptive
+  std::atomic<unsigned> steals{0};
+
+  //! Makes a chunk; adaptive ones get room for the thread's chunk size
+  Chunk* mkChunk(p& n) {
+    if constexpr (Adaptive) {
+      unsigned c = classOf(n.adaptive.get());
+      Chunk* ptr = new (heaps[c].allocate(bytesOf(c))) Chunk(capacityOf(c));
+      substrate::memAccountAlloc(substrate::MemCategory::WorklistChunks,
+                                 bytesOf(c));
+      return ptr;
+    } else {
+      Chunk* ptr = alloc.allocate(1);
+      alloc.construct(ptr);
+      substrate::memAccountAlloc(substrate::MemCategory::WorklistChunks,
+                                 sizeof(Chunk));
+      return ptr;
+    }
   }
 
   void delChunk(Chunk* ptr) {
-    alloc.destroy(ptr);
-    alloc.deallocate(ptr, 1);
+    if constexpr (Adaptive) {
+      unsigned c = classOf(ptr->getCapacity());
+      ptr->~Chunk();
+      heaps[c].deallocate(ptr);
+      substrate::memAccountFree(substrate::MemCategory::WorklistChunks,
+                                bytesOf(c));
+    } else {
+      alloc.destroy(ptr);
+      alloc.deallocate(ptr, 1);
+      substrate::memAccountFree(substrate::MemCategory::WorklistChunks,
+                                sizeof(Chunk));
+    }
   }
 
   void pushChunk(Chunk* C) {
+    runtime::traceEvent(runtime::TraceEvent::WorklistPush, C->size());
     LevelItem& I = Q.get();
     I.push(C);
   }
 
+  //! Publishes the chunk being filled
+  void publish(p& n) {
+    if (Adaptive) {
+      unsigned s = steals.load(std::memory_order_relaxed);
+      if (s != n.seenSteal) {
+        n.seenSteal = s;
+        n.adaptive.contended();
+      }
+    }
+    pushChunk(n.next);
+  }
+
+  //! The thread starts working on chunk c, or has no chunk if c is null
+  void took(p& n, Chunk* c) {
+    if (!Adaptive)
+      return;
+    n.adaptive.stop(n.curItems);
+    n.curItems = c ? c->size() : 0;
+    if (c)
+      n.adaptive.start();
+  }
+
+  bool isFull(p& n) const {
+    return Adaptive && n.next->size() >= n.adaptive.get();
+  }
+
   Chunk* popChunkByID(unsigned int i) {
     LevelItem& I = Q.get(i);
     return I.pop();
   }
 
-  Chunk* popChunk() {
-    int id   = Q.myEffectiveID();
-    Chunk* r = popChunkByID(id);
-    if (r)
-      return r;
-
-    for (int i = id + 1; i < (int)Q.size(); ++i) {
+  Chunk* stealChunk(int id) {
+    Chunk* r = 0;
+    for (int i = id + 1; !r && i < (int)Q.size(); ++i) {
       r = popChunkByID(i);
-      if (r)
-        return r;
     }
 
-    for (int i = 0; i < id; ++i) {
+    for (int i = 0; !r && i < id; ++i) {
       r = popChunkByID(i);
-      if (r)
-        return r;
     }
 
-    return 0;
+    if (Q.size() > 1) {
+      runtime::traceEvent(runtime::TraceEvent::Steal, r ? r->size() : 0);
+    }
+    if (Adaptive && r)
+      steals.fetch_add(1, std::memory_order_relaxed);
+    return r;
+  }
+
+  Chunk* popChunk() {
+    int id   = Q.myEffectiveID();
+    Chunk* r = popChunkByID(id);
+    if (!r)
+      r = stealChunk(id);
+    if (r)
+      runtime::traceEvent(runtime::TraceEvent::WorklistPop, r->size());
+    return r;
   }
 
   template <typename... Args>
   T* emplacei(p& n, Args&&... args) {
     T* retval = 0;
-    if (n.next && (retval = n.next->emplace_back(std::forward<Args>(args)...)))
+    if (n.next && !isFull(n) &&
+        (retval = n.next->emplace_back(std::forward<Args>(args)...)))
       return retval;
     if (n.next)
-      pushChunk(n.next);
-    n.next = mkChunk();
+      publish(n);
+    n.next = mkChunk(n);
     retval = n.next->emplace_back(std::forward<Args>(args)...);
     assert(retval);
     return retval;
@@ -145,17 +333,35 @@ private:
 public:
   typedef T value_type;
 
-  ChunkMaster()                   = default;
+  ChunkMaster() {
+    if (Adaptive) {
+      for (unsigned c = 0; c < NUM_CLASSES; ++c)
+        heaps.emplace_back(bytesOf(c));
+    }
+  }
+
   ChunkMaster(const ChunkMaster&) = delete;
   ChunkMaster& operator=(const ChunkMaster&) = delete;
 
   void flush() {
     p& n = data.get();
     if (n.next)
-      pushChunk(n.next);
+      publish(n);
     n.next = 0;
   }
 
+  /**
+   * Reports the chunk sizes the calling thread used as stats of loopname
+   * (adaptive worklists only).
+   */
+  void reportStats(const char* loopname) {
+    if (Adaptive) {
+      p& n = data.get();
+      took(n, 0);
+      n.adaptive.report(loopname);
+    }
+  }
+
   /**
    * Construct an item on the worklist and return a pointer to its value.
    *
@@ -182,6 +388,7 @@ public:
       if (n.next)
         delChunk(n.next);
       n.next = popChunk();
+      took(n, n.next);
       if (n.next && !n.next->empty())
         return &n.next->back();
       return NULL;
@@ -192,9 +399,13 @@ public:
         delChunk(n.cur);
       n.cur = popChunk();
       if (!n.cur) {
+        // nothing published; fall back to the chunk being filled
         n.cur  = n.next;
         n.next = 0;
+        if (n.cur)
+          runtime::traceEvent(runtime::TraceEvent::WorklistPop, n.cur->size());
       }
+      took(n, n.cur);
       if (n.cur && !n.cur->empty())
         return &n.cur->front();
       return NULL;
@@ -244,6 +455,7 @@ public:
       if (n.next)
         delChunk(n.next);
       n.next = popChunk();
+      took(n, n.next);
       if (n.next)
         return n.next->extract_back();
       return galois::optional<value_type>();
@@ -254,9 +466,13 @@ public:
         delChunk(n.cur);
       n.cur = popChunk();
       if (!n.cur) {
+        // nothing published; fall back to the chunk being filled
         n.cur  = n.next;
         n.next = 0;
+        if (n.cur)
+          runtime::traceEvent(runtime::TraceEvent::WorklistPop, n.cur->size());
       }
+      took(n, n.cur);
       if (n.cur)
         return n.cur->extract_front();
       return galois::optional<value_type>();
@@ -317,6 +533,30 @@ using PerSocketChunkBag = internal::ChunkMaster<T, ConExtLinkedQueue, true,
                                                 true, ChunkSize, Concurrent>;
 GALOIS_WLCOMPILECHECK(PerSocketChunkBag)
 
+/**
+ * {@link PerSocketChunkFIFO} whose threads tune their chunk size at runtime,
+ * which is reported as the ChunkSize stat of named loops.
+ *
+ * @tparam MaxChunkSize largest chunk size
+ */
+template <int MaxChunkSize = 1024, typename T = int, bool Concurrent = true>
+using AdaptivePerSocketChunkFIFO =
+    internal::ChunkMaster<T, ConExtLinkedQueue, true, false, MaxChunkSize,
+                          Concurrent, true>;
+GALOIS_WLCOMPILECHECK(AdaptivePerSocketChunkFIFO)
+
+/**
+ * {@link PerSocketChunkLIFO} whose threads tune their chunk size at runtime,
+ * which is reported as the ChunkSize stat of named loops.
+ *
+ * @tparam MaxChunkSize largest chunk size
+ */
+template <int MaxChunkSize = 1024, typename T = int, bool Concurrent = true>
+using AdaptivePerSocketChunkLIFO =
+    internal::ChunkMaster<T, ConExtLinkedStack, true, true, MaxChunkSize,
+                          Concurrent, true>;
+GALOIS_WLCOMPILECHECK(AdaptivePerSocketChunkLIFO)
+
 } // end namespace worklists
 } // end namespace galois
 
@@ -25,6 +25,7 @@
 #include <type_traits>
 
 #include "galois/FlatMap.h"
+#include "galois/Threads.h"
 #include "galois/runtime/Substrate.h"
 #include "galois/substrate/PerThreadStorage.h"
 #include "galois/substrate/Termination.h"
@@ -55,7 +56,7 @@ protected:
   substrate::Barrier& barrier;
 
   OrderedByIntegerMetricData()
-      : barrier(runtime::getBarrier(runtime::activeThreads)) {}
+      : barrier(runtime::getBarrier(galois::getActiveThreads())) {}
 
   bool hasStored(ThreadData& p, Index idx) {
     for (auto& e : p.stored) {
@@ -88,7 +89,7 @@ struct OrderedByIntegerMetricComparator {
 
   template <typename C>
   struct with_local_map {
-    typedef galois::flat_map<Index, C, std::less<Index>> type;
+    typedef galois::split_flat_map<Index, C, std::less<Index>> type;
   };
   OrderedByIntegerMetricComparator()
       : identity(std::numeric_limits<Index>::max()),
@@ -103,7 +104,7 @@ struct OrderedByIntegerMetricComparator<Index, true> {
 
   template <typename C>
   struct with_local_map {
-    typedef galois::flat_map<Index, C, std::greater<Index>> type;
+    typedef galois::split_flat_map<Index, C, std::greater<Index>> type;
   };
   OrderedByIntegerMetricComparator()
       : identity(std::numeric_limits<Index>::min()),
@@ -288,7 +289,7 @@ private:
     if (BSP && !UseMonotonic) {
       msS = p.scanStart;
       if (localLeader) {
-        for (unsigned i = 0; i < runtime::activeThreads; ++i) {
+        for (unsigned i = 0, e = galois::getActiveThreads(); i < e; ++i) {
           Index o = data.getRemote(i)->scanStart;
           if (this->compare(o, msS))
             msS = o;
@@ -449,7 +450,7 @@ public:
     Index curIndex = (hasWork) ? p.curIndex : this->identity;
     CTy* C         = (hasWork) ? p.current : nullptr;
 
-    for (unsigned i = 0; i < runtime::activeThreads; ++i) {
+    for (unsigned i = 0, e = galois::getActiveThreads(); i < e; ++i) {
       ThreadData& o = *data.getRemote(i);
       if (o.hasWork && this->compare(o.curIndex, curIndex)) {
         curIndex = o.curIndex;
@@ -22,6 +22,7 @@
 
 #include "galois/FixedSizeRing.h"
 #include "galois/runtime/Mem.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/PerThreadStorage.h"
 #include "galois/substrate/CompilerSpecific.h"
 #include "galois/substrate/PtrLock.h"
@@ -315,12 +316,16 @@ private:
   Chunk* mkChunk() {
     Chunk* ptr = alloc.allocate(1);
     alloc.construct(ptr);
+    substrate::memAccountAlloc(substrate::MemCategory::WorklistChunks,
+                               sizeof(Chunk));
     return ptr;
   }
 
   void delChunk(Chunk* ptr) {
     alloc.destroy(ptr);
     alloc.deallocate(ptr, 1);
+    substrate::memAccountFree(substrate::MemCategory::WorklistChunks,
+                              sizeof(Chunk));
   }
 
   void swapInPush(std::pair<Chunk*, Chunk*>& d) {
@@ -22,6 +22,7 @@
 
 #include "galois/config.h"
 #include "galois/gstl.h"
+#include "galois/Threads.h"
 #include "galois/worklists/Chunk.h"
 
 namespace galois {
@@ -129,7 +130,7 @@ private:
     }
     ++data.nextVictim;
     ++data.numStealFailures;
-    data.nextVictim %= runtime::activeThreads;
+    data.nextVictim %= galois::getActiveThreads();
     return galois::optional<value_type>();
   }
 
@@ -154,7 +155,7 @@ public:
       return *data.localBegin++;
 
     galois::optional<value_type> item;
-    if (Steal && 2 * data.numStealFailures > runtime::activeThreads)
+    if (Steal && 2 * data.numStealFailures > galois::getActiveThreads())
       if ((item = pop_steal(data)))
         return item;
     if ((item = inner.pop()))
@@ -0,0 +1,326 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file EventTrace.cpp
+ *
+ * Ring buffers and Chrome trace-event output for EventTrace.h
+ */
+
+#include "galois/runtime/EventTrace.h"
+#include "galois/gIO.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/substrate/SimpleLock.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace galois::runtime {
+uint32_t getHostID();
+} // namespace galois::runtime
+
+using namespace galois::runtime;
+
+bool galois::runtime::internal::eventTraceOn = false;
+internal::EventRing** galois::runtime::internal::eventRings = nullptr;
+
+namespace {
+
+constexpr int DEFAULT_RING_SIZE = 1 << 16;
+
+std::string traceFile;
+uint64_t ringSize;
+unsigned numRings;
+
+//! tsc and wall clock when recording started, to convert ticks to time
+uint64_t startTSC;
+std::chrono::steady_clock::time_point startTime;
+
+galois::substrate::SimpleLock namesLock;
+std::set<std::string> names;
+
+struct NameCache {
+  const char* raw      = nullptr;
+  const char* interned = nullptr;
+};
+thread_local NameCache lastName;
+
+//! Which stack of open spans an event opens or closes, -1 if none
+int spanKind(TraceEvent type) {
+  switch (type) {
+  case TraceEvent::LoopBegin:
+  case TraceEvent::LoopEnd:
+    return 0;
+  case TraceEvent::IdleBegin:
+  case TraceEvent::IdleEnd:
+    return 1;
+  case TraceEvent::BarrierBegin:
+  case TraceEvent::BarrierEnd:
+    return 2;
+  default:
+    return -1;
+  }
+}
+
+bool isBegin(TraceEvent type) {
+  return type == TraceEvent::LoopBegin || type == TraceEvent::IdleBegin ||
+         type == TraceEvent::BarrierBegin;
+}
+
+const char* eventName(TraceEvent type) {
+  switch (type) {
+  case TraceEvent::WorklistPush:
+    return "WorklistPush";
+  case TraceEvent::WorklistPop:
+    return "WorklistPop";
+  case TraceEvent::Steal:
+    return "Steal";
+  case TraceEvent::IdleBegin:
+  case TraceEvent::IdleEnd:
+    return "Idle";
+  case TraceEvent::BarrierBegin:
+  case TraceEvent::BarrierEnd:
+    return "Barrier";
+  default:
+    return "Loop";
+  }
+}
+
+const char* spanCategory(int kind) {
+  static const char* const categories[] = {"loop", "idle", "barrier"};
+  return categories[kind];
+}
+
+class TraceWriter {
+  std::ostream& out;
+  uint32_t pid;
+  double ticksPerUs;
+  const char* sep = "\n";
+
+  void begin(const char* name, const char* cat, const char* ph, unsigned tid,
+             uint64_t tsc) {
+    out << sep << "{\"name\":";
+    internal::writeJSONString(out, name);
+    out << ",\"cat\":\"" << cat << "\",\"ph\":\"" << ph << "\",\"pid\":" << pid
+        << ",\"tid\":" << tid << ",\"ts\":" << toUs(tsc);
+    sep = ",\n";
+  }
+
+public:
+  TraceWriter(std::ostream& o, uint32_t p, double t)
+      : out(o), pid(p), ticksPerUs(t) {
+    out << std::fixed << std::setprecision(3);
+  }
+
+  double toUs(uint64_t tsc) const {
+    return tsc > startTSC ? (tsc - startTSC) / ticksPerUs : 0.0;
+  }
+
+  void span(const char* name, const char* cat, unsigned tid, uint64_t from,
+            uint64_t to) {
+    begin(name, cat, "X", tid, from);
+    out << ",\"dur\":" << (to > from ? (to - from) / ticksPerUs : 0.0) << "}";
+  }
+
+  void instant(const char* name, unsigned tid, uint64_t tsc, uint64_t items) {
+    begin(name, "worklist", "i", tid, tsc);
+    out << ",\"s\":\"t\",\"args\":{\"items\":" << items << "}}";
+  }
+
+  void threadName(unsigned tid) {
+    out << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+        << ",\"tid\":" << tid << ",\"args\":{\"name\":\"thread " << tid
+        << "\"}}";
+    sep = ",\n";
+  }
+};
+
+//! Writes the events still in the ring of thread tid
+void writeRing(TraceWriter& w, unsigned tid, const internal::EventRing& ring) {
+  uint64_t first = ring.next > ringSize ? ring.next - ringSize : 0;
+  if (first == ring.next) {
+    return;
+  }
+  w.threadName(tid);
+
+  // spans whose begin was overwritten start with the oldest event kept
+  uint64_t oldest = ring.records[first & ring.mask].tsc;
+  uint64_t last   = oldest;
+  std::vector<internal::TraceRecord> open[3];
+
+  for (uint64_t i = first; i < ring.next; ++i) {
+    const internal::TraceRecord& r = ring.records[i & ring.mask];
+    last                           = r.tsc;
+    int kind                       = spanKind(r.type);
+
+    if (kind < 0) {
+      w.instant(eventName(r.type), tid, r.tsc, r.arg);
+    } else if (isBegin(r.type)) {
+      open[kind].push_back(r);
+    } else if (open[kind].empty()) {
+      w.span(kind == 0 ? "(unknown loop)" : eventName(r.type),
+             spanCategory(kind), tid, oldest, r.tsc);
+    } else {
+      const internal::TraceRecord& b = open[kind].back();
+      w.span(kind == 0 ? b.name : eventName(r.type), spanCategory(kind), tid,
+             b.tsc, r.tsc);
+      open[kind].pop_back();
+    }
+  }
+
+  for (int kind = 0; kind < 3; ++kind) {
+    for (auto& b : open[kind]) {
+      w.span(kind == 0 ? b.name : eventName(b.type), spanCategory(kind), tid,
+             b.tsc, last);
+    }
+  }
+}
+
+} // namespace
+
+internal::EventRing* galois::runtime::internal::makeEventRing(unsigned tid) {
+  GALOIS_ASSERT(tid < numRings);
+  // allocated by the owning thread so that the buffer is local to it
+  EventRing* ring = new EventRing;
+  ring->records   = new TraceRecord[ringSize];
+  ring->mask      = ringSize - 1;
+  ring->next      = 0;
+  eventRings[tid] = ring;
+  return ring;
+}
+
+const char* galois::runtime::internal::internTraceName(const char* name) {
+  if (!name) {
+    return "ANON_LOOP";
+  }
+  NameCache& c = lastName;
+  if (c.raw == name && std::strcmp(c.interned, name) == 0) {
+    return c.interned;
+  }
+  std::lock_guard<substrate::SimpleLock> lg(namesLock);
+  c.raw      = name;
+  c.interned = names.insert(name).first->c_str();
+  return c.interned;
+}
+
+void galois::runtime::internal::writeJSONString(std::ostream& out,
+                                                const char* s) {
+  out << '"';
+  for (; *s; ++s) {
+    unsigned char c = *s;
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (c < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out << buf;
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+void galois::runtime::internal::initEventTrace() {
+  if (!substrate::EnvCheck("GALOIS_EVENT_TRACE", traceFile)) {
+    return;
+  }
+  int size = DEFAULT_RING_SIZE;
+  substrate::EnvCheck("GALOIS_EVENT_TRACE_SIZE", size);
+  // round up to a power of two
+  ringSize = 1;
+  while (ringSize < uint64_t(std::max(size, 1))) {
+    ringSize <<= 1;
+  }
+
+  numRings   = substrate::getThreadPool().getMaxThreads();
+  eventRings = new EventRing*[numRings]();
+  startTime  = std::chrono::steady_clock::now();
+  startTSC   = readTSC();
+
+  eventTraceOn = true;
+}
+
+void galois::runtime::internal::printEventTrace() {
+  if (!eventTraceOn) {
+    return;
+  }
+  std::ofstream out(traceFile);
+  if (!out.good()) {
+    gWarn("Could not open event trace file for writing: ", traceFile);
+    return;
+  }
+  writeEventTrace(out);
+}
+
+void galois::runtime::internal::finishEventTrace() {
+  if (!eventTraceOn) {
+    return;
+  }
+  eventTraceOn = false;
+  for (unsigned i = 0; i < numRings; ++i) {
+    if (eventRings[i]) {
+      delete[] eventRings[i]->records;
+      delete eventRings[i];
+    }
+  }
+  delete[] eventRings;
+  eventRings = nullptr;
+}
+
+void galois::runtime::writeEventTrace(std::ostream& out) {
+  if (!internal::eventTraceOn) {
+    return;
+  }
+  uint64_t endTSC = readTSC();
+  double elapsedUs =
+      std::chrono::duration<double, std::micro>(
+          std::chrono::steady_clock::now() - startTime)
+          .count();
+  double ticksPerUs =
+      elapsedUs > 0 && endTSC > startTSC ? (endTSC - startTSC) / elapsedUs
+                                         : 1.0;
+
+  out << "{\"traceEvents\":[";
+  TraceWriter w(out, getHostID(), ticksPerUs);
+  for (unsigned tid = 0; tid < numRings; ++tid) {
+    if (internal::eventRings[tid]) {
+      writeRing(w, tid, *internal::eventRings[tid]);
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"ticksPerUs\":"
+      << ticksPerUs << ",\"droppedEvents\":" << droppedTraceEvents() << "}}\n";
+}
+
+uint64_t galois::runtime::droppedTraceEvents() {
+  uint64_t dropped = 0;
+  for (unsigned i = 0; internal::eventTraceOn && i < numRings; ++i) {
+    auto* ring = internal::eventRings[i];
+    if (ring && ring->next > ringSize) {
+      dropped += ring->next - ringSize;
+    }
+  }
+  return dropped;
+}
@@ -25,6 +25,8 @@
  */
 
 #include "galois/gIO.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Threads.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/substrate/PageAlloc.h"
 
@@ -397,7 +399,7 @@ void FileGraph::partFromFile(const std::string& filename, NodeRange nrange,
 
   // do interleaved numa allocation with current number of threads
   if (numaMap) {
-    unsigned int numThreads   = galois::runtime::activeThreads;
+    unsigned int numThreads   = galois::getActiveThreads();
     const size_t hugePageSize = 2 * 1024 * 1024; // 2MB
 
     void* ptr;
@@ -744,11 +746,7 @@ void FileGraphWriter::phase2() {
     return;
 
   // Turn counts into partial sums
-  uint64_t* prev = outIdx;
-  for (uint64_t *ii = outIdx + 1, *ei = outIdx + numNodes; ii != ei;
-       ++ii, ++prev) {
-    *ii += *prev;
-  }
+  galois::ParallelSTL::partial_sum(outIdx, outIdx + numNodes, outIdx);
   assert(outIdx[numNodes - 1] == numEdges);
 
   starts = std::make_unique<uint64_t[]>(numNodes);
@@ -0,0 +1,157 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/graphs/MappedGraphFile.h"
+#include "galois/substrate/PageAlloc.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef GALOIS_USE_NUMA
+#include <numa.h>
+#endif
+
+using namespace galois::graphs;
+
+namespace {
+
+const size_t HEADER_WORDS = 4;
+
+//! Bytes of the edge destinations including the padding to 8 bytes
+uint64_t dstBytes(uint64_t version, uint64_t numEdges) {
+  uint64_t padded = numEdges + numEdges % 2;
+  return padded * (version == 1 ? sizeof(uint32_t) : sizeof(uint64_t));
+}
+
+int toMadvise(MappedGraphFile::Advice advice) {
+  switch (advice) {
+  case MappedGraphFile::Advice::Sequential:
+    return MADV_SEQUENTIAL;
+  case MappedGraphFile::Advice::Random:
+    return MADV_RANDOM;
+  case MappedGraphFile::Advice::WillNeed:
+    return MADV_WILLNEED;
+  default:
+    return MADV_NORMAL;
+  }
+}
+
+//! Reads one byte of every page, with consecutive huge pages on different
+//! threads
+void faultInterleaved(const void* ptr, size_t length) {
+  auto& pool          = galois::substrate::getThreadPool();
+  unsigned numThreads = pool.getMaxUsableThreads();
+  size_t step         = galois::substrate::allocSize();
+  pool.run(numThreads, [=]() {
+    const volatile char* p = static_cast<const volatile char*>(ptr);
+    unsigned tid           = galois::substrate::ThreadPool::getTID();
+    for (size_t page = tid * step; page < length; page += numThreads * step) {
+      size_t end = std::min(length, page + step);
+      for (size_t x = page; x < end; x += 4096) {
+        p[x];
+      }
+    }
+  });
+}
+
+} // namespace
+
+MappedGraphFile::MappedGraphFile(const std::string& filename,
+                                 const Options& options) {
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+  // the arrays are used in place, so they cannot be byte swapped
+  GALOIS_DIE("mapped graph files are only supported on little-endian hosts");
+#endif
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+  }
+  struct stat buf;
+  if (fstat(fd, &buf) == -1) {
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  }
+  length = buf.st_size;
+  if (length < HEADER_WORDS * sizeof(uint64_t)) {
+    GALOIS_DIE("'", filename, "' is not a graph file");
+  }
+
+  // interleaved pages are faulted in after the NUMA policy is set
+  int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+  if (options.populate && !options.interleave) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+  base = mmap(nullptr, length, PROT_READ, flags, fd, 0);
+  if (base == MAP_FAILED) {
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  }
+  close(fd);
+
+  const uint64_t* header = static_cast<const uint64_t*>(base);
+  version                = header[0];
+  sizeofEdge             = header[1];
+  numNodes               = header[2];
+  numEdges               = header[3];
+  if (version != 1 && version != 2) {
+    GALOIS_DIE("unknown file version ", version, " of '", filename, "'");
+  }
+  uint64_t needed = (HEADER_WORDS + numNodes) * sizeof(uint64_t) +
+                    dstBytes(version, numEdges) + numEdges * sizeofEdge;
+  if (needed > length) {
+    GALOIS_DIE("'", filename, "' is truncated");
+  }
+
+  if (options.advice != Advice::Normal) {
+    madvise(base, length, toMadvise(options.advice));
+  }
+  if (options.interleave) {
+#ifdef GALOIS_USE_NUMA
+    if (numa_available() >= 0) {
+      numa_interleave_memory(base, length, numa_all_nodes_ptr);
+    }
+#endif
+    faultInterleaved(base, length);
+  }
+}
+
+MappedGraphFile::~MappedGraphFile() {
+  if (base) {
+    munmap(base, length);
+  }
+}
+
+const uint64_t* MappedGraphFile::edgeIndex() const {
+  return static_cast<const uint64_t*>(base) + HEADER_WORDS;
+}
+
+const void* MappedGraphFile::edgeDst() const { return edgeIndex() + numNodes; }
+
+const void* MappedGraphFile::edgeData() const {
+  if (!sizeofEdge) {
+    return nullptr;
+  }
+  return static_cast<const char*>(edgeDst()) + dstBytes(version, numEdges);
+}
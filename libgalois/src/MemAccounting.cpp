@@ -0,0 +1,109 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/substrate/MemAccounting.h"
+#include "galois/substrate/CacheLineStorage.h"
+
+#include <atomic>
+
+using namespace galois::substrate;
+
+namespace {
+
+constexpr unsigned NUM_CATEGORIES = unsigned(MemCategory::NumCategories);
+//! Local changes that are published at once
+constexpr int64_t FLUSH_BYTES = 1 << 20;
+
+struct Counter {
+  std::atomic<int64_t> current{0};
+  std::atomic<int64_t> peak{0};
+
+  void add(int64_t delta) {
+    int64_t now  = current.fetch_add(delta, std::memory_order_relaxed) + delta;
+    int64_t prev = peak.load(std::memory_order_relaxed);
+    while (now > prev &&
+           !peak.compare_exchange_weak(prev, now, std::memory_order_relaxed)) {
+    }
+  }
+};
+
+CacheLineStorage<Counter> counters[NUM_CATEGORIES];
+CacheLineStorage<Counter> total;
+thread_local int64_t pending[NUM_CATEGORIES];
+
+void account(MemCategory c, int64_t delta) {
+  unsigned i = unsigned(c);
+  int64_t& p = pending[i];
+  p += delta;
+  if (p >= FLUSH_BYTES || p <= -FLUSH_BYTES) {
+    counters[i].data.add(p);
+    if (c != MemCategory::WorklistChunks) {
+      total.data.add(p);
+    }
+    p = 0;
+  }
+}
+
+} // namespace
+
+const char* galois::substrate::memCategoryName(MemCategory c) {
+  switch (c) {
+  case MemCategory::LargeArrays:
+    return "LargeArrays";
+  case MemCategory::PagePool:
+    return "PagePool";
+  case MemCategory::WorklistChunks:
+    return "WorklistChunks";
+  case MemCategory::CommBuffers:
+    return "CommBuffers";
+  default:
+    return "Unknown";
+  }
+}
+
+void galois::substrate::memAccountAlloc(MemCategory c, size_t bytes) {
+  account(c, int64_t(bytes));
+}
+
+void galois::substrate::memAccountFree(MemCategory c, size_t bytes) {
+  account(c, -int64_t(bytes));
+}
+
+int64_t galois::substrate::memCurrentBytes(MemCategory c) {
+  return counters[unsigned(c)].data.current.load(std::memory_order_relaxed);
+}
+
+int64_t galois::substrate::memPeakBytes(MemCategory c) {
+  return counters[unsigned(c)].data.peak.load(std::memory_order_relaxed);
+}
+
+int64_t galois::substrate::memTotalCurrentBytes() {
+  return total.data.current.load(std::memory_order_relaxed);
+}
+
+int64_t galois::substrate::memTotalPeakBytes() {
+  return total.data.peak.load(std::memory_order_relaxed);
+}
+
+void galois::substrate::resetMemPeaks() {
+  for (auto& c : counters) {
+    c.data.peak = c.data.current.load();
+  }
+  total.data.peak = total.data.current.load();
+}
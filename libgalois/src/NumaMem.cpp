@@ -18,6 +18,7 @@
  */
 
 #include "galois/substrate/NumaMem.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/PageAlloc.h"
 #include "galois/substrate/ThreadPool.h"
 #include "galois/gIO.h"
@@ -132,6 +133,14 @@ static void pageInSpecified(void* _ptr, size_t len, size_t pageSize,
 
 static void largeFree(void* ptr, size_t bytes) {
   freePages(ptr, bytes / allocSize());
+  memAccountFree(MemCategory::LargeArrays, bytes);
+}
+
+static LAptr makeLAptr(void* data, size_t bytes) {
+  if (data) {
+    memAccountAlloc(MemCategory::LargeArrays, bytes);
+  }
+  return LAptr{data, internal::largeFreer{bytes}};
 }
 
 void galois::substrate::internal::largeFreer::operator()(void* ptr) const {
@@ -166,23 +175,21 @@ LAptr galois::substrate::largeMallocInterleaved(size_t bytes,
     // true = round robin paging
     pageIn(data, bytes, allocSize(), numThreads, true);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return makeLAptr(data, bytes);
 }
 
 LAptr galois::substrate::largeMallocLocal(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a prefaulted allocation
-  return LAptr{allocPages(bytes / allocSize(), true),
-               internal::largeFreer{bytes}};
+  return makeLAptr(allocPages(bytes / allocSize(), true), bytes);
 }
 
 LAptr galois::substrate::largeMallocFloating(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  return LAptr{allocPages(bytes / allocSize(), false),
-               internal::largeFreer{bytes}};
+  return makeLAptr(allocPages(bytes / allocSize(), false), bytes);
 }
 
 LAptr galois::substrate::largeMallocBlocked(size_t bytes, unsigned numThreads) {
@@ -193,7 +200,7 @@ LAptr galois::substrate::largeMallocBlocked(size_t bytes, unsigned numThreads) {
   if (data)
     // false = blocked paging
     pageIn(data, bytes, allocSize(), numThreads, false);
-  return LAptr{data, internal::largeFreer{bytes}};
+  return makeLAptr(data, bytes);
 }
 
 /**
@@ -223,7 +230,7 @@ LAptr galois::substrate::largeMallocSpecified(size_t bytes, uint32_t numThreads,
     pageInSpecified(data, bytes, allocSize(), numThreads, threadRanges,
                     elementSize);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return makeLAptr(data, bytes);
 }
 // Explicit template declarations since the template is defined in the .h
 // file
@@ -0,0 +1,103 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/graphs/ParallelTextReader.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace galois {
+namespace graphs {
+
+ParallelTextReader::ParallelTextReader(const std::string& filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+  }
+
+  struct stat buf;
+  if (fstat(fd, &buf) == -1) {
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  }
+  length = buf.st_size;
+
+  if (length) {
+    void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+      GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+    }
+    // every thread reads its chunks front to back
+    madvise(base, length, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(base);
+  }
+  close(fd);
+
+  split(data);
+}
+
+ParallelTextReader::~ParallelTextReader() {
+  if (length) {
+    munmap(const_cast<char*>(data), length);
+  }
+}
+
+void ParallelTextReader::split(const char* begin) {
+  const char* last = end();
+  size_t n         = last - begin;
+  size_t numChunks =
+      std::max<size_t>(1, std::min<size_t>(4 * galois::getActiveThreads(),
+                                           n / (1 << 16)));
+
+  // chunk c starts at the first line starting at or after c * n / numChunks
+  bounds.assign(numChunks + 1, last);
+  bounds[0] = begin;
+  galois::do_all(
+      galois::iterate(size_t{1}, numChunks),
+      [&](size_t c) {
+        const char* p = begin + c * n / numChunks - 1;
+        const char* nl =
+            static_cast<const char*>(std::memchr(p, '\n', last - p));
+        bounds[c] = nl ? nl + 1 : last;
+      },
+      galois::no_stats());
+
+  // count lines per chunk; the last line need not end with a newline
+  firstLine.assign(numChunks + 1, 0);
+  galois::do_all(
+      galois::iterate(size_t{0}, numChunks),
+      [&](size_t c) {
+        uint64_t count = std::count(bounds[c], bounds[c + 1], '\n');
+        if (bounds[c + 1] == last && bounds[c] < last && last[-1] != '\n') {
+          ++count;
+        }
+        firstLine[c + 1] = count;
+      },
+      galois::no_stats());
+  for (size_t c = 0; c < numChunks; ++c) {
+    firstLine[c + 1] += firstLine[c];
+  }
+}
+
+} // namespace graphs
+} // namespace galois
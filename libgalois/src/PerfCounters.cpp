@@ -0,0 +1,244 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file PerfCounters.cpp
+ *
+ * perf_event_open backend of PerfCounters.h
+ */
+
+#include "galois/runtime/PerfCounters.h"
+#include "galois/gIO.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/substrate/ThreadPool.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace galois::runtime;
+
+bool galois::runtime::internal::perfCountersOn = false;
+
+namespace {
+
+struct CounterSpec {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+//! counters that could be opened, in the order of PerfSample::values
+std::vector<CounterSpec> counters;
+
+//! group leader of every thread, -1 if not opened yet, -2 if it failed
+std::vector<int> leaders;
+//! all descriptors, to close them at the end
+std::vector<std::vector<int>> descriptors;
+
+#ifdef __linux__
+
+uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+std::vector<CounterSpec> candidateCounters() {
+  std::vector<CounterSpec> c{
+      {"Cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {"Instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {"LLCMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {"DTLBMisses", PERF_TYPE_HW_CACHE,
+       cacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                   PERF_COUNT_HW_CACHE_RESULT_MISS)},
+      {"RemoteDRAMLoads", PERF_TYPE_HW_CACHE,
+       cacheConfig(PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_OP_READ,
+                   PERF_COUNT_HW_CACHE_RESULT_MISS)},
+      {"PageFaults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}};
+
+  std::string raw;
+  if (galois::substrate::EnvCheck("GALOIS_PERF_REMOTE_DRAM_EVENT", raw) &&
+      !raw.empty()) {
+    char* end;
+    errno           = 0;
+    uint64_t config = std::strtoull(raw.c_str(), &end, 16);
+    if (errno || *end) {
+      galois::gWarn("ignoring malformed GALOIS_PERF_REMOTE_DRAM_EVENT ", raw,
+                    "; using the generic event");
+    } else {
+      c[4].type   = PERF_TYPE_RAW;
+      c[4].config = config;
+    }
+  }
+  return c;
+}
+
+//! Opens a counter of the calling thread; the leader starts the group
+int openCounter(const CounterSpec& spec, int leader) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size           = sizeof(attr);
+  attr.type           = spec.type;
+  attr.config         = spec.config;
+  attr.disabled       = leader == -1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+//! Opens the counters of the calling thread as one group
+int openGroup(std::vector<int>& fds) {
+  int leader = -1;
+  for (auto& spec : counters) {
+    int fd = openCounter(spec, leader);
+    if (fd < 0) {
+      for (int f : fds) {
+        close(f);
+      }
+      fds.clear();
+      return -2;
+    }
+    fds.push_back(fd);
+    if (leader == -1) {
+      leader = fd;
+    }
+  }
+  ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return leader;
+}
+
+#endif
+
+} // namespace
+
+void galois::runtime::internal::initPerfCounters() {
+#ifdef __linux__
+  if (!substrate::EnvCheck("GALOIS_PERF_COUNTERS")) {
+    return;
+  }
+
+  // keep the counters that can be opened by themselves
+  std::vector<std::string> missing;
+  for (auto& spec : candidateCounters()) {
+    int fd = openCounter(spec, -1);
+    if (fd >= 0) {
+      close(fd);
+      if (counters.size() < MAX_PERF_COUNTERS) {
+        counters.push_back(spec);
+      }
+    } else {
+      missing.push_back(spec.name);
+    }
+  }
+  if (!missing.empty()) {
+    std::string names;
+    for (auto& m : missing) {
+      names += " " + m;
+    }
+    gWarn("perf counters not available:", names);
+  }
+  if (counters.empty()) {
+    return;
+  }
+
+  unsigned maxThreads = substrate::getThreadPool().getMaxThreads();
+  leaders.assign(maxThreads, -1);
+  descriptors.assign(maxThreads, std::vector<int>());
+  perfCountersOn = true;
+#else
+  if (substrate::EnvCheck("GALOIS_PERF_COUNTERS")) {
+    gWarn("perf counters are only supported on Linux");
+  }
+#endif
+}
+
+void galois::runtime::internal::finishPerfCounters() {
+#ifdef __linux__
+  for (auto& fds : descriptors) {
+    for (int fd : fds) {
+      close(fd);
+    }
+  }
+#endif
+  descriptors.clear();
+  leaders.clear();
+  counters.clear();
+  perfCountersOn = false;
+}
+
+void galois::runtime::internal::readPerfCounters(PerfSample& sample) {
+  sample.valid = false;
+#ifdef __linux__
+  unsigned tid = substrate::ThreadPool::getMachineTID();
+  int& leader  = leaders[tid];
+  if (leader == -1) {
+    leader = openGroup(descriptors[tid]);
+  }
+  if (leader < 0) {
+    return;
+  }
+
+  uint64_t buf[3 + MAX_PERF_COUNTERS];
+  ssize_t expected = (3 + counters.size()) * sizeof(uint64_t);
+  if (read(leader, buf, sizeof(buf)) != expected || buf[0] != counters.size()) {
+    return;
+  }
+  sample.enabled = buf[1];
+  sample.running = buf[2];
+  std::memcpy(sample.values, buf + 3, counters.size() * sizeof(uint64_t));
+  sample.valid = true;
+#endif
+}
+
+void galois::runtime::internal::reportPerfCounters(const char* region,
+                                                   const PerfSample& begin,
+                                                   const PerfSample& end) {
+  if (!end.valid) {
+    return;
+  }
+  uint64_t enabled = end.enabled - begin.enabled;
+  uint64_t running = end.running - begin.running;
+  if (running == 0) {
+    // the group never got on the PMU during the loop
+    return;
+  }
+  // the group shared the PMU with others part of the time
+  double scale = double(enabled) / running;
+  for (size_t i = 0; i < counters.size(); ++i) {
+    reportStat_Tsum(region, counters[i].name,
+                    uint64_t((end.values[i] - begin.values[i]) * scale));
+  }
+}
+
+std::vector<std::string> galois::runtime::perfCounterNames() {
+  std::vector<std::string> names;
+  for (auto& spec : counters) {
+    names.push_back(spec.name);
+  }
+  return names;
+}
@@ -20,9 +20,64 @@
 #include "galois/runtime/Executor_OnEach.h"
 #include "galois/runtime/Mem.h"
 #include "galois/runtime/PagePool.h"
+#include "galois/gIO.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+/**
+ * Bytes the host can give out without swapping: MemAvailable, which unlike
+ * free memory includes the reclaimable page cache, or the free memory on
+ * kernels without it. 0 if unknown.
+ */
+size_t availableBytes() {
+  std::ifstream f("/proc/meminfo");
+  std::string line;
+  while (std::getline(f, line)) {
+    unsigned long long kb;
+    if (std::sscanf(line.c_str(), "MemAvailable: %llu kB", &kb) == 1) {
+      return size_t(kb) * 1024;
+    }
+  }
+  long freePages  = sysconf(_SC_AVPHYS_PAGES);
+  long osPageSize = sysconf(_SC_PAGESIZE);
+  if (freePages > 0 && osPageSize > 0) {
+    return size_t(freePages) * size_t(osPageSize);
+  }
+  return 0;
+}
+
+} // namespace
 
 void galois::runtime::preAlloc_impl(unsigned num) {
+  unsigned activeThreads  = galois::getActiveThreads();
   unsigned pagesPerThread = (num + activeThreads - 1) / activeThreads;
   substrate::getThreadPool().run(activeThreads,
                                  [=]() { pagePoolPreAlloc(pagesPerThread); });
 }
+
+unsigned galois::runtime::preAllocBytes(size_t bytes) {
+  size_t threads  = galois::getActiveThreads();
+  size_t pageSize = pagePoolSize();
+  size_t pages    = threads + (bytes + pageSize - 1) / pageSize;
+  // every thread preallocates the same number of pages
+  pages = (pages + threads - 1) / threads * threads;
+
+  if (size_t available = availableBytes()) {
+    size_t limit = available / pageSize / threads * threads;
+    if (pages > limit) {
+      galois::gWarn("preAlloc of ", pages,
+                    " pages exceeds available memory, using ", limit);
+      pages = limit;
+    }
+  }
+  if (pages) {
+    preAlloc_impl(pages);
+  }
+  return pages;
+}
@@ -29,19 +29,23 @@ galois::substrate::SharedMem::SharedMem() {
 
   // delayed initialization because both call getThreadPool in constructor
   // which is valid only after setThreadPool() above
-  m_biPtr   = std::make_unique<internal::BarrierInstance<>>();
-  m_termPtr = std::make_unique<internal::LocalTerminationDetection<>>();
+  m_biPtr      = std::make_unique<internal::BarrierInstance<>>();
+  m_termPtr    = internal::makeTerminationDetection();
+  m_subTermPtr = std::make_unique<internal::SubPoolTermination<>>();
 
   internal::setBarrierInstance(m_biPtr.get());
   internal::setTermDetect(m_termPtr.get());
+  internal::setSubPoolTermDetect(m_subTermPtr.get());
 }
 
 galois::substrate::SharedMem::~SharedMem() {
+  internal::setSubPoolTermDetect(nullptr);
   internal::setTermDetect(nullptr);
   internal::setBarrierInstance(nullptr);
 
   // destructors can call getThreadPool(), hence must be destroyed before
   // setThreadPool() below
+  m_subTermPtr.reset();
   m_termPtr.reset();
   m_biPtr.reset();
 
@@ -18,8 +18,11 @@
  */
 
 #include "galois/runtime/Statistics.h"
+#include "galois/runtime/EventTrace.h"
 #include "galois/runtime/Executor_OnEach.h"
+#include "galois/substrate/MemAccounting.h"
 
+#include <cmath>
 #include <iostream>
 #include <fstream>
 
@@ -77,6 +80,74 @@ void StatManager::print(void) {
       printStats(std::cerr);
     }
   }
+
+  std::string jsonFile;
+  if (galois::substrate::EnvCheck(JSON_ENV_VAR, jsonFile)) {
+    std::ofstream outf(jsonFile);
+    if (outf.good()) {
+      printStatsJSON(outf);
+    } else {
+      gWarn("Could not open JSON stats file for writing, file provided:",
+            jsonFile);
+    }
+  }
+
+  internal::printEventTrace();
+}
+
+namespace {
+
+void writeJSONValue(std::ostream& out, int64_t v) { out << v; }
+
+void writeJSONValue(std::ostream& out, double v) {
+  // JSON has no NaN or infinity
+  if (std::isfinite(v)) {
+    out << v;
+  } else {
+    out << "null";
+  }
+}
+
+void writeJSONValue(std::ostream& out, const Str& v) {
+  internal::writeJSONString(out, v.c_str());
+}
+
+} // namespace
+
+template <typename T>
+void StatManager::StatManagerImpl<T>::printJSON(std::ostream& out,
+                                                const char*& sep) const {
+  for (auto i = cbegin(), end_i = cend(); i != end_i; ++i) {
+    const auto& s = this->stat(i);
+
+    out << sep << "{\"kind\":\"" << statKind<T>() << "\",\"region\":";
+    internal::writeJSONString(out, this->region(i).c_str());
+    out << ",\"category\":";
+    internal::writeJSONString(out, this->category(i).c_str());
+    out << ",\"totalType\":\"" << StatTotal::str(s.totalTy())
+        << "\",\"total\":";
+    writeJSONValue(out, s.total());
+
+    out << ",\"threadValues\":[";
+    const char* vsep = "";
+    for (const auto& v : s.values()) {
+      out << vsep;
+      writeJSONValue(out, v);
+      vsep = ",";
+    }
+    out << "]}";
+    sep = ",\n";
+  }
+}
+
+void StatManager::printStatsJSON(std::ostream& out) {
+  mergeStats();
+  out << "{\"stats\":[";
+  const char* sep = "\n";
+  intStats.printJSON(out, sep);
+  fpStats.printJSON(out, sep);
+  strStats.printJSON(out, sep);
+  out << "\n]}\n";
 }
 
 void StatManager::printStats(std::ostream& out) {
@@ -133,6 +204,49 @@ void galois::runtime::reportPageAlloc(const char* category) {
       std::make_tuple());
 }
 
+void galois::runtime::reportMemUsage(const char* region) {
+  using substrate::MemCategory;
+  // read all peaks before reporting: the stat manager allocates pages itself
+  constexpr unsigned N = unsigned(MemCategory::NumCategories);
+  int64_t peaks[N];
+  for (unsigned i = 0; i < N; ++i) {
+    peaks[i] = substrate::memPeakBytes(MemCategory(i));
+  }
+  int64_t totalPeak = substrate::memTotalPeakBytes();
+
+  for (unsigned i = 0; i < N; ++i) {
+    if (peaks[i]) {
+      std::string name = substrate::memCategoryName(MemCategory(i));
+      reportStat_Single(region, name + "PeakBytes", peaks[i]);
+    }
+  }
+  reportStat_Single(region, "TotalPeakBytes", totalPeak);
+}
+
+void galois::runtime::reportWakeupStats(const char* region) {
+  auto& tp = substrate::getThreadPool();
+  // take the stats before the reporting loop wakes the threads up again
+  std::vector<substrate::ThreadPool::WakeupStats> stats;
+  for (unsigned i = 0; i < tp.getMaxThreads(); ++i) {
+    stats.push_back(tp.getWakeupStats(i));
+  }
+  tp.resetWakeupStats();
+
+  galois::runtime::on_each_gen(
+      [&](const unsigned int tid, const unsigned int) {
+        const auto& s = stats[tid];
+        if (s.wakeups == 0) {
+          return;
+        }
+        reportStat_Tsum(region, "Wakeups", s.wakeups);
+        reportStat_Tsum(region, "Sleeps", s.sleeps);
+        reportStat_Tavg(region, "WakeupLatencyNs",
+                        s.totalLatencyNs / s.wakeups);
+        reportStat_Tmax(region, "MaxWakeupLatencyNs", s.maxLatencyNs);
+      },
+      std::make_tuple());
+}
+
 void galois::runtime::reportNumaAlloc(const char*) {
   galois::gWarn("reportNumaAlloc NOT IMPLEMENTED YET. TBD");
   int nodes = substrate::getThreadPool().getMaxNumaNodes();
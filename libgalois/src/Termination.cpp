@@ -18,8 +18,11 @@
  */
 
 #include "galois/gIO.h"
+#include "galois/substrate/EnvCheck.h"
 #include "galois/substrate/Termination.h"
 
+#include <string>
+
 // vtable anchoring
 galois::substrate::TerminationDetection::~TerminationDetection(void) {}
 
@@ -31,8 +34,37 @@ void galois::substrate::internal::setTermDetect(
   TERM = t;
 }
 
+std::unique_ptr<galois::substrate::TerminationDetection>
+galois::substrate::internal::makeTerminationDetection() {
+  std::string kind;
+  if (EnvCheck("GALOIS_TERMINATION", kind)) {
+    if (kind == "ring") {
+      return std::make_unique<LocalTerminationDetection<>>();
+    } else if (kind == "tree") {
+      return std::make_unique<TreeTerminationDetection<>>();
+    } else if (kind != "hierarchical") {
+      gWarn("unknown GALOIS_TERMINATION ", kind, ", using hierarchical");
+    }
+  }
+  return std::make_unique<HierarchicalTerminationDetection<>>();
+}
+
+static galois::substrate::internal::SubPoolTermination<>* SUBTERMS = nullptr;
+
+void galois::substrate::internal::setSubPoolTermDetect(
+    galois::substrate::internal::SubPoolTermination<>* t) {
+  GALOIS_ASSERT(!(SUBTERMS && t),
+                "Double initialization of sub-pool TerminationDetection");
+  SUBTERMS = t;
+}
+
 galois::substrate::TerminationDetection&
 galois::substrate::getSystemTermination(unsigned activeThreads) {
+  if (ThreadPool::inSubPool()) {
+    TerminationDetection& t = SUBTERMS->get(ThreadPool::getPoolBase());
+    t.init(activeThreads);
+    return t;
+  }
   TERM->init(activeThreads);
   return *TERM;
 }
@@ -23,7 +23,17 @@
 #include "galois/gIO.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 // Forward declare this to avoid including PerThreadStorage.
 // We avoid this to stress that the thread Pool MUST NOT depend on PTS.
@@ -37,9 +47,101 @@ using galois::substrate::ThreadPool;
 
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
+namespace {
+
+constexpr uint64_t SPIN_FOREVER = std::numeric_limits<uint64_t>::max();
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+//! number of pause instructions that take about a microsecond
+double calibratePause() {
+  constexpr int N = 2000;
+  auto begin      = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; ++i) {
+    galois::substrate::asmPause();
+  }
+  double us = std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - begin)
+                  .count();
+  return us > 0 ? std::max(1.0, N / us) : N;
+}
+
+#ifdef __linux__
+int* futexWord(std::atomic<int>& a) {
+  static_assert(sizeof(std::atomic<int>) == sizeof(int),
+                "futex needs a plain int");
+  return reinterpret_cast<int*>(&a);
+}
+#endif
+
+} // namespace
+
+void ThreadPool::per_signal::wakeup() {
+  done = 0;
+  if (release.exchange(1) == 2) {
+#ifdef __linux__
+    syscall(SYS_futex, futexWord(release), FUTEX_WAKE_PRIVATE, 1, nullptr,
+            nullptr, 0);
+#else
+    std::lock_guard<std::mutex> lg(m);
+    cv.notify_one();
+#endif
+  }
+}
+
+bool ThreadPool::per_signal::wait() {
+  uint64_t n = spinIters.load(std::memory_order_relaxed);
+  for (uint64_t i = 0; i < n; ++i) {
+    if (release.load(std::memory_order_acquire) == 1) {
+      release.store(0, std::memory_order_relaxed);
+      return false;
+    }
+    asmPause();
+  }
+
+  int expected = 0;
+  if (!release.compare_exchange_strong(expected, 2)) {
+    // released between the last spin and now; no need to block
+    release.store(0, std::memory_order_relaxed);
+    return false;
+  }
+#ifdef __linux__
+  while (release.load(std::memory_order_acquire) == 2) {
+    syscall(SYS_futex, futexWord(release), FUTEX_WAIT_PRIVATE, 2, nullptr,
+            nullptr, 0);
+  }
+#else
+  std::unique_lock<std::mutex> lg(m);
+  cv.wait(lg, [this] { return release.load() != 2; });
+#endif
+  release.store(0, std::memory_order_relaxed);
+  return true;
+}
+
 ThreadPool::ThreadPool()
-    : mi(getHWTopo().machineTopoInfo), reserved(0), masterFastmode(false),
-      running(false) {
+    : mi(getHWTopo().machineTopoInfo), reserved(0), running(false),
+      policy(IdlePolicy::Sleep), spinMicros(50), pausesPerMicro(1),
+      pinned(0), runStartNs(0) {
+  std::string p;
+  if (EnvCheck("GALOIS_IDLE_POLICY", p)) {
+    if (p == "spin") {
+      policy = IdlePolicy::Spin;
+    } else if (p == "hybrid") {
+      policy = IdlePolicy::Hybrid;
+    } else if (p != "sleep") {
+      gWarn("unknown GALOIS_IDLE_POLICY ", p, ", using sleep");
+    }
+  }
+  int micros = spinMicros;
+  if (EnvCheck("GALOIS_IDLE_SPIN_US", micros)) {
+    spinMicros = std::max(micros, 0);
+  }
+  pausesPerMicro = calibratePause();
+
   signals.resize(mi.maxThreads);
   initThread(0);
 
@@ -63,27 +165,66 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::destroyCommon() {
-  beKind(); // reset fastmode
   run(mi.maxThreads, []() { throw shutdown_ty(); });
 }
 
-void ThreadPool::burnPower(unsigned num) {
-  num = std::min(num, getMaxUsableThreads());
+uint64_t ThreadPool::idleSpinIters(unsigned tid) const {
+  if (tid < pinned) {
+    return SPIN_FOREVER;
+  }
+  switch (policy) {
+  case IdlePolicy::Spin:
+    return SPIN_FOREVER;
+  case IdlePolicy::Sleep:
+    return 0;
+  default:
+    return uint64_t(spinMicros * pausesPerMicro);
+  }
+}
 
-  // changing number of threads?  just do a reset
-  if (masterFastmode && masterFastmode != num) {
-    beKind();
+void ThreadPool::applyIdlePolicy() {
+  for (unsigned i = 0; i < mi.maxThreads; ++i) {
+    signals[i]->spinIters.store(idleSpinIters(i), std::memory_order_relaxed);
   }
-  if (!masterFastmode) {
-    run(num, []() { throw fastmode_ty{true}; });
-    masterFastmode = num;
+}
+
+void ThreadPool::cycleThreads(unsigned num) {
+  // threads read their spin window when they start waiting, so wake up
+  // those that are spinning or blocked under the old one
+  if (num > 1) {
+    run(num, []() {});
   }
 }
 
-void ThreadPool::beKind() {
-  if (masterFastmode) {
-    run(masterFastmode, []() { throw fastmode_ty{false}; });
-    masterFastmode = 0;
+void ThreadPool::setIdlePolicy(IdlePolicy p, unsigned micros) {
+  GALOIS_ASSERT(!running, "Can't change idle policy during parallel section");
+  policy     = p;
+  spinMicros = micros;
+  applyIdlePolicy();
+  cycleThreads(getMaxUsableThreads());
+}
+
+void ThreadPool::pinThreads(unsigned num) {
+  GALOIS_ASSERT(!running, "Can't pin threads during parallel section");
+  num          = std::min(num, getMaxUsableThreads());
+  unsigned old = pinned;
+  pinned       = num;
+  applyIdlePolicy();
+  cycleThreads(std::max(old, num));
+}
+
+ThreadPool::WakeupStats ThreadPool::getWakeupStats(unsigned tid) const {
+  const per_signal& s = *signals[tid];
+  return WakeupStats{s.wakeups, s.sleeps, s.totalLatencyNs, s.maxLatencyNs};
+}
+
+void ThreadPool::resetWakeupStats() {
+  GALOIS_ASSERT(!running, "Can't reset stats during parallel section");
+  for (auto* s : signals) {
+    s->wakeups        = 0;
+    s->sleeps         = 0;
+    s->totalLatencyNs = 0;
+    s->maxLatencyNs   = 0;
   }
 }
 
@@ -118,6 +259,14 @@ static T* getNth(std::atomic<T*>& headptr, unsigned off) {
 void ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
   my_box.topo  = getHWTopo().threadTopoInfo[tid];
+  my_box.view  = my_box.topo;
+  my_box.pool  = nullptr;
+  my_box.release.store(0);
+  my_box.spinIters.store(idleSpinIters(tid));
+  my_box.wakeups        = 0;
+  my_box.sleeps         = 0;
+  my_box.totalLatencyNs = 0;
+  my_box.maxLatencyNs   = 0;
   // Initialize
   substrate::initPTS(mi.maxThreads);
 
@@ -131,17 +280,21 @@ void ThreadPool::initThread(unsigned tid) {
 
 void ThreadPool::threadLoop(unsigned tid) {
   initThread(tid);
-  bool fastmode = false;
-  auto& me      = my_box;
+  auto& me = my_box;
   do {
-    me.wait(fastmode);
-    cascade(fastmode);
+    bool slept   = me.wait();
+    uint64_t now = nowNs();
+    uint64_t lat = now > runStartNs ? now - runStartNs : 0;
+    ++me.wakeups;
+    me.sleeps += slept;
+    me.totalLatencyNs += lat;
+    me.maxLatencyNs = std::max(me.maxLatencyNs, lat);
+
+    cascade();
     try {
       work();
     } catch (const shutdown_ty&) {
       return;
-    } catch (const fastmode_ty& fm) {
-      fastmode = fm.mode;
     } catch (const dedicated_ty dt) {
       me.done = 1;
       dt.fn();
@@ -176,7 +329,7 @@ void ThreadPool::decascade() {
   me.done = 1;
 }
 
-void ThreadPool::cascade(bool fastmode) {
+void ThreadPool::cascade() {
   auto& me = my_box;
   assert(me.wbegin <= me.wend);
 
@@ -190,13 +343,13 @@ void ThreadPool::cascade(bool fastmode) {
   auto child1    = signals[me.wbegin];
   child1->wbegin = me.wbegin + 1;
   child1->wend   = midpoint;
-  child1->wakeup(fastmode);
+  child1->wakeup();
 
   if (midpoint < me.wend) {
     auto child2    = signals[midpoint];
     child2->wbegin = midpoint + 1;
     child2->wend   = me.wend;
-    child2->wakeup(fastmode);
+    child2->wakeup();
   }
 }
 
@@ -211,15 +364,14 @@ void ThreadPool::runInternal(unsigned num) {
   me.wbegin = 1;
   me.wend   = num;
 
-  assert(!masterFastmode || masterFastmode == num);
+  runStartNs = nowNs();
   // launch threads
-  cascade(masterFastmode);
+  cascade();
   // Do master thread work
   try {
     work();
   } catch (const shutdown_ty&) {
     return;
-  } catch (const fastmode_ty& fm) {
   }
   // wait for children
   decascade();
@@ -228,6 +380,109 @@ void ThreadPool::runInternal(unsigned num) {
   running = false;
 }
 
+void ThreadPool::runSubPool(SubPool& pool, unsigned num) {
+  GALOIS_ASSERT(!pool.running, "Recursive thread pool execution not supported");
+  pool.running = true;
+  pool.num     = std::min(std::max(1U, num), pool.size);
+  pool.pending = pool.num - 1;
+  // publishes work and num to the other threads of the sub-pool
+  pool.generation.fetch_add(1);
+  pool.work();
+  while (pool.pending.load(std::memory_order_acquire)) {
+    asmPause();
+  }
+  pool.work    = nullptr;
+  pool.running = false;
+}
+
+void ThreadPool::subPoolLoop(SubPool& pool) {
+  auto& me      = my_box;
+  unsigned seen = 0;
+  while (true) {
+    // spin like an idle thread of the pool, then give the core away
+    uint64_t spins = me.spinIters.load(std::memory_order_relaxed);
+    unsigned g;
+    for (uint64_t i = 0;
+         (g = pool.generation.load(std::memory_order_acquire)) == seen; ++i) {
+      if (i < spins) {
+        asmPause();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    seen = g;
+    if (pool.exit) {
+      return;
+    }
+    if (me.view.tid < pool.num) {
+      pool.work();
+      pool.pending.fetch_sub(1, std::memory_order_release);
+    }
+  }
+}
+
+void ThreadPool::runSubPools(const std::vector<unsigned>& sizes,
+                             const std::function<void(unsigned)>& fn) {
+  GALOIS_ASSERT(!running && !my_box.pool,
+                "Can't start sub-pools during parallel section");
+
+  std::vector<std::unique_ptr<SubPool>> pools;
+  unsigned total = 0;
+  for (unsigned size : sizes) {
+    GALOIS_ASSERT(size > 0, "Sub-pools need at least one thread");
+    auto pool        = std::make_unique<SubPool>();
+    pool->base       = total;
+    pool->size       = size;
+    pool->num        = 0;
+    pool->running    = false;
+    pool->exit       = false;
+    pool->generation = 0;
+    pool->pending    = 0;
+    total += size;
+    pools.push_back(std::move(pool));
+  }
+  GALOIS_ASSERT(total <= getMaxUsableThreads(),
+                "Sub-pools need more threads than available");
+
+  // renumber threads and sockets from 0 in each sub-pool
+  std::vector<unsigned> owner;
+  for (unsigned p = 0; p < pools.size(); ++p) {
+    SubPool& pool = *pools[p];
+    std::map<unsigned, unsigned> sockets;
+    std::map<unsigned, unsigned> leaders;
+    unsigned maxSocket = 0;
+    for (unsigned i = 0; i < pool.size; ++i) {
+      ThreadTopoInfo v = signals[pool.base + i]->topo;
+      unsigned socket = sockets.emplace(v.socket, sockets.size()).first->second;
+      unsigned leader = leaders.emplace(v.socket, i).first->second;
+      maxSocket       = std::max(maxSocket, socket);
+      v.tid                 = i;
+      v.socket              = socket;
+      v.socketLeader        = leader;
+      v.cumulativeMaxSocket = maxSocket;
+      pool.views.push_back(v);
+      owner.push_back(p);
+    }
+  }
+
+  run(total, [&]() {
+    auto& me      = my_box;
+    unsigned p    = owner[me.topo.tid];
+    SubPool& pool = *pools[p];
+    me.view       = pool.views[me.topo.tid - pool.base];
+    me.pool       = &pool;
+    if (me.view.tid == 0) {
+      fn(p);
+      pool.exit = true;
+      pool.generation.fetch_add(1);
+    } else {
+      subPoolLoop(pool);
+    }
+    me.view = me.topo;
+    me.pool = nullptr;
+  });
+}
+
 void ThreadPool::runDedicated(std::function<void(void)>& f) {
   // TODO(ddn): update galois::runtime::activeThreads to reflect the dedicated
   // thread but we don't want to depend on galois::runtime symbols and too many
@@ -242,7 +497,8 @@ void ThreadPool::runDedicated(std::function<void(void)>& f) {
   child->wbegin = 0;
   child->wend   = 0;
   child->done   = 0;
-  child->wakeup(masterFastmode);
+  runStartNs    = nowNs();
+  child->wakeup();
   while (!child->done) {
     asmPause();
   }
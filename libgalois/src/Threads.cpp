@@ -20,7 +20,10 @@
 #include "galois/substrate/ThreadPool.h"
 #include "galois/Threads.h"
 
+#include "galois/gIO.h"
+
 #include <algorithm>
+#include <numeric>
 namespace galois {
 namespace runtime {
 unsigned int activeThreads = 1;
@@ -35,5 +38,31 @@ unsigned int galois::setActiveThreads(unsigned int num) noexcept {
 }
 
 unsigned int galois::getActiveThreads() noexcept {
+  if (galois::substrate::ThreadPool::inSubPool()) {
+    return galois::substrate::getThreadPool().getPoolSize();
+  }
   return galois::runtime::activeThreads;
 }
+
+void galois::on_each_subpool(
+    const std::vector<unsigned>& sizes,
+    const std::function<void(unsigned, unsigned)>& fn) {
+  unsigned total = std::accumulate(sizes.begin(), sizes.end(), 0u);
+  GALOIS_ASSERT(total <= galois::getActiveThreads(),
+                "sub-pools need more than the active threads");
+  unsigned num = sizes.size();
+  galois::substrate::getThreadPool().runSubPools(
+      sizes, [&](unsigned pool) { fn(pool, num); });
+}
+
+std::vector<unsigned> galois::socketSubpoolSizes() {
+  auto& tp = galois::substrate::getThreadPool();
+  std::vector<unsigned> sizes;
+  for (unsigned i = 0; i < galois::getActiveThreads(); ++i) {
+    if (i == 0 || tp.getSocket(i) != tp.getSocket(i - 1)) {
+      sizes.push_back(0);
+    }
+    ++sizes.back();
+  }
+  return sizes;
+}
@@ -0,0 +1,111 @@
+#include "galois/Galois.h"
+#include "galois/runtime/EventTrace.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+//! total of stat category of region in the JSON stats
+double statTotal(const std::string& stats, const std::string& region,
+                 const std::string& category) {
+  std::string key = "\"region\":\"" + region + "\",\"category\":\"" +
+                    category + "\",";
+  size_t pos = stats.find(key);
+  GALOIS_ASSERT(pos != std::string::npos, "no stat ", region, " ", category);
+  pos = stats.find("\"total\":", pos);
+  return std::atof(stats.c_str() + pos + 8);
+}
+
+void spin(uint64_t ticks) {
+  uint64_t start = galois::runtime::readTSC();
+  while (galois::runtime::readTSC() - start < ticks) {
+  }
+}
+
+//! The chunk size policy, with fixed chunk times
+void testPolicy() {
+  using galois::runtime::AdaptiveChunkSize;
+  const uint64_t target = AdaptiveChunkSize::TARGET_TICKS;
+
+  AdaptiveChunkSize cheap(32, 512);
+  for (int i = 0; i < 10; ++i) {
+    cheap.stop(cheap.get(), target / 8);
+  }
+  GALOIS_ASSERT(cheap.get() == 512);
+
+  AdaptiveChunkSize expensive(32, 512);
+  for (int i = 0; i < 10; ++i) {
+    expensive.stop(expensive.get(), 8 * target);
+  }
+  GALOIS_ASSERT(expensive.get() == 1);
+
+  // within a factor of two of the target the size stays put
+  AdaptiveChunkSize steady(32, 512);
+  steady.stop(32, target);
+  steady.stop(16, target);
+  GALOIS_ASSERT(steady.get() == 32);
+
+  steady.contended();
+  GALOIS_ASSERT(steady.get() == 16);
+  steady.stop(0, 0);
+  GALOIS_ASSERT(steady.get() == 16);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  testPolicy();
+
+  const unsigned cheap = 1 << 20;
+  galois::GAccumulator<unsigned> count;
+  galois::do_all(
+      galois::iterate(0u, cheap), [&](unsigned) { count += 1; },
+      galois::steal(), galois::adaptive_chunk_size(),
+      galois::loopname("cheap"));
+  GALOIS_ASSERT(count.reduce() == cheap);
+
+  // a chain of pushes visits every item once with any chunk size
+  for (unsigned work : {0u, 16u}) {
+    count.reset();
+    std::string name = "adaptiveForEach" + std::to_string(work);
+    galois::for_each(
+        galois::iterate(0u, 1000u),
+        [&](unsigned i, auto& ctx) {
+          spin(work * galois::runtime::AdaptiveChunkSize::TARGET_TICKS / 64);
+          count += 1;
+          if (i < 100000) {
+            ctx.push(i + 1000);
+          }
+        },
+        galois::loopname(name.c_str()),
+        galois::wl<galois::worklists::AdaptivePerSocketChunkFIFO<512>>());
+    GALOIS_ASSERT(count.reduce() == 101000);
+  }
+
+  count.reset();
+  galois::for_each(
+      galois::iterate(0u, 1000u),
+      [&](unsigned i, auto& ctx) {
+        count += 1;
+        if (i < 100000) {
+          ctx.push(i + 1000);
+        }
+      },
+      galois::loopname("adaptiveLIFO"),
+      galois::wl<galois::worklists::AdaptivePerSocketChunkLIFO<>>());
+  GALOIS_ASSERT(count.reduce() == 101000);
+
+  // stats are merged once, after all loops ran; FIFO chunks hold at most 512
+  // items and every item passes through one
+  std::ostringstream os;
+  galois::runtime::internal::sysStatManager()->printStatsJSON(os);
+  std::string stats = os.str();
+  for (const char* name : {"adaptiveForEach0", "adaptiveForEach16"}) {
+    GALOIS_ASSERT(statTotal(stats, name, "ChunkSize") <= 512);
+    GALOIS_ASSERT(statTotal(stats, name, "Chunks") >= 101000 / 512);
+  }
+  GALOIS_ASSERT(statTotal(stats, "adaptiveLIFO", "Chunks") > 0);
+
+  return 0;
+}
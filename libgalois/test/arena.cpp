@@ -0,0 +1,81 @@
+#include "galois/Galois.h"
+#include "galois/Arena.h"
+#include "galois/Reduction.h"
+
+#include <map>
+#include <numeric>
+#include <vector>
+
+void testRewind() {
+  galois::ArenaHeapTy heap;
+  void* small = heap.allocate(10);
+  auto c      = heap.checkpoint();
+  void* mid   = heap.allocate(100);
+  // larger than a chunk
+  void* big = heap.allocate(galois::runtime::SystemHeap::AllocSize);
+  GALOIS_ASSERT(small != mid && big);
+  heap.rewind(c);
+  GALOIS_ASSERT(heap.allocate(100) == mid);
+
+  // fill more than a chunk, then check the chunks are reused after a reset
+  std::vector<void*> ptrs;
+  for (size_t i = 0; i < 3 * galois::runtime::SystemHeap::AllocSize / 4096;
+       ++i) {
+    ptrs.push_back(heap.allocate(4096));
+  }
+  heap.reset();
+  GALOIS_ASSERT(heap.allocate(10) == small);
+  GALOIS_ASSERT(heap.allocate(100) == mid);
+  for (size_t i = 0; i < ptrs.size(); ++i) {
+    GALOIS_ASSERT(heap.allocate(4096) == ptrs[i]);
+  }
+  GALOIS_ASSERT(heap.numRewinds() == 2);
+}
+
+void testContainers() {
+  galois::PerThreadArena arena;
+  galois::GAccumulator<size_t> errors;
+  for (int round = 0; round < 3; ++round) {
+    galois::do_all(galois::iterate(0, 10000), [&](int i) {
+      galois::ArenaScope scope(arena);
+      std::vector<int, galois::ArenaAllocator<int>> v(scope.allocator());
+      std::map<int, int, std::less<int>,
+               galois::ArenaAllocator<std::pair<const int, int>>>
+          m(scope.allocator());
+      for (int j = 0; j < i % 100; ++j) {
+        v.push_back(j);
+        m[j % 7] += j;
+      }
+      int sum = 0;
+      for (auto& kv : m) {
+        sum += kv.second;
+      }
+      if (sum != std::accumulate(v.begin(), v.end(), 0)) {
+        errors += 1;
+      }
+    });
+    arena.reset();
+  }
+  GALOIS_ASSERT(errors.reduce() == 0);
+
+  size_t served = 0;
+  size_t resets = 0;
+  galois::on_each([&](unsigned, unsigned) {
+    __atomic_fetch_add(&served, arena.local().bytesServed(), __ATOMIC_RELAXED);
+    __atomic_fetch_add(&resets, arena.local().numRewinds(), __ATOMIC_RELAXED);
+  });
+  GALOIS_ASSERT(served > 0);
+  // one rewind per iteration plus the resets
+  GALOIS_ASSERT(resets >= 3 * 10000);
+  arena.reportStats("ArenaTest");
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  testRewind();
+  testContainers();
+  return 0;
+}
@@ -0,0 +1,74 @@
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
+
+#include <algorithm>
+#include <vector>
+
+void testRecycle() {
+  galois::InsertBag<int> bag;
+  galois::on_each([&](unsigned tid, unsigned) { bag.push(tid); });
+  std::vector<int*> firsts;
+  for (auto& x : bag) {
+    firsts.push_back(&x);
+  }
+
+  // refilled bags reuse the blocks of each thread
+  bag.clear();
+  GALOIS_ASSERT(bag.empty() && bag.size() == 0);
+  galois::on_each([&](unsigned tid, unsigned) { bag.push(tid); });
+  std::vector<int*> again;
+  for (auto& x : bag) {
+    again.push_back(&x);
+  }
+  GALOIS_ASSERT(firsts == again);
+
+  bag.clear_serial();
+  bag.shrink_to_fit();
+  GALOIS_ASSERT(bag.empty());
+}
+
+void testToArray(size_t n) {
+  galois::InsertBag<uint32_t> bag;
+  galois::do_all(galois::iterate(size_t{0}, n),
+                 [&](size_t i) { bag.push(uint32_t(i % 1000)); });
+  GALOIS_ASSERT(bag.size() == n);
+
+  galois::LargeArray<uint32_t> arr;
+  bag.to_array(arr);
+  GALOIS_ASSERT(arr.size() == n);
+  GALOIS_ASSERT(std::equal(bag.begin(), bag.end(), arr.begin()));
+
+  // refill the same array
+  bag.clear();
+  bag.push(7);
+  bag.to_array(arr);
+  GALOIS_ASSERT(arr.size() == 1 && arr[0] == 7);
+  bag.clear();
+  galois::do_all(galois::iterate(size_t{0}, n),
+                 [&](size_t i) { bag.push(uint32_t(i % 1000)); });
+
+  galois::LargeArray<uint32_t> uniq;
+  bag.to_unique_array(uniq);
+  size_t expected = std::min<size_t>(n, 1000);
+  GALOIS_ASSERT(uniq.size() == expected);
+  for (size_t i = 0; i < expected; ++i) {
+    GALOIS_ASSERT(uniq[i] == i);
+  }
+
+  bag.to_unique_array(uniq, std::greater<uint32_t>());
+  GALOIS_ASSERT(uniq.size() == expected);
+  GALOIS_ASSERT(expected == 0 || uniq[0] == expected - 1);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  testRecycle();
+  testToArray(0);
+  testToArray(10);
+  testToArray(1000000);
+  return 0;
+}
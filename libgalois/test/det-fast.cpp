@@ -0,0 +1,90 @@
+#include "galois/Galois.h"
+#include "galois/Timer.h"
+#include "galois/runtime/Context.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+struct Node : public galois::runtime::Lockable {
+  unsigned value;
+};
+
+constexpr unsigned DEGREE = 4;
+
+//! pseudo-random neighbors, the same in every run
+unsigned neighbor(unsigned n, unsigned k, unsigned size) {
+  uint64_t x = (uint64_t(n) * DEGREE + k + 1) * 0x9E3779B97F4A7C15ull;
+  return (x >> 33) % size;
+}
+
+/**
+ * Each item sets its node to one more than the largest value around it, so
+ * the result depends on the order of the iterations. The first visit of a
+ * node pushes a second one.
+ */
+template <typename... Args>
+uint64_t run(std::vector<Node>& nodes, const char* name, Args&&... args) {
+  unsigned size = nodes.size();
+  for (auto& n : nodes) {
+    n.value = 0;
+  }
+
+  galois::Timer t;
+  t.start();
+  galois::for_each(
+      galois::iterate(0u, size),
+      [&](unsigned item, auto& ctx) {
+        unsigned n = item % size;
+        galois::runtime::acquire(&nodes[n], galois::MethodFlag::WRITE);
+        for (unsigned k = 0; k < DEGREE; ++k) {
+          galois::runtime::acquire(&nodes[neighbor(n, k, size)],
+                                   galois::MethodFlag::WRITE);
+        }
+        ctx.cautiousPoint();
+
+        unsigned v = nodes[n].value;
+        for (unsigned k = 0; k < DEGREE; ++k) {
+          v = std::max(v, nodes[neighbor(n, k, size)].value);
+        }
+        nodes[n].value = v + 1;
+        if (item < size) {
+          ctx.push(item + size);
+        }
+      },
+      galois::loopname(name), std::forward<Args>(args)...);
+  t.stop();
+
+  uint64_t hash = 0;
+  for (auto& n : nodes) {
+    hash = hash * 31 + n.value;
+  }
+  std::cout << name << " time(ms): " << t.get() << " hash: " << hash << "\n";
+  return hash;
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  unsigned size = argc > 1 ? std::atoi(argv[1]) : 100000;
+  unsigned numThreads =
+      galois::setActiveThreads(galois::substrate::getThreadPool()
+                                   .getMaxUsableThreads());
+  std::vector<Node> nodes(size);
+  using DWL = galois::worklists::Deterministic<>;
+
+  run(nodes, "NonDet");
+  uint64_t det = run(nodes, "Det", galois::wl<DWL>());
+  uint64_t fast = run(nodes, "DetFast", galois::wl<DWL>(), galois::det_fast());
+
+  // the same answer again and with any number of threads
+  GALOIS_ASSERT(run(nodes, "DetFast", galois::wl<DWL>(), galois::det_fast()) ==
+                fast);
+  if (numThreads > 1) {
+    galois::setActiveThreads(1);
+    GALOIS_ASSERT(run(nodes, "Det1", galois::wl<DWL>()) == det);
+    GALOIS_ASSERT(run(nodes, "DetFast1", galois::wl<DWL>(),
+                      galois::det_fast()) == fast);
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include "galois/Galois.h"
+#include "galois/DynamicBitset.h"
+#include "galois/Timer.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+//! bits set with probability 1 / (1 << sparsity), the same in every run
+void fill(galois::DynamicBitSet& bs, std::vector<char>& ref, unsigned sparsity,
+          uint64_t seed) {
+  uint64_t x = seed * 0x9E3779B97F4A7C15ull + 1;
+  ref.assign(bs.size(), 0);
+  bs.reset();
+  for (size_t i = 0; i < bs.size(); ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    if ((x & ((1u << sparsity) - 1)) == 0) {
+      bs.set(i);
+      ref[i] = 1;
+    }
+  }
+}
+
+void check(const galois::DynamicBitSet& bs, const std::vector<char>& ref) {
+  std::vector<uint32_t> expected;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    if (ref[i]) {
+      expected.push_back(i);
+    }
+  }
+
+  GALOIS_ASSERT(bs.count() == expected.size());
+  GALOIS_ASSERT(bs.getOffsets() == expected);
+
+  std::vector<uint32_t> iterated(bs.begin_set(), bs.end_set());
+  GALOIS_ASSERT(iterated == expected);
+
+  galois::DynamicBitSet::PrefixIndex index;
+  bs.build_index(index);
+  GALOIS_ASSERT(index.count() == expected.size());
+  uint64_t before = 0;
+  for (size_t i = 0; i <= ref.size(); ++i) {
+    if (i % 61 == 0 || i == ref.size()) {
+      GALOIS_ASSERT(bs.rank(index, i) == before, "rank of ", i);
+    }
+    before += i < ref.size() && ref[i];
+  }
+
+  std::vector<char> visited(ref.size(), 0);
+  galois::GAccumulator<size_t> visits;
+  bs.do_all_set([&](size_t i) {
+    visited[i] = 1;
+    visits += 1;
+  });
+  GALOIS_ASSERT(visits.reduce() == expected.size());
+  GALOIS_ASSERT(visited == ref);
+}
+
+void testSize(size_t size) {
+  galois::DynamicBitSet a;
+  galois::DynamicBitSet b;
+  galois::DynamicBitSet c;
+  a.resize(size);
+  b.resize(size);
+  c.resize(size);
+  std::vector<char> ra;
+  std::vector<char> rb;
+  std::vector<char> rc(size);
+
+  for (unsigned sparsity : {0u, 1u, 4u, 9u}) {
+    fill(a, ra, sparsity, size + sparsity);
+    check(a, ra);
+    fill(b, rb, 2, size * 3 + sparsity);
+
+    c.bitwise_and(a, b);
+    for (size_t i = 0; i < size; ++i) {
+      rc[i] = ra[i] && rb[i];
+    }
+    check(c, rc);
+
+    c.bitwise_xor(a, b);
+    for (size_t i = 0; i < size; ++i) {
+      rc[i] = ra[i] != rb[i];
+    }
+    check(c, rc);
+
+    c.bitwise_or(a);
+    for (size_t i = 0; i < size; ++i) {
+      rc[i] = rc[i] || ra[i];
+    }
+    check(c, rc);
+
+    c.bitwise_and(b);
+    for (size_t i = 0; i < size; ++i) {
+      rc[i] = rc[i] && rb[i];
+    }
+    check(c, rc);
+
+    c.bitwise_xor(a);
+    for (size_t i = 0; i < size; ++i) {
+      rc[i] = rc[i] != ra[i];
+    }
+    check(c, rc);
+  }
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  constexpr size_t block = galois::DynamicBitSet::block_words * 64;
+  for (size_t size : {size_t(0), size_t(1), size_t(63), size_t(64),
+                      size_t(65), block - 1, block, block + 1,
+                      3 * block + 100}) {
+    testSize(size);
+  }
+
+  size_t size = argc > 1 ? std::atol(argv[1]) : (1 << 24);
+  galois::DynamicBitSet bs;
+  bs.resize(size);
+  std::vector<char> ref;
+  fill(bs, ref, 4, 1);
+
+  galois::Timer t;
+  t.start();
+  std::vector<uint32_t> offsets = bs.getOffsets();
+  t.stop();
+  std::cout << "getOffsets of " << offsets.size() << " of " << size
+            << " bits time(ms): " << t.get() << "\n";
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include "galois/Galois.h"
+#include "galois/graphs/DynamicCSRGraph.h"
+#include "galois/graphs/ReadGraph.h"
+
+#include <csignal>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+using Graph   = galois::graphs::DynamicCSRGraph<unsigned, unsigned>;
+using Edge    = std::pair<Graph::GraphNode, Graph::GraphNode>;
+using EdgeMap = std::map<Edge, unsigned>;
+
+static const unsigned numNodes = 500;
+
+void check(Graph& g, const EdgeMap& expected) {
+  EdgeMap actual;
+  for (auto n : g) {
+    size_t degree = 0;
+    for (auto e : g.edges(n)) {
+      auto inserted =
+          actual.emplace(Edge(n, g.getEdgeDst(e)), g.getEdgeData(e)).second;
+      GALOIS_ASSERT(inserted, "duplicate edge ", n, " -> ", g.getEdgeDst(e));
+      ++degree;
+    }
+    GALOIS_ASSERT(degree == g.getDegree(n));
+  }
+  GALOIS_ASSERT(actual == expected);
+  GALOIS_ASSERT(g.sizeEdges() == expected.size());
+}
+
+void readInitialGraph(Graph& g, EdgeMap& expected, std::mt19937& gen) {
+  std::uniform_int_distribution<unsigned> node(0, numNodes - 1);
+  for (unsigned i = 0; i < numNodes * 4; ++i) {
+    expected[Edge(node(gen), node(gen))] = i;
+  }
+
+  galois::graphs::FileGraphWriter w;
+  w.setNumNodes(numNodes);
+  w.setNumEdges<unsigned>(expected.size());
+  w.phase1();
+  for (auto& kv : expected) {
+    w.incrementDegree(kv.first.first);
+  }
+  w.phase2();
+  for (auto& kv : expected) {
+    w.addNeighbor<unsigned>(kv.first.first, kv.first.second, kv.second);
+  }
+  w.finish<unsigned>();
+
+  galois::graphs::readGraph(g, w);
+}
+
+//! Inserts an edge to a node that does not exist, which must die; the abort
+//! of GALOIS_DIE ends the process successfully
+int insertBadDst() {
+  std::signal(SIGABRT, [](int) { _exit(0); });
+  Graph g(numNodes);
+  std::vector<Graph::EdgeUpdate> inserts{{0, 1, 0}, {1, numNodes, 0}};
+  g.insertEdges(inserts);
+  return 1;
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  if (argc > 1 && std::string(argv[1]) == "bad-dst") {
+    return insertBadDst();
+  }
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<unsigned> node(0, numNodes - 1);
+
+  Graph g;
+  EdgeMap expected;
+  readInitialGraph(g, expected, gen);
+  check(g, expected);
+
+  for (unsigned round = 0; round < 20; ++round) {
+    std::vector<Graph::EdgeUpdate> inserts;
+    for (unsigned i = 0; i < 1000; ++i) {
+      // skewed sources so that some nodes spill into overflow blocks
+      Graph::GraphNode src = i % 3 ? node(gen) % 16 : node(gen);
+      inserts.push_back(Graph::EdgeUpdate{src, node(gen), round});
+    }
+    uint64_t before = expected.size();
+    for (auto& u : inserts) {
+      expected[Edge(u.src, u.dst)] = round;
+    }
+    GALOIS_ASSERT(g.insertEdges(inserts) == expected.size() - before);
+    check(g, expected);
+
+    std::vector<Graph::EdgeUpdate> deletes;
+    for (unsigned i = 0; i < 500; ++i) {
+      if (i % 2) {
+        // delete an existing edge
+        auto it = expected.begin();
+        std::advance(it, node(gen) % expected.size());
+        deletes.push_back(
+            Graph::EdgeUpdate{it->first.first, it->first.second, 0});
+      } else {
+        deletes.push_back(Graph::EdgeUpdate{node(gen), node(gen), 0});
+      }
+    }
+    before = expected.size();
+    for (auto& u : deletes) {
+      expected.erase(Edge(u.src, u.dst));
+    }
+    GALOIS_ASSERT(g.deleteEdges(deletes) == before - expected.size());
+    check(g, expected);
+
+    if (round % 5 == 4) {
+      GALOIS_ASSERT(g.sizeOverflowEdges() > 0);
+      g.compact(round % 2 ? 0.5 : 0.0);
+      GALOIS_ASSERT(g.sizeOverflowEdges() == 0);
+      check(g, expected);
+    }
+  }
+
+  Graph empty(numNodes);
+  std::vector<Graph::EdgeUpdate> inserts;
+  for (auto& kv : expected) {
+    inserts.push_back(
+        Graph::EdgeUpdate{kv.first.first, kv.first.second, kv.second});
+  }
+  GALOIS_ASSERT(empty.insertEdges(inserts, false) == expected.size());
+  check(empty, expected);
+  GALOIS_ASSERT(empty.compactIfNeeded(0.5));
+  check(empty, expected);
+
+  galois::graphs::DynamicCSRGraph<unsigned, void> unweighted(numNodes);
+  std::vector<galois::graphs::DynamicCSRGraph<unsigned, void>::EdgeUpdate>
+      edges{{0, 1}, {0, 2}, {0, 1}, {3, 0}};
+  GALOIS_ASSERT(unweighted.insertEdges(edges) == 3);
+  edges = {{0, 1}};
+  GALOIS_ASSERT(unweighted.deleteEdges(edges) == 1);
+  GALOIS_ASSERT(unweighted.getDegree(0) == 1);
+  GALOIS_ASSERT(unweighted.getEdgeDst(unweighted.edge_begin(0)) == 2);
+
+  return 0;
+}
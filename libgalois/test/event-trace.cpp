@@ -0,0 +1,73 @@
+#include "galois/Galois.h"
+#include "galois/runtime/EventTrace.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+size_t count(const std::string& s, const std::string& what) {
+  size_t n = 0;
+  for (size_t pos = s.find(what); pos != std::string::npos;
+       pos = s.find(what, pos + 1)) {
+    ++n;
+  }
+  return n;
+}
+
+int main() {
+  setenv("GALOIS_EVENT_TRACE", "event-trace.json", 1);
+  setenv("GALOIS_EVENT_TRACE_SIZE", "100000", 1);
+  galois::SharedMemSys Galois_runtime;
+  const unsigned numThreads = galois::setActiveThreads(2);
+  GALOIS_ASSERT(galois::runtime::eventTraceEnabled());
+
+  galois::GAccumulator<size_t> sum;
+  galois::do_all(
+      galois::iterate(0u, 10000u), [&](unsigned i) { sum += i; },
+      galois::steal(), galois::loopname("traced\"do_all"));
+  galois::for_each(
+      galois::iterate({1000u}),
+      [&](unsigned i, auto& ctx) {
+        if (i > 0) {
+          ctx.push(i - 1);
+        }
+      },
+      galois::loopname("tracedForEach"),
+      galois::wl<galois::worklists::PerSocketChunkFIFO<8>>());
+  // loop times are in whole milliseconds and may not be reported at all, so
+  // check the export of TMAX stats with one that does not depend on timing
+  galois::on_each([](unsigned tid, unsigned) {
+    galois::runtime::reportStat_Tmax("tracedForEach", "ThreadID", tid);
+  });
+
+  std::ostringstream trace;
+  galois::runtime::writeEventTrace(trace);
+  std::string t = trace.str();
+
+  GALOIS_ASSERT(t.find("{\"traceEvents\":[") == 0);
+  GALOIS_ASSERT(count(t, "{") == count(t, "}"));
+  GALOIS_ASSERT(count(t, "\"ph\":\"M\"") == numThreads,
+                "one track per thread");
+  // every thread runs both named loops; the quote in the name is escaped
+  GALOIS_ASSERT(count(t, "\"name\":\"traced\\\"do_all\"") == numThreads);
+  GALOIS_ASSERT(count(t, "\"name\":\"tracedForEach\"") == numThreads);
+  GALOIS_ASSERT(count(t, "\"name\":\"ANON_LOOP\"") == 0);
+  // 1001 items go through chunks of 8
+  GALOIS_ASSERT(count(t, "\"name\":\"WorklistPop\"") >= 1001 / 8);
+  GALOIS_ASSERT(count(t, "\"name\":\"Barrier\"") >= 2 * numThreads);
+  GALOIS_ASSERT(count(t, "\"name\":\"Steal\"") > 0);
+  GALOIS_ASSERT(galois::runtime::droppedTraceEvents() == 0);
+
+  std::ostringstream stats;
+  galois::runtime::internal::sysStatManager()->printStatsJSON(stats);
+  std::string s = stats.str();
+  GALOIS_ASSERT(s.find("{\"stats\":[") == 0);
+  GALOIS_ASSERT(s.find("\"region\":\"tracedForEach\",\"category\":"
+                       "\"ThreadID\",\"totalType\":\"TMAX\",\"total\":" +
+                       std::to_string(numThreads - 1)) != std::string::npos);
+  GALOIS_ASSERT(s.find("\"region\":\"tracedForEach\",\"category\":"
+                       "\"Iterations\",\"totalType\":\"TSUM\",\"total\":1001,"
+                       "\"threadValues\":[") != std::string::npos);
+
+  return 0;
+}
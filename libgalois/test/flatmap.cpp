@@ -22,6 +22,7 @@
 #include "galois/Timer.h"
 
 #include <boost/iterator/counting_iterator.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <map>
@@ -142,17 +143,59 @@ void testMap() {
   std::cout << "\n";
 }
 
+//! Checks searches against std::map on either side of the Eytzinger cutoff
+template <typename Compare>
+void testSearch() {
+  std::mt19937 mt(0);
+  std::uniform_int_distribution<int> dist(0, 1000);
+  galois::split_flat_map<int, int, Compare> m;
+  std::map<int, int, Compare> expected;
+  for (int i = 0; i < 200; ++i) {
+    int k = dist(mt);
+    m[k] += i;
+    expected[k] += i;
+    GALOIS_ASSERT(m.size() == expected.size());
+    for (int x = -1; x <= 1001; x += 7) {
+      auto ii = m.lower_bound(x);
+      auto ei = expected.lower_bound(x);
+      GALOIS_ASSERT((ii == m.end()) == (ei == expected.end()));
+      if (ei != expected.end()) {
+        GALOIS_ASSERT(ii->first == ei->first && ii->second == ei->second);
+      }
+      GALOIS_ASSERT(m.count(x) == expected.count(x));
+    }
+  }
+  GALOIS_ASSERT(std::equal(m.begin(), m.end(), expected.begin(),
+                           [](const auto& a, const auto& b) {
+                             return a.first == b.first && a.second == b.second;
+                           }));
+  for (auto& kv : expected) {
+    if (kv.first % 2) {
+      GALOIS_ASSERT(m.erase(kv.first) == 1);
+    }
+  }
+  for (auto& kv : expected) {
+    GALOIS_ASSERT((m.find(kv.first) == m.end()) == bool(kv.first % 2));
+  }
+}
+
 void timeTests(std::string prefix, const std::vector<int>& keys) {
   for (int i = 0; i < 3; ++i)
     timeMap<std::map<int, element>>(prefix + "std::map", keys);
   for (int i = 0; i < 3; ++i)
     timeMap<galois::flat_map<int, element>>(prefix + "flat_map", keys);
+  for (int i = 0; i < 3; ++i)
+    timeMap<galois::split_flat_map<int, element>>(prefix + "split_flat_map",
+                                                  keys);
 }
 
 int main(int argc, char** argv) {
   galois::SharedMemSys Galois_runtime;
   testMap<std::map<int, element>>();
   testMap<galois::flat_map<int, element>>();
+  testMap<galois::split_flat_map<int, element>>();
+  testSearch<std::less<int>>();
+  testSearch<std::greater<int>>();
   galois::setActiveThreads(8);
 
   int size = 100;
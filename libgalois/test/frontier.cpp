@@ -0,0 +1,69 @@
+#include "galois/Galois.h"
+#include "galois/Frontier.h"
+
+#include <vector>
+
+//! Visits the current frontier and checks that it is exactly expected
+void check(const galois::Frontier<uint32_t>& f,
+           const std::vector<char>& expected) {
+  size_t size = 0;
+  for (char c : expected) {
+    size += c;
+  }
+  GALOIS_ASSERT(f.size() == size);
+  GALOIS_ASSERT(f.empty() == (size == 0));
+
+  std::vector<char> visits(expected.size(), 0);
+  f.do_all([&](uint32_t n) { ++visits[n]; }, "check");
+  GALOIS_ASSERT(visits == expected);
+  for (uint32_t n = 0; n < expected.size(); ++n) {
+    GALOIS_ASSERT(f.contains(n) == bool(expected[n]));
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  constexpr uint32_t N = 100000;
+  galois::Frontier<uint32_t> f(N);
+  std::vector<char> expected(N);
+
+  f.push_all();
+  f.advance();
+  GALOIS_ASSERT(f.dense());
+  std::fill(expected.begin(), expected.end(), 1);
+  check(f, expected);
+
+  // every round pushes the multiples of step, each of them several times,
+  // so the frontier goes from dense to sparse and back
+  for (uint32_t step : {2u, 1000u, 7u, 50000u, 3u, 1u, 100001u}) {
+    f.do_all(
+        [&](uint32_t n) {
+          if (n % step == 0) {
+            f.push(n);
+            f.push((n + step) % N - (n + step) % N % step);
+          }
+        },
+        "push");
+    // nodes that were not in the frontier push nothing, so push them here
+    galois::do_all(galois::iterate(0u, N), [&](uint32_t n) {
+      if (n % step == 0 && !f.contains(n)) {
+        f.push(n);
+      }
+    });
+    f.advance();
+
+    for (uint32_t n = 0; n < N; ++n) {
+      expected[n] = n % step == 0;
+    }
+    GALOIS_ASSERT(f.dense() == (f.size() > N / 20));
+    check(f, expected);
+  }
+
+  f.advance();
+  check(f, std::vector<char>(N, 0));
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/ParallelGraphBuilder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+
+using Pair = std::pair<uint64_t, uint64_t>;
+
+//! Expected graph: edge -> data of the first copy or the sum of copies
+std::map<Pair, int> expectedEdges(const std::vector<std::pair<Pair, int>>& in,
+                                  bool symmetrize, bool sum) {
+  std::map<Pair, int> expected;
+  auto add = [&](Pair p, int d) {
+    auto it = expected.find(p);
+    if (it == expected.end()) {
+      expected.emplace(p, d);
+    } else if (sum) {
+      it->second += d;
+    }
+  };
+  for (auto& e : in) {
+    if (e.first.first == e.first.second) {
+      continue;
+    }
+    add(e.first, e.second);
+  }
+  if (symmetrize) {
+    for (auto& e : in) {
+      if (e.first.first != e.first.second) {
+        add(Pair(e.first.second, e.first.first), e.second);
+      }
+    }
+  }
+  return expected;
+}
+
+void testBuild(size_t numNodes, size_t numEdges, bool symmetrize) {
+  std::mt19937 gen(numEdges);
+  std::vector<std::pair<Pair, int>> in(numEdges);
+  for (auto& e : in) {
+    e = std::make_pair(Pair(gen() % numNodes, gen() % numNodes),
+                       int(gen() % 100));
+  }
+
+  // half streamed from all threads, half in bulk
+  galois::graphs::ParallelGraphBuilder<int> builder;
+  builder.setSymmetrize(symmetrize);
+  builder.setRemoveSelfLoops();
+  builder.setRemoveDuplicates();
+  builder.setNumNodes(numNodes);
+  size_t half = numEdges / 2;
+  galois::do_all(galois::iterate(size_t{0}, half), [&](size_t i) {
+    builder.addEdge(in[i].first.first, in[i].first.second, in[i].second);
+  });
+  builder.addEdges(numEdges - half, [&](uint64_t i) {
+    auto& e = in[half + i];
+    return decltype(builder)::Edge{e.first.first, e.first.second, e.second};
+  });
+  builder.build([](int& kept, const int& other) { kept += other; });
+
+  std::map<Pair, int> expected = expectedEdges(in, symmetrize, true);
+  GALOIS_ASSERT(builder.size() == numNodes);
+  GALOIS_ASSERT(builder.sizeEdges() == expected.size());
+
+  galois::graphs::LC_CSR_Graph<int, int> graph;
+  builder.toGraph(graph);
+  GALOIS_ASSERT(graph.size() == numNodes);
+  GALOIS_ASSERT(graph.sizeEdges() == expected.size());
+
+  auto it = expected.begin();
+  for (auto n : graph) {
+    for (auto e : graph.edges(n)) {
+      GALOIS_ASSERT(it != expected.end());
+      GALOIS_ASSERT(it->first == Pair(n, graph.getEdgeDst(e)));
+      GALOIS_ASSERT(it->second == graph.getEdgeData(e));
+      ++it;
+    }
+  }
+  GALOIS_ASSERT(it == expected.end());
+}
+
+void testFile(size_t numEdges) {
+  galois::graphs::ParallelGraphBuilder<void> builder;
+  galois::do_all(galois::iterate(size_t{0}, numEdges), [&](size_t i) {
+    builder.addEdge(numEdges - 1 - i, (i * 7) % numEdges);
+  });
+  std::string filename = "graph-builder-test.gr";
+  builder.toFile(filename);
+
+  galois::graphs::FileGraph graph;
+  graph.fromFile(filename);
+  GALOIS_ASSERT(graph.size() == numEdges && graph.sizeEdges() == numEdges);
+  for (auto n : graph) {
+    GALOIS_ASSERT(std::distance(graph.edge_begin(n), graph.edge_end(n)) == 1);
+    GALOIS_ASSERT(graph.getEdgeDst(graph.edge_begin(n)) ==
+                  ((numEdges - 1 - n) * 7) % numEdges);
+  }
+  std::remove(filename.c_str());
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  testBuild(10, 100, false);
+  testBuild(10, 100, true);
+  testBuild(1000, 200000, false);
+  testBuild(100000, 200000, true);
+  testFile(100001);
+  return 0;
+}
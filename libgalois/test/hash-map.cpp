@@ -0,0 +1,90 @@
+#include "galois/Galois.h"
+#include "galois/ConcurrentHashMap.h"
+#include "galois/Timer.h"
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! Key of update i: few distinct keys, so most updates hit existing keys
+uint64_t keyOf(size_t i, size_t numKeys) {
+  return (i * 2654435761ULL) % numKeys;
+}
+
+void testOpenHashMap() {
+  galois::OpenHashMap<std::string, int> map;
+  auto add = [](int& a, const int& b) { a += b; };
+  for (int i = 0; i < 1000; ++i) {
+    GALOIS_ASSERT(map.update(std::to_string(i % 100), 1, add) == (i < 100));
+  }
+  GALOIS_ASSERT(map.size() == 100);
+  GALOIS_ASSERT(*map.find("42") == 10 && !map.find("100"));
+  size_t total = 0;
+  map.forEach([&](const std::string&, int& v) { total += v; });
+  GALOIS_ASSERT(total == 1000);
+  map.clear();
+  GALOIS_ASSERT(map.empty() && !map.find("42"));
+}
+
+//! Counts keyOf(i) for all i with the concurrent map and checks the counts
+double countConcurrent(size_t numUpdates, size_t numKeys) {
+  galois::ConcurrentHashMap<uint64_t, uint64_t> map;
+  galois::Timer timer;
+  timer.start();
+  galois::do_all(galois::iterate(size_t{0}, numUpdates),
+                 [&](size_t i) { map.update(keyOf(i, numKeys), 1); });
+  map.merge();
+  timer.stop();
+
+  GALOIS_ASSERT(map.size() == std::min(numKeys, numUpdates));
+  std::vector<uint64_t> expected(numKeys);
+  for (size_t i = 0; i < numUpdates; ++i) {
+    ++expected[keyOf(i, numKeys)];
+  }
+  galois::GAccumulator<size_t> mismatches;
+  map.parallelForEach([&](const uint64_t& k, uint64_t& v) {
+    if (expected[k] != v) {
+      mismatches += 1;
+    }
+  });
+  GALOIS_ASSERT(mismatches.reduce() == 0);
+  GALOIS_ASSERT(*map.find(keyOf(0, numKeys)) == expected[keyOf(0, numKeys)]);
+  return timer.get_usec() / 1000.0;
+}
+
+//! The same counting with per-thread std::unordered_maps merged serially
+double countUnorderedMaps(size_t numUpdates, size_t numKeys) {
+  using Map = std::unordered_map<uint64_t, uint64_t>;
+  galois::substrate::PerThreadStorage<Map> locals;
+  Map merged;
+  galois::Timer timer;
+  timer.start();
+  galois::do_all(galois::iterate(size_t{0}, numUpdates),
+                 [&](size_t i) { (*locals.getLocal())[keyOf(i, numKeys)]++; });
+  for (unsigned t = 0; t < locals.size(); ++t) {
+    for (auto& kv : *locals.getRemote(t)) {
+      merged[kv.first] += kv.second;
+    }
+  }
+  timer.stop();
+  GALOIS_ASSERT(merged.size() == std::min(numKeys, numUpdates));
+  return timer.get_usec() / 1000.0;
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  testOpenHashMap();
+  for (size_t numKeys : {size_t{1}, size_t{1000}, size_t{1000000}}) {
+    size_t numUpdates = 4000000;
+    double concurrent = countConcurrent(numUpdates, numKeys);
+    double unordered  = countUnorderedMaps(numUpdates, numKeys);
+    std::cout << numKeys << " keys: ConcurrentHashMap " << concurrent
+              << " ms, per-thread std::unordered_map " << unordered
+              << " ms\n";
+  }
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include "galois/Galois.h"
+#include "galois/substrate/ThreadPool.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using galois::substrate::IdlePolicy;
+
+//! runs short loops with idle gaps in between; returns the sleeps of threads
+//! other than the master, after checking that each of them joined every loop
+uint64_t runLoops(unsigned numThreads, unsigned rounds) {
+  auto& tp = galois::substrate::getThreadPool();
+  tp.resetWakeupStats();
+  for (unsigned r = 0; r < rounds; ++r) {
+    galois::GAccumulator<unsigned> count;
+    galois::do_all(galois::iterate(0u, 1000u),
+                   [&](unsigned) { count += 1; });
+    GALOIS_ASSERT(count.reduce() == 1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  uint64_t sleeps = 0;
+  for (unsigned tid = 1; tid < numThreads; ++tid) {
+    auto s = tp.getWakeupStats(tid);
+    GALOIS_ASSERT(s.wakeups == rounds, "thread ", tid, " woke up ", s.wakeups,
+                  " times");
+    GALOIS_ASSERT(s.maxLatencyNs * s.wakeups >= s.totalLatencyNs);
+    sleeps += s.sleeps;
+  }
+  return sleeps;
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  unsigned numThreads = galois::setActiveThreads(4);
+  auto& tp            = galois::substrate::getThreadPool();
+  const unsigned rounds = 20;
+
+  tp.setIdlePolicy(IdlePolicy::Sleep, 0);
+  GALOIS_ASSERT(runLoops(numThreads, rounds) == (numThreads - 1) * rounds);
+
+  tp.setIdlePolicy(IdlePolicy::Spin, 0);
+  GALOIS_ASSERT(runLoops(numThreads, rounds) == 0);
+
+  // a window much longer than the gaps between loops
+  tp.setIdlePolicy(IdlePolicy::Hybrid, 1000000);
+  GALOIS_ASSERT(runLoops(numThreads, rounds) == 0);
+
+  tp.setIdlePolicy(IdlePolicy::Hybrid, 0);
+  GALOIS_ASSERT(runLoops(numThreads, rounds) == (numThreads - 1) * rounds);
+
+  // pinned threads spin whatever the policy
+  tp.setIdlePolicy(IdlePolicy::Sleep, 0);
+  tp.pinThreads(numThreads);
+  GALOIS_ASSERT(tp.getPinnedThreads() == numThreads);
+  GALOIS_ASSERT(runLoops(numThreads, rounds) == 0);
+  tp.pinThreads(0);
+  GALOIS_ASSERT(runLoops(numThreads, rounds) == (numThreads - 1) * rounds);
+
+  tp.setIdlePolicy(IdlePolicy::Hybrid, 50);
+  runLoops(numThreads, rounds);
+  galois::reportWakeupStats("IdlePolicy");
+  for (unsigned tid = 0; tid < numThreads; ++tid) {
+    GALOIS_ASSERT(tp.getWakeupStats(tid).wakeups <= 1);
+  }
+
+  if (numThreads > 1) {
+    std::ostringstream os;
+    galois::runtime::internal::sysStatManager()->printStatsJSON(os);
+    GALOIS_ASSERT(os.str().find("\"region\":\"IdlePolicy\",\"category\":"
+                                "\"Wakeups\"") != std::string::npos);
+  }
+
+  return 0;
+}
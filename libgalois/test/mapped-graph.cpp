@@ -0,0 +1,108 @@
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+const uint64_t DEGREE = 3;
+
+//! Edge k of node i goes to (i + k + 1) % numNodes and has weight i * k
+void writeGraph(const std::string& filename, uint64_t version,
+                uint64_t numNodes) {
+  uint64_t numEdges  = numNodes * DEGREE;
+  uint64_t header[4] = {version, sizeof(uint32_t), numNodes, numEdges};
+  std::vector<uint64_t> index;
+  std::vector<uint64_t> dsts;
+  std::vector<uint32_t> weights;
+  for (uint64_t i = 0; i < numNodes; ++i) {
+    for (uint64_t k = 0; k < DEGREE; ++k) {
+      dsts.push_back((i + k + 1) % numNodes);
+      weights.push_back(i * k);
+    }
+    index.push_back(dsts.size());
+  }
+  // edge destinations are padded to 8 bytes
+  if (numEdges % 2) {
+    dsts.push_back(0);
+  }
+
+  std::ofstream out(filename, std::ios::binary);
+  out.write(reinterpret_cast<char*>(header), sizeof(header));
+  out.write(reinterpret_cast<char*>(index.data()),
+            index.size() * sizeof(uint64_t));
+  if (version == 1) {
+    std::vector<uint32_t> narrow(dsts.begin(), dsts.end());
+    out.write(reinterpret_cast<char*>(narrow.data()),
+              narrow.size() * sizeof(uint32_t));
+  } else {
+    out.write(reinterpret_cast<char*>(dsts.data()),
+              dsts.size() * sizeof(uint64_t));
+  }
+  out.write(reinterpret_cast<char*>(weights.data()),
+            weights.size() * sizeof(uint32_t));
+}
+
+template <typename Graph>
+void checkTopology(Graph& graph, uint64_t numNodes) {
+  GALOIS_ASSERT(graph.size() == numNodes);
+  GALOIS_ASSERT(graph.sizeEdges() == numNodes * DEGREE);
+  for (auto n : graph) {
+    uint64_t k = 0;
+    for (auto e : graph.edges(n)) {
+      GALOIS_ASSERT(graph.getEdgeDst(e) == (n + k + 1) % numNodes);
+      ++k;
+    }
+    GALOIS_ASSERT(k == DEGREE);
+  }
+}
+
+void testMapped(uint64_t version,
+                const galois::graphs::MappedGraphFile::Options& options) {
+  std::string filename = "mapped-graph-test.gr";
+  uint64_t numNodes    = 1001;
+  writeGraph(filename, version, numNodes);
+
+  galois::graphs::LC_CSR_Graph<uint32_t, uint32_t> graph;
+  graph.mapGraphFromGRFile(filename, options);
+  checkTopology(graph, numNodes);
+  for (auto n : graph) {
+    uint64_t k = 0;
+    for (auto e : graph.edges(n)) {
+      GALOIS_ASSERT(graph.getEdgeData(e) == n * k);
+      ++k;
+    }
+    // node data is not part of the mapping
+    graph.getData(n) = n;
+  }
+  for (auto n : graph) {
+    GALOIS_ASSERT(graph.getData(n) == n);
+  }
+
+  galois::graphs::LC_CSR_Graph<uint32_t, void> voidGraph;
+  voidGraph.mapGraphFromGRFile(filename, options);
+  checkTopology(voidGraph, numNodes);
+
+  std::remove(filename.c_str());
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  using Options = galois::graphs::MappedGraphFile::Options;
+  using Advice  = galois::graphs::MappedGraphFile::Advice;
+  testMapped(1, Options());
+  testMapped(2, Options());
+
+  Options options;
+  options.populate = true;
+  options.advice   = Advice::Random;
+  testMapped(1, options);
+  options.interleave = true;
+  options.advice     = Advice::WillNeed;
+  testMapped(2, options);
+  return 0;
+}
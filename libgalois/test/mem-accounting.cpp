@@ -0,0 +1,77 @@
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/substrate/MemAccounting.h"
+
+#include <cstdint>
+
+using galois::substrate::MemCategory;
+using galois::substrate::memCurrentBytes;
+using galois::substrate::memPeakBytes;
+
+//! Only provides the sizes and types used by preAllocFor
+struct SizeOnlyGraph {
+  using GraphNode      = uint32_t;
+  using node_data_type = uint32_t;
+  using edge_data_type = void;
+  size_t size() const { return 100000; }
+  size_t sizeEdges() const { return 200000; }
+};
+
+//! Pages preAllocFor should take for bytes of work items
+unsigned expectedPages(size_t bytes) {
+  size_t pageSize  = galois::runtime::pagePoolSize();
+  unsigned threads = galois::getActiveThreads();
+  unsigned pages   = threads + (bytes + pageSize - 1) / pageSize;
+  // rounded up so that every thread gets the same share
+  return (pages + threads - 1) / threads * threads;
+}
+
+void testLargeArrays() {
+  const int64_t mb = 1 << 20;
+  int64_t before   = memCurrentBytes(MemCategory::LargeArrays);
+  {
+    galois::LargeArray<uint64_t> arr;
+    arr.allocateInterleaved(mb);
+    GALOIS_ASSERT(memCurrentBytes(MemCategory::LargeArrays) ==
+                  before + 8 * mb);
+    galois::LargeArray<uint64_t> other;
+    other.allocateBlocked(mb / 4);
+    GALOIS_ASSERT(memCurrentBytes(MemCategory::LargeArrays) ==
+                  before + 10 * mb);
+  }
+  GALOIS_ASSERT(memCurrentBytes(MemCategory::LargeArrays) == before);
+  GALOIS_ASSERT(memPeakBytes(MemCategory::LargeArrays) >= before + 10 * mb);
+  GALOIS_ASSERT(galois::substrate::memTotalPeakBytes() >= before + 10 * mb);
+
+  galois::substrate::resetMemPeaks();
+  GALOIS_ASSERT(memPeakBytes(MemCategory::LargeArrays) == before);
+}
+
+void testWorklistChunks() {
+  galois::for_each(galois::iterate(0, 1000000),
+                   [](int, auto&) {}, galois::no_stats());
+  GALOIS_ASSERT(memPeakBytes(MemCategory::WorklistChunks) > 0);
+}
+
+void testPreAlloc() {
+  int64_t before = memCurrentBytes(MemCategory::PagePool);
+  // node items are a node and its data, edge items two nodes
+  unsigned pages = galois::preAllocFor(SizeOnlyGraph(), 4, 1);
+  GALOIS_ASSERT(pages == expectedPages(100000 * 4 * 8 + 200000 * 1 * 8));
+  unsigned more = galois::preAllocFor<uint64_t>(SizeOnlyGraph(), 0, 10);
+  GALOIS_ASSERT(more == expectedPages(200000 * 10 * 8));
+  GALOIS_ASSERT(
+      memCurrentBytes(MemCategory::PagePool) ==
+      before + int64_t((pages + more) * galois::runtime::pagePoolSize()));
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  testLargeArrays();
+  testWorklistChunks();
+  testPreAlloc();
+  return 0;
+}
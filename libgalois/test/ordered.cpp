@@ -0,0 +1,289 @@
+#include "galois/Galois.h"
+#include "galois/Timer.h"
+#include "galois/runtime/Context.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+constexpr unsigned DEGREE     = 4;
+constexpr uint32_t INFINITY_D = ~0u;
+
+struct Node : public galois::runtime::Lockable {
+  uint32_t dist;
+  uint32_t settled;
+  uint32_t parent;
+  uint32_t size;
+};
+
+struct Edge {
+  uint32_t src;
+  uint32_t dst;
+  uint32_t weight;
+  uint32_t id;
+};
+
+//! pseudo-random edges, the same in every run
+struct Graph {
+  std::vector<Node> nodes;
+  std::vector<Edge> edges;
+  //! CSR of edges in both directions
+  std::vector<uint32_t> offsets;
+  std::vector<Edge> adj;
+
+  explicit Graph(uint32_t size) : nodes(size), offsets(size + 1, 0) {
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    auto next  = [&] {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      return x;
+    };
+    for (uint32_t i = 0; i < size * DEGREE; ++i) {
+      // a path through all nodes keeps the graph connected
+      uint32_t src = i < size - 1 ? i : next() % size;
+      uint32_t dst = i < size - 1 ? i + 1 : next() % size;
+      edges.push_back(Edge{src, dst, uint32_t(next() % 100 + 1), i});
+    }
+    for (auto& e : edges) {
+      ++offsets[e.src + 1];
+      ++offsets[e.dst + 1];
+    }
+    for (uint32_t n = 0; n < size; ++n) {
+      offsets[n + 1] += offsets[n];
+    }
+    adj.resize(offsets[size]);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (auto& e : edges) {
+      adj[fill[e.src]++] = e;
+      adj[fill[e.dst]++] = Edge{e.dst, e.src, e.weight, e.id};
+    }
+  }
+
+  void reset() {
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+      nodes[n].dist    = INFINITY_D;
+      nodes[n].settled = 0;
+      nodes[n].parent  = n;
+      nodes[n].size    = 1;
+    }
+  }
+
+  uint32_t find(uint32_t n) const {
+    while (nodes[n].parent != n) {
+      n = nodes[n].parent;
+    }
+    return n;
+  }
+};
+
+struct Req {
+  uint32_t node;
+  uint32_t dist;
+};
+
+struct ReqLess {
+  bool operator()(const Req& a, const Req& b) const {
+    return a.dist < b.dist || (a.dist == b.dist && a.node < b.node);
+  }
+};
+
+struct EdgeLess {
+  bool operator()(const Edge& a, const Edge& b) const {
+    return a.weight < b.weight || (a.weight == b.weight && a.id < b.id);
+  }
+};
+
+std::vector<uint32_t> serialDijkstra(Graph& g) {
+  g.reset();
+  galois::Timer t;
+  t.start();
+  std::priority_queue<Req, std::vector<Req>, std::function<bool(Req, Req)>>
+      pq([](Req a, Req b) { return ReqLess()(b, a); });
+  g.nodes[0].dist = 0;
+  pq.push(Req{0, 0});
+  while (!pq.empty()) {
+    Req r = pq.top();
+    pq.pop();
+    if (g.nodes[r.node].dist < r.dist) {
+      continue;
+    }
+    for (uint32_t i = g.offsets[r.node]; i < g.offsets[r.node + 1]; ++i) {
+      const Edge& e = g.adj[i];
+      uint32_t nd   = r.dist + e.weight;
+      if (nd < g.nodes[e.dst].dist) {
+        g.nodes[e.dst].dist = nd;
+        pq.push(Req{e.dst, nd});
+      }
+    }
+  }
+  t.stop();
+  std::cout << "SerialDijkstra time(ms): " << t.get() << "\n";
+
+  std::vector<uint32_t> dist;
+  for (auto& n : g.nodes) {
+    dist.push_back(n.dist);
+  }
+  return dist;
+}
+
+/**
+ * Dijkstra with exact priority order: every node is settled (expanded at its
+ * final distance) exactly once, which any reordering of dependent iterations
+ * would break.
+ */
+void orderedDijkstra(Graph& g, const std::vector<uint32_t>& expected) {
+  g.reset();
+  galois::Timer t;
+  t.start();
+  g.nodes[0].dist = 0;
+  Req source{0, 0};
+  galois::for_each_ordered(
+      &source, &source + 1, ReqLess(),
+      [&](const Req& r) {
+        galois::runtime::acquire(&g.nodes[r.node], galois::MethodFlag::WRITE);
+        for (uint32_t i = g.offsets[r.node]; i < g.offsets[r.node + 1]; ++i) {
+          galois::runtime::acquire(&g.nodes[g.adj[i].dst],
+                                   galois::MethodFlag::WRITE);
+        }
+      },
+      [&](const Req& r, auto& ctx) {
+        Node& n = g.nodes[r.node];
+        if (n.dist < r.dist) {
+          return;
+        }
+        ++n.settled;
+        ctx.addUndo([&n] { --n.settled; });
+        for (uint32_t i = g.offsets[r.node]; i < g.offsets[r.node + 1]; ++i) {
+          const Edge& e = g.adj[i];
+          uint32_t nd   = r.dist + e.weight;
+          uint32_t& d   = g.nodes[e.dst].dist;
+          if (nd < d) {
+            ctx.addUndo([&d, old = d] { d = old; });
+            d = nd;
+            ctx.push(Req{e.dst, nd});
+          }
+        }
+      },
+      "OrderedDijkstra");
+  t.stop();
+  std::cout << "OrderedDijkstra time(ms): " << t.get() << "\n";
+
+  for (uint32_t n = 0; n < g.nodes.size(); ++n) {
+    GALOIS_ASSERT(g.nodes[n].dist == expected[n], "node ", n);
+    GALOIS_ASSERT(g.nodes[n].settled == 1, "node ", n, " settled ",
+                  g.nodes[n].settled, " times");
+  }
+}
+
+std::vector<char> serialKruskal(Graph& g) {
+  g.reset();
+  galois::Timer t;
+  t.start();
+  std::vector<Edge> sorted(g.edges);
+  std::sort(sorted.begin(), sorted.end(), EdgeLess());
+  std::vector<char> inMST(g.edges.size(), 0);
+  for (auto& e : sorted) {
+    uint32_t ru = g.find(e.src);
+    uint32_t rv = g.find(e.dst);
+    if (ru == rv) {
+      continue;
+    }
+    if (g.nodes[ru].size < g.nodes[rv].size) {
+      std::swap(ru, rv);
+    }
+    g.nodes[rv].parent = ru;
+    g.nodes[ru].size += g.nodes[rv].size;
+    inMST[e.id] = 1;
+  }
+  t.stop();
+  std::cout << "SerialMST time(ms): " << t.get() << "\n";
+  return inMST;
+}
+
+/**
+ * Minimum spanning forest by contracting edges in weight order, locking the
+ * two components an edge joins. With ties broken by edge id the forest is
+ * the one of serial Kruskal.
+ */
+void orderedMST(Graph& g, const std::vector<char>& expected) {
+  g.reset();
+  std::vector<char> inMST(g.edges.size(), 0);
+  galois::Timer t;
+  t.start();
+  galois::for_each_ordered(
+      g.edges.begin(), g.edges.end(), EdgeLess(),
+      [&](const Edge& e) {
+        // joined components stay joined, so the edge needs no locks then
+        uint32_t ru = g.find(e.src);
+        uint32_t rv = g.find(e.dst);
+        if (ru != rv) {
+          galois::runtime::acquire(&g.nodes[ru], galois::MethodFlag::WRITE);
+          galois::runtime::acquire(&g.nodes[rv], galois::MethodFlag::WRITE);
+        }
+      },
+      [&](const Edge& e, auto& ctx) {
+        uint32_t ru = g.find(e.src);
+        uint32_t rv = g.find(e.dst);
+        if (ru == rv) {
+          return;
+        }
+        if (g.nodes[ru].size < g.nodes[rv].size) {
+          std::swap(ru, rv);
+        }
+        Node& root  = g.nodes[ru];
+        Node& child = g.nodes[rv];
+        ctx.addUndo([&root, &child, rv, size = root.size] {
+          child.parent = rv;
+          root.size    = size;
+        });
+        child.parent = ru;
+        root.size += child.size;
+        inMST[e.id] = 1;
+        ctx.addUndo([&inMST, id = e.id] { inMST[id] = 0; });
+      },
+      "OrderedMST");
+  t.stop();
+  std::cout << "OrderedMST time(ms): " << t.get() << "\n";
+
+  GALOIS_ASSERT(inMST == expected);
+}
+
+//! An item that aborts a few times, also when it runs alone, commits later
+void orderedRetries() {
+  const unsigned numItems = 1000;
+  std::vector<unsigned> items(numItems);
+  std::iota(items.begin(), items.end(), 0u);
+  std::vector<char> done(numItems, 0);
+  unsigned tries = 0;
+  galois::for_each_ordered(
+      items.begin(), items.end(), std::less<unsigned>(), [](unsigned) {},
+      [&](unsigned i, auto& ctx) {
+        if (i == numItems / 2 && ++tries <= 20) {
+          ctx.abort();
+        }
+        done[i] = 1;
+        ctx.addUndo([&done, i] { done[i] = 0; });
+      },
+      "OrderedRetries");
+  GALOIS_ASSERT(tries > 20);
+  GALOIS_ASSERT(std::count(done.begin(), done.end(), 1) == numItems);
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  uint32_t size = argc > 1 ? std::atoi(argv[1]) : 20000;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  Graph g(size);
+  orderedDijkstra(g, serialDijkstra(g));
+  orderedMST(g, serialKruskal(g));
+  orderedRetries();
+
+  return 0;
+}
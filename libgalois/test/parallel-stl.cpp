@@ -0,0 +1,146 @@
+#include "galois/Galois.h"
+#include "galois/ParallelSTL.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+//! Sizes below and above the serial cutoff
+const size_t sizes[] = {0, 1, 1000, 100000, 1000003};
+
+void testScan(size_t n) {
+  std::mt19937 gen(n);
+  std::vector<uint64_t> in(n);
+  for (auto& x : in) {
+    x = gen() % 100;
+  }
+
+  std::vector<uint64_t> expected(n);
+  std::partial_sum(in.begin(), in.end(), expected.begin());
+  std::vector<uint64_t> out(n);
+  auto end = galois::ParallelSTL::inclusive_scan(in.begin(), in.end(),
+                                                 out.begin());
+  GALOIS_ASSERT(end == out.end() && out == expected);
+
+  // exclusive and in place
+  for (size_t i = 0; i < n; ++i) {
+    expected[i] -= in[i] - 5;
+  }
+  out = in;
+  galois::ParallelSTL::exclusive_scan(out.begin(), out.end(), out.begin(),
+                                      uint64_t{5});
+  GALOIS_ASSERT(out == expected);
+}
+
+void testCopyIf(size_t n) {
+  std::vector<uint32_t> in(n);
+  std::iota(in.begin(), in.end(), 0);
+  auto pred = [](uint32_t x) { return x % 3 == 1; };
+
+  std::vector<uint32_t> expected;
+  std::copy_if(in.begin(), in.end(), std::back_inserter(expected), pred);
+  std::vector<uint32_t> out(n);
+  auto end =
+      galois::ParallelSTL::copy_if(in.begin(), in.end(), out.begin(), pred);
+  out.resize(end - out.begin());
+  GALOIS_ASSERT(out == expected);
+}
+
+void testHistogram(size_t n) {
+  std::mt19937 gen(n);
+  std::vector<uint32_t> in(n);
+  for (auto& x : in) {
+    x = gen();
+  }
+  // few bins use per-block tables, many bins atomics
+  for (size_t bins : {size_t{7}, n + 1}) {
+    std::vector<uint64_t> expected(bins);
+    for (auto x : in) {
+      ++expected[x % bins];
+    }
+    std::vector<uint64_t> counts(bins, 42);
+    galois::ParallelSTL::histogram(
+        in.begin(), in.end(), bins, [&](uint32_t x) { return x % bins; },
+        counts.data());
+    GALOIS_ASSERT(counts == expected);
+  }
+}
+
+void testRadixSort(size_t n) {
+  std::mt19937_64 gen(n);
+  std::vector<uint64_t> keys(n);
+  for (auto& x : keys) {
+    x = gen();
+  }
+  std::vector<uint64_t> expected = keys;
+  std::sort(expected.begin(), expected.end());
+  galois::ParallelSTL::radix_sort(keys.begin(), keys.end());
+  GALOIS_ASSERT(keys == expected);
+
+  // stability: pairs sorted by a 12-bit key keep their input order
+  using Pair = std::pair<uint32_t, uint32_t>;
+  std::vector<Pair> pairs(n);
+  for (size_t i = 0; i < n; ++i) {
+    pairs[i] = Pair(gen() % 4096, i);
+  }
+  std::vector<Pair> expectedPairs = pairs;
+  std::stable_sort(
+      expectedPairs.begin(), expectedPairs.end(),
+      [](const Pair& a, const Pair& b) { return a.first < b.first; });
+  galois::ParallelSTL::radix_sort(
+      pairs.begin(), pairs.end(), [](const Pair& p) { return p.first; },
+      4095);
+  GALOIS_ASSERT(pairs == expectedPairs);
+
+  // separate keys and values
+  std::vector<uint32_t> k(n);
+  std::vector<uint32_t> v(n);
+  for (size_t i = 0; i < n; ++i) {
+    k[i] = expectedPairs[n - 1 - i].first;
+    v[i] = expectedPairs[n - 1 - i].second;
+  }
+  galois::ParallelSTL::radix_sort_by_key(k.begin(), k.end(), v.begin());
+  for (size_t i = 1; i < n; ++i) {
+    GALOIS_ASSERT(k[i - 1] < k[i] || (k[i - 1] == k[i] && v[i - 1] > v[i]));
+  }
+}
+
+void testSemisort(size_t n) {
+  std::mt19937 gen(n);
+  const size_t numKeys = n / 10 + 3;
+  std::vector<std::pair<uint32_t, uint32_t>> edges(n);
+  for (size_t i = 0; i < n; ++i) {
+    edges[i] = std::make_pair(gen() % numKeys, i);
+  }
+  std::vector<uint64_t> offsets(numKeys + 1);
+  galois::ParallelSTL::semisort(
+      edges.begin(), edges.end(), numKeys,
+      [](const std::pair<uint32_t, uint32_t>& e) { return e.first; },
+      offsets.begin());
+
+  GALOIS_ASSERT(offsets[0] == 0 && offsets[numKeys] == n);
+  for (size_t k = 0; k < numKeys; ++k) {
+    GALOIS_ASSERT(offsets[k] <= offsets[k + 1]);
+    for (size_t i = offsets[k]; i < offsets[k + 1]; ++i) {
+      GALOIS_ASSERT(edges[i].first == k);
+      GALOIS_ASSERT(i == offsets[k] || edges[i - 1].second < edges[i].second);
+    }
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  for (size_t n : sizes) {
+    testScan(n);
+    testCopyIf(n);
+    testHistogram(n);
+    testRadixSort(n);
+    testSemisort(n);
+  }
+  return 0;
+}
@@ -0,0 +1,52 @@
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/runtime/PerfCounters.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+int main() {
+  setenv("GALOIS_PERF_COUNTERS", "1", 1);
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  // touch fresh pages so that there is something to count even where only
+  // software counters are available
+  const size_t size = 1 << 24;
+  galois::LargeArray<char> array;
+  array.allocateBlocked(size);
+  galois::do_all(
+      galois::iterate(size_t{0}, size), [&](size_t i) { array[i] = i; },
+      galois::loopname("countedDoAll"));
+  galois::do_all(
+      galois::iterate(size_t{0}, size), [&](size_t i) { array[i] += 1; },
+      galois::loopname("uncountedDoAll"), galois::no_stats());
+  galois::on_each([](unsigned, unsigned) {},
+                  galois::loopname("countedOnEach"));
+
+  std::ostringstream os;
+  galois::runtime::internal::sysStatManager()->printStatsJSON(os);
+  std::string stats = os.str();
+
+  auto names = galois::runtime::perfCounterNames();
+  for (auto& name : names) {
+    GALOIS_ASSERT(stats.find("\"region\":\"uncountedDoAll\",\"category\":\"" +
+                             name + "\"") == std::string::npos);
+    for (const char* region : {"countedDoAll", "countedOnEach"}) {
+      std::string stat = std::string("\"region\":\"") + region +
+                         "\",\"category\":\"" + name +
+                         "\",\"totalType\":\"TSUM\"";
+      GALOIS_ASSERT(stats.find(stat) != std::string::npos, "missing ", stat);
+    }
+  }
+  if (std::find(names.begin(), names.end(), "PageFaults") != names.end()) {
+    std::string faults = "\"region\":\"countedDoAll\",\"category\":"
+                         "\"PageFaults\",\"totalType\":\"TSUM\",\"total\":";
+    size_t pos = stats.find(faults);
+    GALOIS_ASSERT(std::atol(stats.c_str() + pos + faults.size()) > 0);
+  }
+
+  return 0;
+}
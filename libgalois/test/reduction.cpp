@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <iostream>
 #include <functional>
+#include <vector>
 
 struct Move {
   Move()            = default;
@@ -81,6 +82,36 @@ void test_accum() {
   GALOIS_ASSERT(accum.reduce() == num);
 }
 
+//! Adds i % numBins to bin (i * 7) % numBins for every i and checks the sums
+void test_array_accum(size_t numBins, size_t num) {
+  galois::GArrayAccumulator<int64_t> accum(numBins);
+
+  for (int round = 0; round < 2; ++round) {
+    galois::do_all(galois::iterate(size_t{0}, num), [&](size_t i) {
+      accum.update((i * 7) % numBins, i % numBins);
+    });
+
+    std::vector<int64_t> expected(numBins);
+    for (size_t i = 0; i < num; ++i) {
+      expected[(i * 7) % numBins] += i % numBins;
+    }
+    std::vector<int64_t>& result = accum.reduce();
+    GALOIS_ASSERT(result == expected);
+    accum.reset();
+  }
+}
+
+void test_histogram() {
+  galois::GHistogram histogram(1000000);
+
+  galois::do_all(galois::iterate(0, 1000),
+                 [&](int i) { histogram.count(1000 * (i % 10)); });
+
+  std::vector<uint64_t>& result = histogram.reduce();
+  GALOIS_ASSERT(result.size() == 1000000);
+  GALOIS_ASSERT(result[0] == 100 && result[9000] == 100 && result[1] == 0);
+}
+
 int main() {
   galois::SharedMemSys sys;
   galois::setActiveThreads(2);
@@ -92,6 +123,11 @@ int main() {
   test_move();
   test_max();
   test_accum();
+  test_array_accum(10, 123456);
+  // sparse until more than 1/16 of the bins are used
+  test_array_accum(100000, 1000);
+  test_array_accum(100000, 1000000);
+  test_histogram();
 
   return 0;
 }
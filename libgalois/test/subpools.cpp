@@ -0,0 +1,70 @@
+#include "galois/Galois.h"
+#include "galois/substrate/ThreadPool.h"
+
+#include <vector>
+
+//! runs a do_all and a for_each in the calling sub-pool; returns their sums
+uint64_t runLoops(unsigned pool, unsigned size) {
+  GALOIS_ASSERT(galois::getActiveThreads() == size);
+  GALOIS_ASSERT(galois::substrate::ThreadPool::getTID() == 0);
+
+  galois::GAccumulator<uint64_t> sum;
+  galois::GReduceMax<unsigned> maxTID;
+  galois::do_all(galois::iterate(0u, 10000u), [&](unsigned i) {
+    sum += i;
+    maxTID.update(galois::substrate::ThreadPool::getTID());
+  });
+  GALOIS_ASSERT(maxTID.reduce() < size);
+
+  // every item below 1000 pushes one more item, so each loop sees 2000 items
+  galois::GAccumulator<uint64_t> pushed;
+  galois::for_each(
+      galois::iterate(0u, 1000u),
+      [&](unsigned i, auto& ctx) {
+        pushed += i + pool;
+        if (i < 1000) {
+          ctx.push(i + 1000);
+        }
+      },
+      galois::disable_conflict_detection(), galois::loopname("SubPoolForEach"));
+  return sum.reduce() + pushed.reduce();
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  unsigned numThreads = galois::setActiveThreads(4);
+
+  std::vector<unsigned> sizes;
+  if (numThreads == 1) {
+    sizes = {1};
+  } else {
+    sizes = {numThreads / 2, numThreads - numThreads / 2};
+  }
+
+  for (unsigned round = 0; round < 3; ++round) {
+    std::vector<uint64_t> results(sizes.size());
+    galois::on_each_subpool(sizes, [&](unsigned pool, unsigned num) {
+      GALOIS_ASSERT(num == sizes.size());
+      results[pool] = runLoops(pool, sizes[pool]);
+    });
+    for (unsigned p = 0; p < sizes.size(); ++p) {
+      uint64_t expected = 10000ull * 9999 / 2 + 1999ull * 2000 / 2 + 2000 * p;
+      GALOIS_ASSERT(results[p] == expected, "sub-pool ", p, " got ",
+                    results[p]);
+    }
+    GALOIS_ASSERT(galois::getActiveThreads() == numThreads);
+  }
+
+  unsigned total = 0;
+  for (unsigned size : galois::socketSubpoolSizes()) {
+    total += size;
+  }
+  GALOIS_ASSERT(total == numThreads);
+
+  // the whole pool is back
+  galois::GAccumulator<unsigned> count;
+  galois::do_all(galois::iterate(0u, 1000u), [&](unsigned) { count += 1; });
+  GALOIS_ASSERT(count.reduce() == 1000);
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include "galois/Galois.h"
+#include "galois/Timer.h"
+#include "galois/substrate/Termination.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace galois::substrate;
+
+//! gives access to init, which is otherwise only called by
+//! getSystemTermination
+template <typename Base>
+struct Detector : public Base {
+  void setThreads(unsigned num) { this->init(num); }
+};
+
+/**
+ * Each thread reports work for its first tid * work calls and is idle after
+ * that, like a loop where the threads run out of work one after another.
+ * Checks that termination is not detected while some thread is still
+ * working and returns the mean time from the last thread going idle to
+ * detection.
+ */
+template <typename D>
+double measure(unsigned numThreads, unsigned rounds, unsigned work) {
+  Detector<D> term;
+  term.setThreads(numThreads);
+  Barrier& barrier = galois::runtime::getBarrier(numThreads);
+
+  uint64_t totalNs = 0;
+  for (unsigned r = 0; r < rounds; ++r) {
+    std::atomic<unsigned> working(numThreads);
+    std::atomic<uint64_t> lastIdle(0);
+    uint64_t doneNs = 0;
+    getThreadPool().run(numThreads, [&]() {
+      unsigned tid = ThreadPool::getTID();
+      term.initializeThread();
+      barrier.wait();
+      for (unsigned left = tid * work; left > 0; --left) {
+        term.localTermination(true);
+        GALOIS_ASSERT(!term.globalTermination(), "terminated while thread ",
+                      tid, " works");
+      }
+      if (--working == 0) {
+        lastIdle = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count();
+      }
+      while (!term.globalTermination()) {
+        term.localTermination(false);
+        asmPause();
+      }
+      if (tid == 0) {
+        doneNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count();
+      }
+      barrier.wait();
+    });
+    GALOIS_ASSERT(working == 0, "terminated before all threads were idle");
+    totalNs += doneNs > lastIdle ? doneNs - lastIdle : 0;
+  }
+  return double(totalNs) / rounds;
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  unsigned rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+  unsigned maxThreads =
+      galois::setActiveThreads(getThreadPool().getMaxUsableThreads());
+
+  std::cout << "threads sockets ring(ns) tree(ns) hierarchical(ns)\n";
+  for (unsigned t = 1;; t = std::min(2 * t, maxThreads)) {
+    galois::setActiveThreads(t);
+    double ring = measure<internal::LocalTerminationDetection<>>(t, rounds, 8);
+    double tree = measure<internal::TreeTerminationDetection<>>(t, rounds, 8);
+    double hier =
+        measure<internal::HierarchicalTerminationDetection<>>(t, rounds, 8);
+    std::cout << t << " " << getThreadPool().getCumulativeMaxSocket(t - 1) + 1
+              << " " << ring << " " << tree << " " << hier << "\n";
+    if (t == maxThreads) {
+      break;
+    }
+  }
+
+  // the detector of the runtime ends loops
+  galois::setActiveThreads(maxThreads);
+  galois::GAccumulator<unsigned> count;
+  galois::for_each(galois::iterate(0u, 1000u), [&](unsigned i, auto& ctx) {
+    count += 1;
+    if (i % 2 == 0) {
+      ctx.push(i + 1);
+    }
+  });
+  GALOIS_ASSERT(count.reduce() == 1500);
+
+  return 0;
+}
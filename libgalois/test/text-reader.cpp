@@ -0,0 +1,131 @@
+#include "galois/Galois.h"
+#include "galois/graphs/ParallelTextReader.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace text = galois::graphs::text;
+
+void testNumbers() {
+  const std::string s = "  12345678901234 -42 3.5e2\t+7 x";
+  const char* p       = s.data();
+  const char* end     = s.data() + s.size();
+
+  uint64_t u;
+  p = text::parseUint(p, end, u);
+  GALOIS_ASSERT(p && u == 12345678901234);
+  int32_t i;
+  p = text::parseNumber(p, end, i);
+  GALOIS_ASSERT(p && i == -42);
+  double d;
+  p = text::parseNumber(p, end, d);
+  GALOIS_ASSERT(p && d == 350.0);
+  int64_t j;
+  p = text::parseNumber(p, end, j);
+  GALOIS_ASSERT(p && j == 7);
+  GALOIS_ASSERT(!text::parseUint(p, end, u));
+  GALOIS_ASSERT(text::expectChar(p, end, 'x') == end);
+}
+
+//! Numbers that do not fit are rejected instead of wrapping
+void testOverflow() {
+  auto parseU = [](const std::string& s, uint64_t& u) {
+    return text::parseUint(s.data(), s.data() + s.size(), u) != nullptr;
+  };
+  uint64_t u;
+  GALOIS_ASSERT(parseU("18446744073709551615", u) && u == UINT64_MAX);
+  GALOIS_ASSERT(!parseU("18446744073709551616", u));
+  GALOIS_ASSERT(!parseU("1844674407370955161500", u));
+  GALOIS_ASSERT(!parseU("99999999999999999999999999", u));
+
+  auto parseI = [](const std::string& s, int32_t& i) {
+    return text::parseNumber(s.data(), s.data() + s.size(), i) != nullptr;
+  };
+  int32_t i;
+  GALOIS_ASSERT(parseI("2147483647", i) && i == INT32_MAX);
+  GALOIS_ASSERT(parseI("-2147483648", i) && i == INT32_MIN);
+  GALOIS_ASSERT(!parseI("2147483648", i));
+  GALOIS_ASSERT(!parseI("-2147483649", i));
+
+  uint32_t w;
+  std::string s = "4294967296";
+  GALOIS_ASSERT(!text::parseNumber(s.data(), s.data() + s.size(), w));
+  s = "-1";
+  GALOIS_ASSERT(!text::parseNumber(s.data(), s.data() + s.size(), w));
+}
+
+//! The strtod fallback must parse what from_chars does
+void testFloats() {
+  auto parseD = [](const std::string& s, double& d) {
+    const char* p = text::parseNumber(s.data(), s.data() + s.size(), d);
+    return p ? p - s.data() : -1;
+  };
+  double d;
+  GALOIS_ASSERT(parseD("-1.25e-3 7", d) == 8 && d == -1.25e-3);
+  GALOIS_ASSERT(parseD("+0.5", d) == 4 && d == 0.5);
+  GALOIS_ASSERT(parseD("1e400", d) == -1);
+  GALOIS_ASSERT(parseD("0x10", d) == 1 && d == 0);
+  GALOIS_ASSERT(parseD("--1", d) == -1);
+  GALOIS_ASSERT(parseD("x", d) == -1);
+  GALOIS_ASSERT(parseD(std::string(100, '1'), d) == -1 || d > 1e99);
+
+  float f;
+  std::string s = "2.5";
+  GALOIS_ASSERT(text::parseNumber(s.data(), s.data() + s.size(), f) &&
+                f == 2.5f);
+}
+
+void testLines(size_t numLines, bool trailingNewline) {
+  std::string filename = "text-reader-test.txt";
+  {
+    std::ofstream out(filename);
+    // a 10 byte header to skip
+    if (numLines) {
+      out << "# header\r\n";
+    }
+    for (size_t i = 1; i < numLines; ++i) {
+      out << i << " " << 2 * i;
+      if (i + 1 < numLines || trailingNewline) {
+        out << "\n";
+      }
+    }
+  }
+
+  galois::graphs::ParallelTextReader reader(filename);
+  if (numLines) {
+    reader.skipTo(reader.begin() + 10);
+  }
+  GALOIS_ASSERT(reader.numLines() == (numLines ? numLines - 1 : 0));
+
+  std::vector<int> seen(reader.numLines());
+  reader.forEachLine([&](uint64_t line, const char* p, const char* end) {
+    uint64_t src = 0;
+    uint64_t dst = 0;
+    p = text::parseUint(p, end, src);
+    GALOIS_ASSERT(p && text::parseUint(p, end, dst) == end);
+    GALOIS_ASSERT(src == line + 1 && dst == 2 * src);
+    seen[line] += 1;
+  });
+  for (int s : seen) {
+    GALOIS_ASSERT(s == 1);
+  }
+  std::remove(filename.c_str());
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      galois::substrate::getThreadPool().getMaxUsableThreads());
+
+  testNumbers();
+  testOverflow();
+  testFloats();
+  testLines(0, false);
+  testLines(1, true);
+  testLines(10, false);
+  testLines(300000, true);
+  testLines(300001, false);
+  return 0;
+}
@@ -63,6 +63,37 @@ void runDoAll(int num) {
   }
 }
 
+void runDoAllPolicy(int num, galois::substrate::IdlePolicy policy) {
+  auto& tp      = galois::substrate::getThreadPool();
+  auto previous = tp.getIdlePolicy();
+  unsigned spin = tp.getIdleSpinMicros();
+  tp.setIdlePolicy(policy, spin);
+  tp.resetWakeupStats();
+
+  runDoAll(num);
+
+  unsigned active = galois::getActiveThreads();
+  uint64_t wakeups = 0, sleeps = 0, latency = 0;
+  for (unsigned i = 1; i < active; ++i) {
+    auto s = tp.getWakeupStats(i);
+    wakeups += s.wakeups;
+    sleeps += s.sleeps;
+    latency += s.totalLatencyNs;
+  }
+  std::cout << "wakeups: " << wakeups << " sleeps: " << sleeps
+            << " mean latency (ns): " << (wakeups ? latency / wakeups : 0)
+            << "\n";
+  tp.setIdlePolicy(previous, spin);
+}
+
+void runDoAllSleep(int num) {
+  runDoAllPolicy(num, galois::substrate::IdlePolicy::Sleep);
+}
+
+void runDoAllHybrid(int num) {
+  runDoAllPolicy(num, galois::substrate::IdlePolicy::Hybrid);
+}
+
 void runExplicitThread(int num) {
   galois::substrate::Barrier& barrier =
       galois::runtime::getBarrier(galois::getActiveThreads());
@@ -108,6 +139,8 @@ int main(int argc, char* argv[]) {
   for (int t = 0; t < trials; ++t) {
     run(runDoAll, "DoAll");
     run(runDoAllBurn, "DoAllBurn");
+    run(runDoAllSleep, "DoAllSleep");
+    run(runDoAllHybrid, "DoAllHybrid");
     run(runExplicitThread, "ExplicitThread");
   }
   EXIT = 1;
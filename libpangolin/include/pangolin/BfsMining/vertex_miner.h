@@ -27,18 +27,13 @@ public:
     for (int i = 0; i < npatterns; i++)
       accumulators[i].reset();
     if (!is_single)
-      for (auto i = 0; i < this->num_threads; i++)
-        qp_localmaps.getLocal(i)->clear();
+      qp_map.clear();
   }
   void clean() {
     is_wedge.clear();
     accumulators.clear();
     qp_map.clear();
     cg_map.clear();
-    for (auto i = 0; i < this->num_threads; i++)
-      qp_localmaps.getLocal(i)->clear();
-    for (auto i = 0; i < this->num_threads; i++)
-      cg_localmaps.getLocal(i)->clear();
     this->emb_list.clean();
   }
   void initialize(std::string pattern_filename) {
@@ -83,11 +78,8 @@ public:
     galois::do_all(
         galois::iterate(begin, end),
         [&](const size_t& pos) {
-          auto& local_counters  = *(counters.getLocal());
-          unsigned n            = level + 1;
-          StrQpMapFreq* qp_lmap = nullptr;
-          if (n >= 4)
-            qp_lmap = qp_localmaps.getLocal();
+          auto& local_counters = *(counters.getLocal());
+          unsigned n           = level + 1;
           EmbeddingTy emb(n);
           get_embedding(level, pos, emb);
           if (n < this->max_size - 1)
@@ -109,7 +101,7 @@ public:
                         this->find_motif_pattern_id(n, i, dst, emb, pos);
                     local_counters[pid] += 1;
                   } else
-                    quick_reduce(n, i, dst, emb, qp_lmap);
+                    quick_reduce(n, i, dst, emb);
                 }
               }
             }
@@ -389,58 +381,24 @@ public:
 
   // quick pattern reduction
   inline void quick_reduce(unsigned n, unsigned i, VertexId dst,
-                           const EmbeddingTy& emb, StrQpMapFreq* qp_lmap) {
+                           const EmbeddingTy& emb) {
     std::vector<bool> connected;
     this->get_connectivity(n, i, dst, emb, connected);
     StrQPattern qp(n + 1, connected);
-    if (qp_lmap->find(qp) != qp_lmap->end()) {
-      (*qp_lmap)[qp] += 1;
+    if (!qp_map.update(qp, 1))
       qp.clean();
-    } else
-      (*qp_lmap)[qp] = 1;
   }
   // canonical pattern reduction
   inline void canonical_reduce() {
-    for (auto i = 0; i < this->num_threads; i++)
-      cg_localmaps.getLocal(i)->clear();
-    galois::do_all(
-        galois::iterate(qp_map),
-        [&](auto& element) {
-          StrCgMapFreq* cg_map = cg_localmaps.getLocal();
-          StrCPattern cg(element.first);
-          if (cg_map->find(cg) != cg_map->end())
-            (*cg_map)[cg] += element.second;
-          else
-            (*cg_map)[cg] = element.second;
-          cg.clean();
-        },
-        galois::chunk_size<CHUNK_SIZE>(), galois::loopname("CanonicalReduce"));
-    qp_map.clear();
-  }
-  inline void merge_qp_map() {
+    qp_map.parallelForEach([&](const StrQPattern& qp, Frequency& freq) {
+      StrCPattern cg(qp);
+      cg_map.update(cg, freq);
+      cg.clean();
+    });
     qp_map.clear();
-    for (unsigned i = 0; i < qp_localmaps.size(); i++) {
-      StrQpMapFreq qp_lmap = *qp_localmaps.getLocal(i);
-      for (auto element : qp_lmap) {
-        if (qp_map.find(element.first) != qp_map.end())
-          qp_map[element.first] += element.second;
-        else
-          qp_map[element.first] = element.second;
-      }
-    }
-  }
-  inline void merge_cg_map() {
-    cg_map.clear();
-    for (unsigned i = 0; i < cg_localmaps.size(); i++) {
-      StrCgMapFreq cg_lmap = *cg_localmaps.getLocal(i);
-      for (auto element : cg_lmap) {
-        if (cg_map.find(element.first) != cg_map.end())
-          cg_map[element.first] += element.second;
-        else
-          cg_map[element.first] = element.second;
-      }
-    }
   }
+  inline void merge_qp_map() { qp_map.merge(); }
+  inline void merge_cg_map() { cg_map.merge(); }
 
   // Utilities
   Ulong get_total_count() { return accumulators[0].reduce(); }
@@ -460,12 +418,14 @@ public:
     } else {
       if (this->max_size < 9) {
         std::cout << std::endl;
-        for (auto it = cg_map.begin(); it != cg_map.end(); ++it)
-          std::cout << "{" << it->first << "} --> " << it->second << std::endl;
+        cg_map.forEach([](const StrCPattern& cg, Frequency& freq) {
+          std::cout << "{" << cg << "} --> " << freq << std::endl;
+        });
       } else {
         std::cout << std::endl;
-        for (auto it = cg_map.begin(); it != cg_map.end(); ++it)
-          std::cout << it->first << " --> " << it->second << std::endl;
+        cg_map.forEach([](const StrCPattern& cg, Frequency& freq) {
+          std::cout << cg << " --> " << freq << std::endl;
+        });
       }
     }
     // std::cout << std::endl;
@@ -534,8 +494,6 @@ private:
   unsigned num_blocks;
   StrQpMapFreq qp_map; // quick patterns map for counting the frequency
   StrCgMapFreq cg_map; // canonical graph map for couting the frequency
-  LocalStrQpMapFreq qp_localmaps; // quick patterns local map for each thread
-  LocalStrCgMapFreq cg_localmaps; // canonical graph local map for each thread
   std::vector<BYTE> is_wedge;     // indicate a 3-vertex embedding is a wedge or
                                   // chain (v0-cntered or v1-centered)
 
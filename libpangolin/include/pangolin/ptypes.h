@@ -1,4 +1,5 @@
 #pragma once
+#include "galois/ConcurrentHashMap.h"
 #include "pangolin/types.h"
 #include "pangolin/edge_embedding.h"
 #include "pangolin/quick_pattern.h"
@@ -9,12 +10,10 @@ typedef QuickPattern<EdgeInducedEmbedding<StructuralElement>, StructuralElement>
 typedef CanonicalGraph<EdgeInducedEmbedding<StructuralElement>,
                        StructuralElement>
     StrCPattern; // structural canonical pattern
-typedef std::unordered_map<StrQPattern, Frequency>
+typedef galois::ConcurrentHashMap<StrQPattern, Frequency>
     StrQpMapFreq; // mapping structural quick pattern to its frequency
-typedef std::unordered_map<StrCPattern, Frequency>
+typedef galois::ConcurrentHashMap<StrCPattern, Frequency>
     StrCgMapFreq; // mapping structural canonical pattern to its frequency
-typedef galois::substrate::PerThreadStorage<StrQpMapFreq> LocalStrQpMapFreq;
-typedef galois::substrate::PerThreadStorage<StrCgMapFreq> LocalStrCgMapFreq;
 /*
 class Status {
 protected:
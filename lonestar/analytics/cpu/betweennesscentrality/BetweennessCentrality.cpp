@@ -25,9 +25,10 @@
 
 constexpr static const char* const REGION_NAME = "BC";
 
-enum Algo { Level = 0, Async, Outer, AutoAlgo };
+enum Algo { Level = 0, Async, Outer, MultiSource, AutoAlgo };
 
-const char* const ALGO_NAMES[] = {"Level", "Async", "Outer", "Auto"};
+const char* const ALGO_NAMES[] = {"Level", "Async", "Outer", "MultiSource",
+                                  "Auto"};
 
 const uint32_t infinity = std::numeric_limits<uint32_t>::max() / 4;
 
@@ -69,13 +70,23 @@ static cll::opt<uint64_t>
                 cll::init(0));
 
 static cll::opt<bool>
-    output("output", cll::desc("Output BC (Level/Async) (default: false)"),
+    output("output",
+           cll::desc("Output BC (Level/Async/MultiSource) (default: false)"),
            cll::init(false));
 
+static cll::opt<unsigned int>
+    msBatchSize("batchSize",
+                cll::desc("MultiSource: number of sources traversed "
+                          "concurrently (default 64, maximum 64)"),
+                cll::init(64));
+
 static cll::opt<Algo> algo(
     "algo", cll::desc("Choose an algorithm (default value AutoAlgo):"),
     cll::values(clEnumVal(Level, "Level"), clEnumVal(Async, "Async"),
                 clEnumVal(Outer, "Outer"),
+                clEnumVal(MultiSource,
+                          "MultiSource: batched bitmask BFS, 64 sources at a "
+                          "time"),
                 clEnumVal(AutoAlgo,
                           "Auto: choose among the algorithms automatically")),
     cll::init(AutoAlgo));
@@ -96,6 +107,7 @@ static const char* desc = "Computes betwenness centrality in an unweighted "
 #include "LevelStructs.h"
 #include "AsyncStructs.h"
 #include "OuterStructs.h"
+#include "MultiSourceStructs.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -137,6 +149,11 @@ int main(int argc, char** argv) {
     galois::gInfo("Running outer BC");
     doOuterBC();
     break;
+  case MultiSource:
+    // see MultiSourceStructs.h
+    galois::gInfo("Running multi-source BC");
+    doMultiSourceBC();
+    break;
   default:
     GALOIS_DIE("Unknown BC algorithm type");
   }
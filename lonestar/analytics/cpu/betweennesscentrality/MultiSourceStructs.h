@@ -0,0 +1,219 @@
+#ifndef GALOIS_BC_MULTISOURCE
+#define GALOIS_BC_MULTISOURCE
+
+#include "galois/AtomicHelpers.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "Lonestar/BFS_SSSP.h"
+
+#include <fstream>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using MultiSourceBFS = MultiSourceBFS_SSSP<OuterGraph, uint32_t, false>;
+using MSLaneMask     = MultiSourceBFS::LaneMask;
+
+/**
+ * Brandes BC that runs the forward BFS of up to 64 sources at once with the
+ * bitmask engine in Lonestar/BFS_SSSP.h. Shortest path counts, dependencies
+ * and levels are kept per (node, lane) in node-major arrays; the backward
+ * phase walks the per-level frontiers kept by the engine.
+ */
+class BCMultiSource {
+  OuterGraph& graph;
+  unsigned numLanes;
+  MultiSourceBFS engine;
+
+  galois::LargeArray<std::atomic<double>> sigma;
+  galois::LargeArray<double> delta;
+  galois::LargeArray<uint32_t> level;
+  galois::LargeArray<double> bc;
+
+  size_t idx(OuterGNode n, unsigned lane) const {
+    return size_t{n} * numLanes + lane;
+  }
+
+  template <typename F>
+  static void forEachLane(MSLaneMask mask, const F& f) {
+    while (mask) {
+      f(static_cast<unsigned>(__builtin_ctzll(mask)));
+      mask &= mask - 1;
+    }
+  }
+
+  void resetBatch() {
+    galois::do_all(
+        galois::iterate(size_t{0}, sigma.size()),
+        [&](size_t i) {
+          sigma[i].store(0, std::memory_order_relaxed);
+          delta[i] = 0;
+          level[i] = infinity;
+        },
+        galois::no_stats(), galois::loopname("MultiSourceReset"));
+  }
+
+  //! forward phase: count shortest paths of every lane
+  unsigned forward(const std::vector<OuterGNode>& sources) {
+    return engine.bfsBatch(
+        sources,
+        [&](OuterGNode src, OuterGNode dst, MSLaneMask lanes, unsigned) {
+          forEachLane(lanes, [&](unsigned lane) {
+            galois::atomicAdd(
+                sigma[idx(dst, lane)],
+                sigma[idx(src, lane)].load(std::memory_order_relaxed));
+          });
+        },
+        [&](OuterGNode n, MSLaneMask lanes, unsigned l) {
+          forEachLane(lanes, [&](unsigned lane) {
+            level[idx(n, lane)] = l;
+            if (l == 0) {
+              sigma[idx(n, lane)].store(1, std::memory_order_relaxed);
+            }
+          });
+        },
+        true);
+  }
+
+  //! backward phase: accumulate dependencies level by level
+  void backward(unsigned numLevels) {
+    auto& levels = engine.getLevels();
+
+    // the deepest level has no successors and the source level gets no
+    // contribution, so skip both
+    for (unsigned l = numLevels - 1; l > 1; --l) {
+      const uint32_t curLevel  = l - 1;
+      const uint32_t succLevel = l;
+
+      galois::do_all(
+          galois::iterate(levels[curLevel]),
+          [&](OuterGNode n) {
+            MSLaneMask active = 0;
+            for (unsigned lane = 0; lane < numLanes; ++lane) {
+              if (level[idx(n, lane)] == curLevel) {
+                active |= MSLaneMask{1} << lane;
+              }
+            }
+
+            for (auto e : graph.edges(n, galois::MethodFlag::UNPROTECTED)) {
+              OuterGNode dst = graph.getEdgeDst(e);
+              forEachLane(active, [&](unsigned lane) {
+                if (level[idx(dst, lane)] == succLevel) {
+                  delta[idx(n, lane)] +=
+                      (1.0 + delta[idx(dst, lane)]) /
+                      sigma[idx(dst, lane)].load(std::memory_order_relaxed);
+                }
+              });
+            }
+
+            double contrib = 0;
+            forEachLane(active, [&](unsigned lane) {
+              delta[idx(n, lane)] *=
+                  sigma[idx(n, lane)].load(std::memory_order_relaxed);
+              contrib += delta[idx(n, lane)];
+            });
+            // a node is in at most one frontier per level, so no other
+            // thread updates its bc in this loop
+            bc[n] += contrib;
+          },
+          galois::steal(), galois::chunk_size<LEVEL_CHUNK_SIZE>(),
+          galois::no_stats(), galois::loopname("Brandes"));
+    }
+  }
+
+public:
+  BCMultiSource(OuterGraph& g, unsigned lanes)
+      : graph(g), numLanes(lanes), engine(g, lanes) {
+    size_t numEntries = graph.size() * size_t{numLanes};
+    sigma.create(numEntries, 0.0);
+    delta.create(numEntries, 0.0);
+    level.create(numEntries, infinity);
+    bc.create(graph.size(), 0.0);
+  }
+
+  //! Adds the BC contribution of every source, numLanes sources at a time
+  void run(const std::vector<OuterGNode>& sources) {
+    for (size_t b = 0; b < sources.size(); b += numLanes) {
+      std::vector<OuterGNode> batch(
+          sources.begin() + b,
+          sources.begin() + std::min(sources.size(), b + numLanes));
+      resetBatch();
+      backward(forward(batch));
+    }
+  }
+
+  double getBC(OuterGNode n) const { return bc[n]; }
+
+  //! sanity check of BC values
+  void sanity() {
+    galois::GReduceMax<double> accumMax;
+    galois::GReduceMin<double> accumMin;
+    galois::GAccumulator<double> accumSum;
+
+    galois::do_all(
+        galois::iterate(graph),
+        [&](OuterGNode n) {
+          accumMax.update(bc[n]);
+          accumMin.update(bc[n]);
+          accumSum += bc[n];
+        },
+        galois::no_stats(), galois::loopname("MultiSourceSanity"));
+
+    galois::gPrint("Max BC is ", accumMax.reduce(), "\n");
+    galois::gPrint("Min BC is ", accumMin.reduce(), "\n");
+    galois::gPrint("BC sum is ", accumSum.reduce(), "\n");
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void doMultiSourceBC() {
+  OuterGraph graph;
+  galois::graphs::readGraph(graph, inputFile);
+
+  if (msBatchSize == 0 || msBatchSize > MultiSourceBFS::MAX_LANES) {
+    GALOIS_DIE("batchSize must be in [1, ", MultiSourceBFS::MAX_LANES, "]");
+  }
+
+  // sources from file if provided, else the first numOfSources nodes (or all
+  // nodes if not specified)
+  std::vector<OuterGNode> sources;
+  if (singleSourceBC) {
+    sources.push_back(startSource);
+  } else if (sourcesToUse != "") {
+    sources = readNodesFile<OuterGNode>(sourcesToUse, graph.size());
+    if (numOfSources && numOfSources < sources.size()) {
+      sources.resize(numOfSources);
+    }
+  } else {
+    size_t end = numOfSources ? std::min<size_t>(numOfSources, graph.size())
+                              : graph.size();
+    for (size_t i = 0; i < end; ++i) {
+      sources.push_back(i);
+    }
+  }
+
+  galois::gInfo("Running ", sources.size(), " sources in batches of ",
+                msBatchSize);
+  galois::reportPageAlloc("MemAllocPre");
+  BCMultiSource bcMS(graph, msBatchSize);
+  galois::reportPageAlloc("MemAllocMid");
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  bcMS.run(sources);
+  execTime.stop();
+
+  galois::reportPageAlloc("MemAllocPost");
+
+  bcMS.sanity();
+
+  if (output) {
+    char* v_out = (char*)malloc(40);
+    for (auto ii = graph.begin(); ii != graph.end(); ++ii) {
+      sprintf(v_out, "%u %.9f\n", (*ii), bcMS.getBC(*ii));
+      galois::gPrint(v_out);
+    }
+    free(v_out);
+  }
+}
+#endif
@@ -18,6 +18,7 @@
  */
 
 #include "galois/Galois.h"
+#include "galois/Frontier.h"
 #include "galois/gstl.h"
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
@@ -25,6 +26,7 @@
 #include "galois/graphs/TypeTraits.h"
 #include "Lonestar/BoilerPlate.h"
 #include "Lonestar/BFS_SSSP.h"
+#include "Lonestar/Utils.h"
 
 #include "llvm/Support/CommandLine.h"
 
@@ -52,6 +54,17 @@ static cll::opt<unsigned int>
     reportNode("reportNode",
                cll::desc("Node to report distance to (default value 1)"),
                cll::init(1));
+static cll::opt<std::string>
+    sourcesFile("sourcesFile",
+                cll::desc("File of whitespace separated sources; runs a "
+                          "batched multi-source BFS from every source "
+                          "instead of a single search from startNode"),
+                cll::init(""));
+static cll::opt<unsigned int>
+    batchSize("batchSize",
+              cll::desc("Number of sources searched concurrently in "
+                        "sourcesFile mode (default value 64, maximum 64)"),
+              cll::init(64));
 
 // static cll::opt<unsigned int> stepShiftw("delta",
 // cll::desc("Shift value for the deltastep"),
@@ -86,6 +99,7 @@ constexpr static const unsigned CHUNK_SIZE      = 256U;
 constexpr static const ptrdiff_t EDGE_TILE_SIZE = 256;
 
 using BFS = BFS_SSSP<Graph, unsigned int, false, EDGE_TILE_SIZE>;
+using MultiSourceBFS = MultiSourceBFS_SSSP<Graph, unsigned int, false>;
 
 using UpdateRequest       = BFS::UpdateRequest;
 using Dist                = BFS::Dist;
@@ -292,6 +306,38 @@ void syncAlgo(Graph& graph, GNode source, const P& pushWrap,
   }
 }
 
+/**
+ * Sync over nodes with a frontier that is a bitmap on dense levels; pushes
+ * of the same node by several threads are dropped.
+ */
+void syncFrontierAlgo(Graph& graph, GNode source) {
+  constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  galois::Frontier<GNode> frontier(graph.size());
+
+  Dist nextLevel              = 0U;
+  graph.getData(source, flag) = 0U;
+  frontier.push(source);
+
+  for (frontier.advance(); !frontier.empty(); frontier.advance()) {
+    ++nextLevel;
+
+    frontier.do_all(
+        [&](GNode n) {
+          for (auto e : graph.edges(n, flag)) {
+            auto dst      = graph.getEdgeDst(e);
+            auto& dstData = graph.getData(dst, flag);
+
+            if (dstData == BFS::DIST_INFINITY) {
+              dstData = nextLevel;
+              frontier.push(dst);
+            }
+          }
+        },
+        "Sync");
+  }
+}
+
 template <bool CONCURRENT>
 void runAlgo(Graph& graph, const GNode& source) {
 
@@ -309,14 +355,69 @@ void runAlgo(Graph& graph, const GNode& source) {
                                    TileRangeFn());
     break;
   case Sync:
-    syncAlgo<CONCURRENT, GNode>(graph, source, NodePushWrap(),
-                                OutEdgeRangeFn{graph});
+    if (CONCURRENT) {
+      syncFrontierAlgo(graph, source);
+    } else {
+      syncAlgo<CONCURRENT, GNode>(graph, source, NodePushWrap(),
+                                  OutEdgeRangeFn{graph});
+    }
     break;
   default:
     std::cerr << "ERROR: unkown algo type\n";
   }
 }
 
+//! Runs a BFS from every source in sourcesFile, batchSize sources at a time
+void runMultiSource(Graph& graph) {
+  std::vector<GNode> sources =
+      readNodesFile<GNode>(sourcesFile, graph.size());
+  if (batchSize == 0 || batchSize > MultiSourceBFS::MAX_LANES) {
+    GALOIS_DIE("batchSize must be in [1, ", MultiSourceBFS::MAX_LANES, "]");
+  }
+  galois::gInfo("Running multi-source BFS from ", sources.size(),
+                " sources in batches of ", batchSize);
+
+  MultiSourceBFS engine(graph, batchSize);
+
+  galois::GReduceMax<uint64_t> maxDistance;
+  galois::GAccumulator<uint64_t> visitedPairs;
+  galois::StatTimer execTime("Timer_0");
+
+  for (size_t b = 0; b < sources.size(); b += batchSize) {
+    std::vector<GNode> batch(
+        sources.begin() + b,
+        sources.begin() + std::min(sources.size(), b + batchSize));
+
+    execTime.start();
+    engine.bfs(batch);
+    execTime.stop();
+
+    const unsigned numLanes = batch.size();
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          for (unsigned lane = 0; lane < numLanes; ++lane) {
+            Dist d = engine.dist(n, lane);
+            if (d != MultiSourceBFS::DIST_INFINITY) {
+              maxDistance.update(d);
+              visitedPairs += 1;
+            }
+          }
+        },
+        galois::loopname("Sanity check"), galois::no_stats());
+
+    if (!skipVerify && !engine.verify(batch)) {
+      GALOIS_DIE("verification failed");
+    }
+  }
+
+  galois::gInfo("# visited (source, node) pairs is ", visitedPairs.reduce());
+  galois::gInfo("Max distance is ", maxDistance.reduce());
+  if (!skipVerify) {
+    std::cout << "Verification successful.\n";
+  }
+}
+
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   LonestarStart(argc, argv, name, desc, url, &inputFile);
@@ -333,6 +434,12 @@ int main(int argc, char** argv) {
   std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
             << " edges\n";
 
+  if (!sourcesFile.empty()) {
+    runMultiSource(graph);
+    totalTime.stop();
+    return 0;
+  }
+
   if (startNode >= graph.size() || reportNode >= graph.size()) {
     std::cerr << "failed to set report: " << reportNode
               << " or failed to set source: " << startNode << "\n";
@@ -346,9 +453,8 @@ int main(int argc, char** argv) {
   std::advance(it, reportNode.getValue());
   report = *it;
 
-  size_t approxNodeData = 4 * (graph.size() + graph.sizeEdges());
-  galois::preAlloc(8 * numThreads +
-                   approxNodeData / galois::runtime::pagePoolSize());
+  // a node is queued at most once per incoming edge
+  galois::preAllocFor<GNode>(graph, 1, 1);
 
   galois::reportPageAlloc("MeminfoPre");
 
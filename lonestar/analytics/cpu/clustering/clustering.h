@@ -21,6 +21,7 @@
 #define CLUSTERING_H
 
 #include "galois/Galois.h"
+#include "galois/Arena.h"
 #include "galois/AtomicHelpers.h"
 #include "galois/LargeArray.h"
 
@@ -88,6 +89,13 @@ typedef float EdgeTy;
 // typedef uint32_t EdgeTy;
 typedef galois::LargeArray<EdgeTy> largeArrayEdgeTy;
 
+//! Per-node map from neighboring cluster to local index, kept in an arena
+typedef std::map<uint64_t, uint64_t, std::less<uint64_t>,
+                 galois::ArenaAllocator<std::pair<const uint64_t, uint64_t>>>
+    ArenaClusterMap;
+//! Per-node edge weights to the clusters of an ArenaClusterMap
+typedef std::vector<EdgeTy, galois::ArenaAllocator<EdgeTy>> ArenaCounter;
+
 template <typename GraphTy>
 void printGraphCharateristics(GraphTy& graph) {
 
@@ -102,10 +110,9 @@ void printGraphCharateristics(GraphTy& graph) {
  * Algorithm to find the best cluster for the node
  * to move to among its neighbors.
  */
-template <typename GraphTy>
+template <typename GraphTy, typename MapTy, typename CounterTy>
 void findNeighboringClusters(GraphTy& graph, typename GraphTy::GraphNode& n,
-                             std::map<uint64_t, uint64_t>& cluster_local_map,
-                             std::vector<EdgeTy>& counter,
+                             MapTy& cluster_local_map, CounterTy& counter,
                              EdgeTy& self_loop_wt) {
   using GNode = typename GraphTy::GraphNode;
   for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
@@ -245,10 +252,11 @@ double calConstantForSecondTerm(GraphTy& graph) {
   return 1 / total_edge_weight_twice;
 }
 
-template <typename GraphTy, typename CommArrayTy>
-uint64_t maxCPMQuality(std::map<uint64_t, uint64_t>& cluster_local_map,
-                       std::vector<EdgeTy>& counter, EdgeTy self_loop_wt,
-                       CommArrayTy& c_info, uint64_t node_wt, uint64_t sc) {
+template <typename GraphTy, typename CommArrayTy, typename MapTy,
+          typename CounterTy>
+uint64_t maxCPMQuality(MapTy& cluster_local_map, CounterTy& counter,
+                       EdgeTy self_loop_wt, CommArrayTy& c_info,
+                       uint64_t node_wt, uint64_t sc) {
 
   uint64_t max_index = sc; // Assign the initial value as self community
   double cur_gain    = 0;
@@ -330,11 +338,10 @@ double calCPMQuality(GraphTy& graph, CommArrayTy& c_info, double& e_xx,
   return mod;
 }
 
-template <typename CommArrayTy>
-uint64_t maxModularity(std::map<uint64_t, uint64_t>& cluster_local_map,
-                       std::vector<EdgeTy>& counter, EdgeTy self_loop_wt,
-                       CommArrayTy& c_info, EdgeTy degree_wt, uint64_t sc,
-                       double constant) {
+template <typename CommArrayTy, typename MapTy, typename CounterTy>
+uint64_t maxModularity(MapTy& cluster_local_map, CounterTy& counter,
+                       EdgeTy self_loop_wt, CommArrayTy& c_info,
+                       EdgeTy degree_wt, uint64_t sc, double constant) {
 
   uint64_t max_index = sc; // Assign the intial value as self community
   double cur_gain    = 0;
@@ -370,12 +377,11 @@ uint64_t maxModularity(std::map<uint64_t, uint64_t>& cluster_local_map,
   return max_index;
 }
 
-template <typename CommArrayTy>
-uint64_t
-maxModularityWithoutSwaps(std::map<uint64_t, uint64_t>& cluster_local_map,
-                          std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
-                          CommArrayTy& c_info, EdgeTy degree_wt, uint64_t sc,
-                          double constant) {
+template <typename CommArrayTy, typename MapTy, typename CounterTy>
+uint64_t maxModularityWithoutSwaps(MapTy& cluster_local_map,
+                                   CounterTy& counter, uint64_t self_loop_wt,
+                                   CommArrayTy& c_info, EdgeTy degree_wt,
+                                   uint64_t sc, double constant) {
 
   uint64_t max_index = sc; // Assign the intial value as self community
   double cur_gain    = 0;
@@ -420,10 +426,10 @@ maxModularityWithoutSwaps(std::map<uint64_t, uint64_t>& cluster_local_map,
   return max_index;
 }
 
-template <typename GraphTy, typename CommArrayTy>
+template <typename GraphTy, typename CommArrayTy, typename DegreeUpdateTy>
 double calModularityDelay(GraphTy& graph, CommArrayTy& c_info,
-                          CommArrayTy& c_update, double& e_xx, double& a2_x,
-                          double& constant_for_second_term,
+                          const DegreeUpdateTy& degree_update, double& e_xx,
+                          double& a2_x, double& constant_for_second_term,
                           std::vector<uint64_t>& local_target) {
   using GNode = typename GraphTy::GraphNode;
   /* Variables needed for Modularity calculation */
@@ -451,8 +457,8 @@ double calModularityDelay(GraphTy& graph, CommArrayTy& c_info,
 
   galois::do_all(galois::iterate(graph), [&](GNode n) {
     acc_e_xx += cluster_wt_internal[n];
-    acc_a2_x += (double)(c_info[n].degree_wt + c_update[n].degree_wt) *
-                ((double)(c_info[n].degree_wt + c_update[n].degree_wt) *
+    acc_a2_x += (double)(c_info[n].degree_wt + degree_update[n]) *
+                ((double)(c_info[n].degree_wt + degree_update[n]) *
                  (double)constant_for_second_term);
   });
 
@@ -129,6 +129,7 @@ double algoLeidenWithLocking(Graph& graph, double lower, double threshold,
                  "===========================================\n");
 
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
+  galois::PerThreadArena arena;
   TimerClusteringWhile.start();
   while (true) {
     num_iter++;
@@ -146,10 +147,13 @@ double algoLeidenWithLocking(Graph& graph, double lower, double threshold,
                                           graph.edge_end(n, flag_write_lock));
 
           uint64_t local_target = UNASSIGNED;
-          std::map<uint64_t, uint64_t>
-              cluster_local_map; // Map each neighbor's cluster to local number:
-                                 // Community --> Index
-          std::vector<EdgeTy> counter; // Number of edges to each unique cluster
+          // An aborted iteration skips the destructor of an ArenaScope, so
+          // start every iteration from an empty arena instead
+          arena.local().reset();
+          // Map each neighbor's cluster to local number: Community --> Index
+          ArenaClusterMap cluster_local_map(arena.allocator());
+          // Number of edges to each unique cluster
+          ArenaCounter counter(arena.allocator());
           EdgeTy self_loop_wt = 0;
 
           if (degree > 0) {
@@ -208,6 +212,7 @@ double algoLeidenWithLocking(Graph& graph, double lower, double threshold,
     prev_mod = curr_mod;
   } // End while
   TimerClusteringWhile.stop();
+  arena.reportStats("leiden algo: Phase 1");
 
   iter = num_iter;
 
@@ -123,6 +123,7 @@ double algoLouvainWithLocking(Graph& graph, double lower, double threshold,
                  "===========================================\n");
 
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
+  galois::PerThreadArena arena;
   TimerClusteringWhile.start();
   while (true) {
     num_iter++;
@@ -139,10 +140,13 @@ double algoLouvainWithLocking(Graph& graph, double lower, double threshold,
           uint64_t degree = std::distance(graph.edge_begin(n, flag_write_lock),
                                           graph.edge_end(n, flag_write_lock));
           uint64_t local_target = UNASSIGNED;
-          std::map<uint64_t, uint64_t>
-              cluster_local_map; // Map each neighbor's cluster to local number:
-                                 // Community --> Index
-          std::vector<EdgeTy> counter; // Number of edges to each unique cluster
+          // An aborted iteration skips the destructor of an ArenaScope, so
+          // start every iteration from an empty arena instead
+          arena.local().reset();
+          // Map each neighbor's cluster to local number: Community --> Index
+          ArenaClusterMap cluster_local_map(arena.allocator());
+          // Number of edges to each unique cluster
+          ArenaCounter counter(arena.allocator());
           EdgeTy self_loop_wt = 0;
           if (degree > 0) {
 
@@ -196,6 +200,7 @@ double algoLouvainWithLocking(Graph& graph, double lower, double threshold,
 
   } // End while
   TimerClusteringWhile.stop();
+  arena.reportStats("louvain algo: Phase 1");
 
   iter = num_iter;
 
@@ -255,6 +260,7 @@ double algoLouvainWithoutLockingDoAll(Graph& graph, double lower,
                  "===========================================\n");
 
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
+  galois::PerThreadArena arena;
   TimerClusteringWhile.start();
   while (true) {
     num_iter++;
@@ -271,10 +277,11 @@ double algoLouvainWithoutLockingDoAll(Graph& graph, double lower,
           uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
                                           graph.edge_end(n, flag_no_lock));
           uint64_t local_target = UNASSIGNED;
-          std::map<uint64_t, uint64_t>
-              cluster_local_map; // Map each neighbor's cluster to local number:
-                                 // Community --> Index
-          std::vector<EdgeTy> counter; // Number of edges to each unique cluster
+          galois::ArenaScope scope(arena);
+          // Map each neighbor's cluster to local number: Community --> Index
+          ArenaClusterMap cluster_local_map(scope.allocator());
+          // Number of edges to each unique cluster
+          ArenaCounter counter(scope.allocator());
           EdgeTy self_loop_wt = 0;
 
           if (degree > 0) {
@@ -328,6 +335,7 @@ double algoLouvainWithoutLockingDoAll(Graph& graph, double lower,
 
   } // End while
   TimerClusteringWhile.stop();
+  arena.reportStats("louvain algo: Phase 1");
 
   iter = num_iter;
 
@@ -348,8 +356,7 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
   galois::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
   TimerClusteringTotal.start();
 
-  CommArray c_info;   // Community info
-  CommArray c_update; // Used for updating community
+  CommArray c_info; // Community info
 
   /* Variables needed for Modularity calculation */
   double constant_for_second_term;
@@ -360,7 +367,9 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
 
   /*** Initialization ***/
   c_info.allocateBlocked(graph.size());
-  c_update.allocateBlocked(graph.size());
+  // Per-thread changes of community degree weights and sizes in a round
+  galois::GArrayAccumulator<EdgeTy> degree_update(graph.size());
+  galois::GArrayAccumulator<int64_t> size_update(graph.size());
 
   /* Initialization each node to its own cluster */
   galois::do_all(galois::iterate(graph), [&graph](GNode n) {
@@ -386,15 +395,11 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
                  "===========================================\n");
 
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
+  galois::PerThreadArena arena;
   TimerClusteringWhile.start();
   while (true) {
     num_iter++;
 
-    galois::do_all(galois::iterate(graph), [&](GNode n) {
-      c_update[n].degree_wt = 0;
-      c_update[n].size      = 0;
-    });
-
     std::vector<uint64_t> local_target(graph.size(), UNASSIGNED);
     galois::GAccumulator<uint32_t> syncRound;
     galois::do_all(
@@ -403,10 +408,11 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
           auto& n_data    = graph.getData(n, flag_write_lock);
           uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
                                           graph.edge_end(n, flag_no_lock));
-          std::map<uint64_t, uint64_t>
-              cluster_local_map; // Map each neighbor's cluster to local number:
-                                 // Community --> Index
-          std::vector<EdgeTy> counter; // Number of edges to each unique cluster
+          galois::ArenaScope scope(arena);
+          // Map each neighbor's cluster to local number: Community --> Index
+          ArenaClusterMap cluster_local_map(scope.allocator());
+          // Number of edges to each unique cluster
+          ArenaCounter counter(scope.allocator());
           EdgeTy self_loop_wt = 0;
 
           if (degree > 0) {
@@ -425,13 +431,10 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
           if (local_target[n] != n_data.curr_comm_ass &&
               local_target[n] != UNASSIGNED) {
 
-            galois::atomicAdd(c_update[local_target[n]].degree_wt,
-                              n_data.degree_wt);
-            galois::atomicAdd(c_update[local_target[n]].size, (uint64_t)1);
-            galois::atomicSubtract(c_update[n_data.curr_comm_ass].degree_wt,
-                                   n_data.degree_wt);
-            galois::atomicSubtract(c_update[n_data.curr_comm_ass].size,
-                                   (uint64_t)1);
+            degree_update.update(local_target[n], n_data.degree_wt);
+            size_update.update(local_target[n], 1);
+            degree_update.update(n_data.curr_comm_ass, -n_data.degree_wt);
+            size_update.update(n_data.curr_comm_ass, -1);
           }
         },
         galois::loopname("louvain algo: Phase 1"));
@@ -439,7 +442,8 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
     /* Calculate the overall modularity */
     double e_xx = 0;
     double a2_x = 0;
-    curr_mod    = calModularityDelay(graph, c_info, c_update, e_xx, a2_x,
+    std::vector<EdgeTy>& degree_delta = degree_update.reduce();
+    curr_mod = calModularityDelay(graph, c_info, degree_delta, e_xx, a2_x,
                                   constant_for_second_term, local_target);
     galois::gPrint(num_iter, "        ", e_xx, "        ", a2_x, "        ",
                    lower, "      ", prev_mod, "       ", curr_mod, "\n");
@@ -455,28 +459,26 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
     if (prev_mod < lower)
       prev_mod = lower;
 
+    std::vector<int64_t>& size_delta = size_update.reduce();
     galois::do_all(galois::iterate(graph), [&](GNode n) {
       auto& n_data         = graph.getData(n, flag_no_lock);
       n_data.prev_comm_ass = n_data.curr_comm_ass;
       n_data.curr_comm_ass = local_target[n];
-      galois::atomicAdd(c_info[n].size, c_update[n].size.load());
-      galois::atomicAdd(c_info[n].degree_wt, c_update[n].degree_wt.load());
-
-      c_update[n].size      = 0;
-      c_update[n].degree_wt = 0;
+      c_info[n].size += size_delta[n];
+      galois::atomicAdd(c_info[n].degree_wt, degree_delta[n]);
     });
+    degree_update.reset();
+    size_update.reset();
 
   } // End while
   TimerClusteringWhile.stop();
+  arena.reportStats("louvain algo: Phase 1");
 
   iter = num_iter;
 
   c_info.destroy();
   c_info.deallocate();
 
-  c_update.destroy();
-  c_update.deallocate();
-
   TimerClusteringTotal.stop();
   return prev_mod;
 }
@@ -571,8 +573,7 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
 
   galois::gPrint("Inside algoLouvainWithColoring\n");
 
-  CommArray c_info;   // Community info
-  CommArray c_update; // Used for updating community
+  CommArray c_info; // Community info
 
   /* Variables needed for Modularity calculation */
   double constant_for_second_term;
@@ -583,7 +584,9 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
 
   /*** Initialization ***/
   c_info.allocateBlocked(graph.size());
-  c_update.allocateBlocked(graph.size());
+  // Per-thread changes of community degree weights and sizes in a round
+  galois::GArrayAccumulator<EdgeTy> degree_update(graph.size());
+  galois::GArrayAccumulator<int64_t> size_update(graph.size());
 
   /* Initialization each node to its own cluster */
   galois::do_all(galois::iterate(graph), [&graph](GNode n) {
@@ -614,12 +617,8 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
   galois::gPrint("============================================================="
                  "===========================================\n");
 
-  galois::do_all(galois::iterate(graph), [&](GNode n) {
-    c_update[n].degree_wt = 0;
-    c_update[n].size      = 0;
-  });
-
   galois::StatTimer TimerClusteringWhile("Timer_Clustering_While");
+  galois::PerThreadArena arena;
   TimerClusteringWhile.start();
   while (true) {
     num_iter++;
@@ -634,11 +633,12 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
               uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
                                               graph.edge_end(n, flag_no_lock));
               uint64_t local_target = UNASSIGNED;
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map; // Map each neighbor's cluster to local
-                                     // number: Community --> Index
-              std::vector<EdgeTy>
-                  counter; // Number of edges to each unique cluster
+              galois::ArenaScope scope(arena);
+              // Map each neighbor's cluster to local number:
+              // Community --> Index
+              ArenaClusterMap cluster_local_map(scope.allocator());
+              // Number of edges to each unique cluster
+              ArenaCounter counter(scope.allocator());
               EdgeTy self_loop_wt = 0;
 
               if (degree > 0) {
@@ -655,13 +655,10 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
               /* Update cluster info */
               if (local_target != n_data.curr_comm_ass &&
                   local_target != UNASSIGNED) {
-                galois::atomicAdd(c_update[local_target].degree_wt,
-                                  n_data.degree_wt);
-                galois::atomicAdd(c_update[local_target].size, (uint64_t)1);
-                galois::atomicSubtract(c_update[n_data.curr_comm_ass].degree_wt,
-                                       n_data.degree_wt);
-                galois::atomicSubtract(c_update[n_data.curr_comm_ass].size,
-                                       (uint64_t)1);
+                degree_update.update(local_target, n_data.degree_wt);
+                size_update.update(local_target, 1);
+                degree_update.update(n_data.curr_comm_ass, -n_data.degree_wt);
+                size_update.update(n_data.curr_comm_ass, -1);
                 /* Set the new cluster id */
                 n_data.curr_comm_ass = local_target;
               }
@@ -669,12 +666,14 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
           },
           galois::loopname("louvain algo: Phase 1"));
 
+      std::vector<EdgeTy>& degree_delta = degree_update.reduce();
+      std::vector<int64_t>& size_delta  = size_update.reduce();
       galois::do_all(galois::iterate(graph), [&](GNode n) {
-        galois::atomicAdd(c_info[n].size, c_update[n].size.load());
-        galois::atomicAdd(c_info[n].degree_wt, c_update[n].degree_wt.load());
-        c_update[n].size      = 0;
-        c_update[n].degree_wt = 0;
+        c_info[n].size += size_delta[n];
+        galois::atomicAdd(c_info[n].degree_wt, degree_delta[n]);
       });
+      degree_update.reset();
+      size_update.reset();
     }
 
     /* Calculate the overall modularity */
@@ -697,15 +696,13 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
 
   } // End while
   TimerClusteringWhile.stop();
+  arena.reportStats("louvain algo: Phase 1");
 
   iter = num_iter;
 
   c_info.destroy();
   c_info.deallocate();
 
-  c_update.destroy();
-  c_update.deallocate();
-
   TimerClusteringTotal.stop();
   return prev_mod;
 }
@@ -0,0 +1,414 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/UnionFind.h"
+#include "galois/graphs/DynamicCSRGraph.h"
+#include "galois/graphs/ReadGraph.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "Lonestar/BoilerPlate.h"
+#include "Lonestar/Utils.h"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <atomic>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+const char* name = "Incremental Connected Components";
+const char* desc = "Maintains the connected components of a symmetric graph "
+                   "under batches of edge insertions and deletions";
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string>
+    inputFile(cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<std::string>
+    updatesFile("updates",
+                cll::desc("File with one edge update per line: 'a src dst' or "
+                          "'d src dst' (default: random updates)"),
+                cll::init(""));
+static cll::opt<unsigned> batchSize("batchSize",
+                                    cll::desc("Updates per batch "
+                                              "(default 10000)"),
+                                    cll::init(10000));
+static cll::opt<unsigned>
+    numBatches("numBatches",
+               cll::desc("Number of random batches (default 10)"),
+               cll::init(10));
+static cll::opt<double>
+    deleteRatio("deleteRatio",
+                cll::desc("Fraction of random updates that are deletions "
+                          "(default 0.5)"),
+                cll::init(0.5));
+static cll::opt<unsigned> seed("seed",
+                               cll::desc("Seed of random updates (default 0)"),
+                               cll::init(0));
+static cll::opt<double> compactThreshold(
+    "compactThreshold",
+    cll::desc("Compact the graph when more than this fraction of edges is in "
+              "overflow blocks (default 0.2)"),
+    cll::init(0.2));
+static cll::opt<unsigned> searchBudget(
+    "searchBudget",
+    cll::desc("Edges a deletion may visit looking for another path between "
+              "the endpoints before relabeling their component (default "
+              "4096)"),
+    cll::init(4096));
+
+//! smallest useful search budget of a deletion
+constexpr static const uint64_t MIN_SEARCH_BUDGET = 64;
+//! extra space left for each node when compacting, relative to its degree
+constexpr static const double COMPACT_SLACK = 0.1;
+
+struct Node : public galois::UnionFindNode<Node> {
+  using component_type = Node*;
+
+  //! last batch whose deletions made this node be relabeled
+  std::atomic<uint32_t> epoch;
+
+  Node() : galois::UnionFindNode<Node>(const_cast<Node*>(this)), epoch(0) {}
+
+  component_type component() { return this->get(); }
+  void makeRep() { this->m_component.store(this, std::memory_order_relaxed); }
+};
+
+using Graph  = galois::graphs::DynamicCSRGraph<Node, void>;
+using GNode  = Graph::GraphNode;
+using Update = Graph::EdgeUpdate;
+
+/**
+ * Union-find over a dynamic graph. Insertions are merged into the current
+ * union-find forest. A deletion can only split the component containing the
+ * deleted edge, and every piece of a split component contains an endpoint of
+ * a deleted edge. A bounded bidirectional search first looks for another
+ * path between the endpoints of each deleted edge; if it finds one, the edge
+ * did not split anything. The remaining endpoints seed a traversal that
+ * resets the nodes it reaches, followed by a union-find over the edges of
+ * those nodes only. Unaffected components are not touched.
+ */
+class IncrementalCC {
+  Graph& graph;
+  uint32_t batchId = 0;
+  galois::GAccumulator<uint64_t> work;
+
+  struct SearchState {
+    //! side of the search that reached a node: 1 from src, 2 from dst
+    std::unordered_map<GNode, uint8_t> side;
+    std::vector<GNode> frontier[2];
+    std::vector<GNode> next;
+  };
+  galois::substrate::PerThreadStorage<SearchState> searchState;
+
+  //! adds the reverse of every update, as the graph is symmetric
+  static void mirror(std::vector<Update>& updates) {
+    size_t size = updates.size();
+    for (size_t i = 0; i < size; ++i) {
+      Update u = updates[i];
+      std::swap(u.src, u.dst);
+      updates.push_back(u);
+    }
+  }
+
+  void mergeEdges(GNode src) {
+    Node& sdata = graph.getData(src);
+    for (auto e : graph.edges(src)) {
+      GNode dst = graph.getEdgeDst(e);
+      if (src < dst) {
+        sdata.merge(&graph.getData(dst));
+      }
+    }
+    work += graph.getDegree(src);
+  }
+
+  //! true if a path between src and dst was found within budget edges
+  bool reconnected(GNode src, GNode dst, uint64_t budget) {
+    SearchState& st = *searchState.getLocal();
+    st.side.clear();
+    st.frontier[0].assign(1, src);
+    st.frontier[1].assign(1, dst);
+    st.side[src] = 1;
+    st.side[dst] = 2;
+
+    uint64_t visited = 0;
+    bool found       = false;
+    while (!found && visited < budget && !st.frontier[0].empty() &&
+           !st.frontier[1].empty()) {
+      // expand the smaller side
+      unsigned s = st.frontier[0].size() <= st.frontier[1].size() ? 0 : 1;
+      uint8_t me = s + 1;
+      st.next.clear();
+      for (GNode n : st.frontier[s]) {
+        for (auto e : graph.edges(n)) {
+          GNode d    = graph.getEdgeDst(e);
+          uint8_t& m = st.side[d];
+          if (m == 0) {
+            m = me;
+            st.next.push_back(d);
+          } else if (m != me) {
+            found = true;
+            break;
+          }
+        }
+        visited += graph.getDegree(n);
+        if (found || visited >= budget) {
+          break;
+        }
+      }
+      std::swap(st.frontier[s], st.next);
+    }
+    work += visited;
+    return found;
+  }
+
+  //! relabels the components containing the seeds
+  void relabel(galois::InsertBag<GNode>& seeds) {
+    galois::InsertBag<GNode> affected;
+
+    galois::for_each(
+        galois::iterate(seeds),
+        [&](GNode n, auto& ctx) {
+          Node& data   = graph.getData(n);
+          uint32_t old = data.epoch.load(std::memory_order_relaxed);
+          if (old == batchId ||
+              !data.epoch.compare_exchange_strong(old, batchId)) {
+            return;
+          }
+          data.makeRep();
+          affected.push(n);
+          for (auto e : graph.edges(n)) {
+            GNode dst = graph.getEdgeDst(e);
+            if (graph.getData(dst).epoch.load(std::memory_order_relaxed) !=
+                batchId) {
+              ctx.push(dst);
+            }
+          }
+          work += graph.getDegree(n);
+        },
+        galois::disable_conflict_detection(), galois::no_stats(),
+        galois::wl<galois::worklists::PerSocketChunkFIFO<64>>(),
+        galois::loopname("CC-Relabel-Reset"));
+
+    galois::do_all(
+        galois::iterate(affected), [&](GNode n) { mergeEdges(n); },
+        galois::steal(), galois::loopname("CC-Relabel-Merge"));
+  }
+
+public:
+  explicit IncrementalCC(Graph& g) : graph(g) {}
+
+  //! union-find over the whole graph
+  void recompute() {
+    galois::do_all(
+        galois::iterate(graph), [&](GNode n) { graph.getData(n).makeRep(); },
+        galois::no_stats());
+    galois::do_all(
+        galois::iterate(graph), [&](GNode n) { mergeEdges(n); },
+        galois::steal(), galois::loopname("CC-Full"));
+  }
+
+  void applyDeletions(std::vector<Update>& deletions) {
+    mirror(deletions);
+    ++batchId;
+
+    // only edges that exist can split a component
+    galois::InsertBag<Update> removed;
+    galois::GAccumulator<uint64_t> numRemoved;
+    galois::do_all(
+        galois::iterate(deletions),
+        [&](const Update& u) {
+          if (u.src >= u.dst) {
+            return;
+          }
+          if (graph.findEdge(u.src, u.dst) != graph.edge_end(u.src)) {
+            removed.push(u);
+            numRemoved += 1;
+          }
+          work += graph.getDegree(u.src);
+        },
+        galois::no_stats());
+
+    graph.deleteEdges(deletions);
+
+    // split the budget so that all searches together visit at most about as
+    // many edges as a relabeling would; if that leaves too little for a
+    // search to be useful, relabel right away
+    uint64_t budget =
+        std::min<uint64_t>(searchBudget, graph.sizeEdges() /
+                                             std::max<uint64_t>(
+                                                 1, numRemoved.reduce()));
+    if (budget < MIN_SEARCH_BUDGET) {
+      budget = 0;
+    }
+    galois::InsertBag<GNode> seeds;
+    galois::do_all(
+        galois::iterate(removed),
+        [&](const Update& u) {
+          if (!reconnected(u.src, u.dst, budget)) {
+            seeds.push(u.src);
+            seeds.push(u.dst);
+          }
+        },
+        galois::steal(), galois::loopname("CC-Reconnect"));
+
+    if (!seeds.empty()) {
+      relabel(seeds);
+    }
+  }
+
+  void applyInsertions(std::vector<Update>& insertions) {
+    mirror(insertions);
+    graph.insertEdges(insertions);
+    galois::do_all(
+        galois::iterate(insertions),
+        [&](const Update& u) {
+          graph.getData(u.src).merge(&graph.getData(u.dst));
+        },
+        galois::no_stats());
+    work += insertions.size();
+  }
+
+  //! edges visited since the last call
+  uint64_t takeWork() {
+    uint64_t w = work.reduce();
+    work.reset();
+    return w;
+  }
+
+  GNode component(GNode n) {
+    return graph.getData(n).find() - &graph.getData(0);
+  }
+};
+
+//! Checks that the partition into components matches a full recomputation
+bool verify(Graph& graph, IncrementalCC& cc) {
+  galois::LargeArray<GNode> incremental;
+  incremental.allocateBlocked(graph.size());
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) { incremental[n] = cc.component(n); }, galois::no_stats());
+
+  galois::StatTimer fullTime("TimerFullRecompute");
+  fullTime.start();
+  cc.recompute();
+  fullTime.stop();
+
+  galois::GAccumulator<size_t> mismatches;
+  galois::GAccumulator<size_t> components;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        GNode full = cc.component(n);
+        if (full == n) {
+          components += 1;
+        }
+        if (cc.component(incremental[n]) != full ||
+            incremental[full] != incremental[n]) {
+          mismatches += 1;
+        }
+      },
+      galois::no_stats());
+
+  std::cout << "Total components: " << components.reduce() << "\n";
+  return mismatches.reduce() == 0;
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, nullptr, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    GALOIS_DIE("This application requires a symmetric graph input;"
+               " please use the -symmetricGraph flag "
+               " to indicate the input is a symmetric graph.");
+  }
+
+  Graph graph;
+  galois::graphs::readGraph(graph, inputFile);
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges\n";
+
+  IncrementalCC cc(graph);
+  galois::StatTimer initTime("TimerInitial");
+  initTime.start();
+  cc.recompute();
+  initTime.stop();
+  cc.takeWork();
+
+  galois::reportPageAlloc("MeminfoPre");
+
+  EdgeUpdateSource<Graph> source(updatesFile, batchSize, numBatches,
+                                 deleteRatio, seed);
+  EdgeUpdateSource<Graph>::Batch batch;
+  uint64_t numApplied    = 0;
+  uint64_t numUpdates    = 0;
+  uint64_t totalWork     = 0;
+  uint64_t fullWorkBound = 0;
+  unsigned numCompactions = 0;
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  while (source.next(graph, batch)) {
+    numUpdates += batch.size();
+    cc.applyDeletions(batch.deletions);
+    cc.applyInsertions(batch.insertions);
+    totalWork += cc.takeWork();
+    // a union-find from scratch visits every edge once
+    fullWorkBound += graph.sizeEdges();
+    numApplied += 1;
+    if (graph.compactIfNeeded(compactThreshold, COMPACT_SLACK)) {
+      numCompactions += 1;
+    }
+  }
+  execTime.stop();
+
+  galois::reportPageAlloc("MeminfoPost");
+
+  std::cout << "Applied " << numApplied << " batches (" << numUpdates
+            << " updates), graph now has " << graph.sizeEdges() << " edges\n";
+  std::cout << "Edges visited: " << totalWork << " incremental vs "
+            << fullWorkBound << " for recomputing after every batch ("
+            << (fullWorkBound ? double(totalWork) / fullWorkBound : 0.0)
+            << ")\n";
+  galois::runtime::reportStat_Single("IncrementalCC", "Batches", numApplied);
+  galois::runtime::reportStat_Single("IncrementalCC", "EdgeWork", totalWork);
+  galois::runtime::reportStat_Single("IncrementalCC", "FullEdgeWork",
+                                     fullWorkBound);
+  galois::runtime::reportStat_Single("IncrementalCC", "Compactions",
+                                     numCompactions);
+
+  if (!skipVerify) {
+    if (!verify(graph, cc)) {
+      GALOIS_DIE("verification failed");
+    }
+    std::cout << "Verification successful.\n";
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
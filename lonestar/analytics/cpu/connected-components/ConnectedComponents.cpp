@@ -20,6 +20,7 @@
 #include "galois/Galois.h"
 #include "galois/AtomicHelpers.h"
 #include "galois/Bag.h"
+#include "galois/Frontier.h"
 #include "galois/ParallelSTL.h"
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
@@ -203,29 +204,30 @@ struct LabelPropAlgo {
   }
 
   void operator()(Graph& graph) {
-    galois::GReduceLogicalOr changed;
-    do {
-      changed.reset();
-      galois::do_all(
-          galois::iterate(graph),
+    // nodes whose label dropped since they last sent it; at first all
+    galois::Frontier<GNode> frontier(graph.size());
+    frontier.push_all();
+
+    for (frontier.advance(); !frontier.empty(); frontier.advance()) {
+      frontier.do_all(
           [&](const GNode& src) {
             LNode& sdata = graph.getData(src, galois::MethodFlag::UNPROTECTED);
             if (sdata.comp_old > sdata.comp_current) {
               sdata.comp_old = sdata.comp_current;
 
-              changed.update(true);
-
               for (auto e : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
                 GNode dst              = graph.getEdgeDst(e);
                 auto& ddata            = graph.getData(dst);
                 unsigned int label_new = sdata.comp_current;
-                galois::atomicMin(ddata.comp_current, label_new);
+                if (galois::atomicMin(ddata.comp_current, label_new) >
+                    label_new) {
+                  frontier.push(dst);
+                }
               }
             }
           },
-          galois::disable_conflict_detection(), galois::steal(),
-          galois::loopname("LabelPropAlgo"));
-    } while (changed.reduce());
+          "LabelPropAlgo");
+    }
   }
 };
 
@@ -1183,9 +1185,7 @@ void run() {
 
   initialize(graph);
 
-  galois::preAlloc(numThreads +
-                   (3 * graph.size() * sizeof(typename Graph::node_data_type)) /
-                       galois::runtime::pagePoolSize());
+  galois::preAllocFor<typename Graph::node_data_type>(graph, 3);
   galois::reportPageAlloc("MeminfoPre");
 
   galois::StatTimer execTime("Timer_0");
@@ -0,0 +1,766 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/AtomicHelpers.h"
+#include "galois/Bag.h"
+#include "galois/Endian.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/graphs/LCGraph.h"
+#include "Lonestar/BoilerPlate.h"
+#include "Lonestar/BFS_SSSP.h"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace cll = llvm::cl;
+
+static const char* name = "Graph Server";
+static const char* desc =
+    "Keeps graphs resident in memory and answers bfs/sssp/cc/pagerank/k-core "
+    "queries read line by line from stdin or a Unix domain socket";
+
+static cll::list<std::string>
+    preload(cll::Positional,
+            cll::desc("[<name>=<input file> ...] graphs to load at startup"));
+static cll::opt<std::string>
+    socketPath("socket",
+               cll::desc("Serve queries on this Unix domain socket instead "
+                         "of stdin"),
+               cll::init(""));
+static cll::opt<std::string>
+    queriesFile("queries",
+                cll::desc("Read queries from this file instead of stdin"),
+                cll::init(""));
+static cll::opt<unsigned int>
+    stepShift("delta",
+              cll::desc("Default shift value for the delta-step sssp queries "
+                        "(default value 13)"),
+              cll::init(13));
+
+constexpr static const char* const REGION_NAME = "GraphServer";
+constexpr static const unsigned CHUNK_SIZE     = 64U;
+
+using Graph = galois::graphs::LC_CSR_Graph<void, uint32_t>::with_no_lockable<
+    true>::type::with_numa_alloc<true>::type;
+using GNode = Graph::GraphNode;
+
+using SSSP                 = BFS_SSSP<Graph, uint32_t, true>;
+using Dist                 = SSSP::Dist;
+using UpdateRequest        = SSSP::UpdateRequest;
+using UpdateRequestIndexer = SSSP::UpdateRequestIndexer;
+
+using PRTy = float;
+
+constexpr static const PRTy ALPHA = 0.85;
+
+/**
+ * A resident graph plus scratch node arrays that are allocated by the first
+ * query that needs them and reused by every later query on the graph.
+ */
+struct LoadedGraph {
+  Graph graph;
+  //! false if the file has no 32-bit edge data; sssp then uses unit weights
+  bool weighted;
+
+  galois::LargeArray<std::atomic<uint32_t>> label;
+  galois::LargeArray<std::atomic<PRTy>> residual;
+  galois::LargeArray<std::atomic<PRTy>> rank;
+
+  void ensureLabels() {
+    if (label.size() == 0) {
+      label.create(graph.size(), 0U);
+    }
+  }
+
+  void ensureRanks() {
+    if (rank.size() == 0) {
+      rank.create(graph.size(), PRTy{0});
+      residual.create(graph.size(), PRTy{0});
+    }
+  }
+
+  Dist weight(Graph::edge_iterator e) {
+    return weighted ? graph.getEdgeData(e) : 1;
+  }
+};
+
+//! Latency samples of one query type, in microseconds
+struct LatencyStats {
+  std::vector<uint64_t> samples;
+
+  void add(uint64_t us) { samples.push_back(us); }
+
+  std::string summary() const {
+    if (samples.empty()) {
+      return "count=0";
+    }
+    std::vector<uint64_t> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t total = 0;
+    for (auto s : sorted) {
+      total += s;
+    }
+    auto pct = [&](double p) {
+      return sorted[std::min(sorted.size() - 1,
+                             static_cast<size_t>(p * sorted.size()))];
+    };
+
+    std::ostringstream out;
+    out << "count=" << sorted.size() << " mean_us=" << total / sorted.size()
+        << " p50_us=" << pct(0.50) << " p95_us=" << pct(0.95)
+        << " p99_us=" << pct(0.99) << " max_us=" << sorted.back();
+    return out.str();
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Query kernels
+////////////////////////////////////////////////////////////////////////////////
+
+std::string runBFS(LoadedGraph& lg, GNode source, GNode report) {
+  Graph& graph = lg.graph;
+  lg.ensureLabels();
+  auto& dist = lg.label;
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) { dist[n].store(SSSP::DIST_INFINITY); }, galois::no_stats(),
+      galois::loopname("BFSInit"));
+  dist[source] = 0;
+
+  auto curr = std::make_unique<galois::InsertBag<GNode>>();
+  auto next = std::make_unique<galois::InsertBag<GNode>>();
+  next->push(source);
+
+  Dist level = 0;
+  galois::GAccumulator<size_t> reached;
+  reached += 1;
+
+  while (!next->empty()) {
+    std::swap(curr, next);
+    next->clear();
+    ++level;
+
+    galois::do_all(
+        galois::iterate(*curr),
+        [&](GNode src) {
+          for (auto e : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
+            GNode dst    = graph.getEdgeDst(e);
+            uint32_t old = SSSP::DIST_INFINITY;
+            if (dist[dst].load(std::memory_order_relaxed) == old &&
+                dist[dst].compare_exchange_strong(old, level)) {
+              next->push(dst);
+              reached += 1;
+            }
+          }
+        },
+        galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname("BFS"));
+  }
+
+  std::ostringstream out;
+  out << "reached=" << reached.reduce() << " levels=" << level - 1
+      << " dist[" << report << "]=" << dist[report].load();
+  return out.str();
+}
+
+std::string runSSSP(LoadedGraph& lg, GNode source, GNode report,
+                    unsigned shift) {
+  namespace gwl = galois::worklists;
+  using PSchunk = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
+  using OBIM    = gwl::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
+
+  Graph& graph = lg.graph;
+  lg.ensureLabels();
+  auto& dist = lg.label;
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) { dist[n].store(SSSP::DIST_INFINITY); }, galois::no_stats(),
+      galois::loopname("SSSPInit"));
+  dist[source] = 0;
+
+  galois::InsertBag<UpdateRequest> initBag;
+  initBag.push(UpdateRequest(source, 0));
+
+  galois::for_each(
+      galois::iterate(initBag),
+      [&](const UpdateRequest& req, auto& ctx) {
+        if (dist[req.src].load(std::memory_order_relaxed) < req.dist) {
+          return;
+        }
+        for (auto e : graph.edges(req.src, galois::MethodFlag::UNPROTECTED)) {
+          GNode dst   = graph.getEdgeDst(e);
+          Dist newDist = req.dist + lg.weight(e);
+          if (galois::atomicMin(dist[dst], newDist) > newDist) {
+            ctx.push(UpdateRequest(dst, newDist));
+          }
+        }
+      },
+      galois::wl<OBIM>(UpdateRequestIndexer{shift}),
+      galois::disable_conflict_detection(), galois::loopname("SSSP"));
+
+  galois::GAccumulator<size_t> reached;
+  galois::GReduceMax<Dist> maxDist;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        Dist d = dist[n].load(std::memory_order_relaxed);
+        if (d != SSSP::DIST_INFINITY) {
+          reached += 1;
+          maxDist.update(d);
+        }
+      },
+      galois::no_stats(), galois::loopname("SSSPSummary"));
+
+  std::ostringstream out;
+  out << "reached=" << reached.reduce() << " maxDist=" << maxDist.reduce()
+      << " dist[" << report << "]=" << dist[report].load();
+  return out.str();
+}
+
+//! Checks that every cc label is the smallest node of its component: labels
+//! are roots no larger than their node and both ends of an edge share one
+void verifyCC(LoadedGraph& lg) {
+  Graph& graph = lg.graph;
+  auto& label  = lg.label;
+
+  galois::GAccumulator<size_t> numBad;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        GNode l = label[n].load(std::memory_order_relaxed);
+        if (l > n || label[l].load(std::memory_order_relaxed) != l) {
+          numBad += 1;
+          return;
+        }
+        for (auto e : graph.edges(n, galois::MethodFlag::UNPROTECTED)) {
+          if (label[graph.getEdgeDst(e)].load(std::memory_order_relaxed) !=
+              l) {
+            numBad += 1;
+            return;
+          }
+        }
+      },
+      galois::no_stats(), galois::loopname("CCVerify"));
+
+  if (numBad.reduce()) {
+    GALOIS_DIE("cc verification failed: ", numBad.reduce(),
+               " nodes with a wrong label");
+  }
+}
+
+//! Weakly connected components with lock-free union-find
+std::string runCC(LoadedGraph& lg) {
+  Graph& graph = lg.graph;
+  lg.ensureLabels();
+  auto& parent = lg.label;
+
+  galois::do_all(
+      galois::iterate(graph), [&](GNode n) { parent[n].store(n); },
+      galois::no_stats(), galois::loopname("CCInit"));
+
+  // path halving; concurrent unions only ever lower parents
+  auto find = [&](GNode x) {
+    GNode p = parent[x].load(std::memory_order_relaxed);
+    while (p != x) {
+      GNode gp = parent[p].load(std::memory_order_relaxed);
+      if (gp != p) {
+        // CAS on a copy: a failed CAS must not redirect the walk below
+        GNode expected = p;
+        parent[x].compare_exchange_weak(expected, gp,
+                                        std::memory_order_relaxed);
+      }
+      x = p;
+      p = gp;
+    }
+    return x;
+  };
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode src) {
+        for (auto e : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
+          GNode a = find(src);
+          GNode b = find(graph.getEdgeDst(e));
+          // link the larger root under the smaller one
+          while (a != b) {
+            if (a < b) {
+              std::swap(a, b);
+            }
+            GNode expected = a;
+            if (parent[a].compare_exchange_strong(expected, b)) {
+              break;
+            }
+            a = find(a);
+            b = find(b);
+          }
+        }
+      },
+      galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+      galois::loopname("CCUnion"));
+
+  galois::GAccumulator<size_t> numComponents;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        GNode root = find(n);
+        parent[n].store(root, std::memory_order_relaxed);
+        if (root == n) {
+          numComponents += 1;
+        }
+      },
+      galois::no_stats(), galois::loopname("CCCompress"));
+
+  if (!skipVerify) {
+    verifyCC(lg);
+  }
+
+  std::ostringstream out;
+  out << "components=" << numComponents.reduce();
+  return out.str();
+}
+
+//! Round-based residual push PageRank
+std::string runPageRank(LoadedGraph& lg, PRTy tolerance,
+                        unsigned maxIterations) {
+  Graph& graph = lg.graph;
+  lg.ensureRanks();
+  auto& rank     = lg.rank;
+  auto& residual = lg.residual;
+
+  galois::InsertBag<GNode> active;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        rank[n].store(0, std::memory_order_relaxed);
+        residual[n].store(1 - ALPHA, std::memory_order_relaxed);
+        active.push(n);
+      },
+      galois::no_stats(), galois::loopname("PageRankInit"));
+
+  galois::InsertBag<GNode> next;
+  unsigned iter = 0;
+  for (; !active.empty() && iter < maxIterations; ++iter) {
+    galois::do_all(
+        galois::iterate(active),
+        [&](GNode src) {
+          if (residual[src].load(std::memory_order_relaxed) <= tolerance) {
+            return;
+          }
+          PRTy res = residual[src].exchange(0, std::memory_order_relaxed);
+          // src is pushed again if its residual crosses the tolerance
+          // after being taken, so two threads may update its rank
+          galois::atomicAdd(rank[src], res);
+          auto beg = graph.edge_begin(src, galois::MethodFlag::UNPROTECTED);
+          auto end = graph.edge_end(src, galois::MethodFlag::UNPROTECTED);
+          if (beg == end) {
+            return;
+          }
+          PRTy delta = res * ALPHA / std::distance(beg, end);
+          for (; beg != end; ++beg) {
+            GNode dst = graph.getEdgeDst(beg);
+            PRTy old  = galois::atomicAdd(residual[dst], delta);
+            if (old <= tolerance && old + delta > tolerance) {
+              next.push(dst);
+            }
+          }
+        },
+        galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname("PageRank"));
+
+    active.clear();
+    std::swap(active, next);
+  }
+
+  galois::GReduceMax<PRTy> maxRank;
+  galois::GAccumulator<double> sumRank;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        PRTy r = rank[n].load(std::memory_order_relaxed);
+        maxRank.update(r);
+        sumRank += r;
+      },
+      galois::no_stats(), galois::loopname("PageRankSummary"));
+
+  std::ostringstream out;
+  out << "iterations=" << iter << " converged=" << (active.empty() ? 1 : 0)
+      << " maxRank=" << maxRank.reduce() << " sumRank=" << sumRank.reduce();
+  return out.str();
+}
+
+//! k-core membership; the graph must be symmetric
+std::string runKCore(LoadedGraph& lg, uint32_t k) {
+  Graph& graph = lg.graph;
+  lg.ensureLabels();
+  auto& degree = lg.label;
+
+  auto curr = std::make_unique<galois::InsertBag<GNode>>();
+  auto next = std::make_unique<galois::InsertBag<GNode>>();
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        uint32_t d = graph.getDegree(n);
+        degree[n].store(d, std::memory_order_relaxed);
+        if (d < k) {
+          next->push(n);
+        }
+      },
+      galois::no_stats(), galois::loopname("KCoreInit"));
+
+  while (!next->empty()) {
+    std::swap(curr, next);
+    next->clear();
+
+    galois::do_all(
+        galois::iterate(*curr),
+        [&](GNode dead) {
+          for (auto e : graph.edges(dead, galois::MethodFlag::UNPROTECTED)) {
+            GNode dst = graph.getEdgeDst(e);
+            if (galois::atomicSubtract(degree[dst], 1U) == k) {
+              next->push(dst);
+            }
+          }
+        },
+        galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname("KCore"));
+  }
+
+  galois::GAccumulator<size_t> alive;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        // degrees of dead nodes may underflow, so compare against the
+        // original degree as well
+        uint32_t d = degree[n].load(std::memory_order_relaxed);
+        if (d >= k && d <= graph.getDegree(n)) {
+          alive += 1;
+        }
+      },
+      galois::no_stats(), galois::loopname("KCoreSummary"));
+
+  std::ostringstream out;
+  out << "alive=" << alive.reduce();
+  return out.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Request handling
+////////////////////////////////////////////////////////////////////////////////
+
+//! Checks that file is a complete .gr file before FileGraph, which dies on
+//! bad input, touches it; returns the size of the edge data
+uint64_t checkGraphFile(const std::string& file) {
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("cannot open " + file + ": " +
+                             std::strerror(errno));
+  }
+  struct stat buf;
+  uint64_t header[4];
+  bool ok = fstat(fd, &buf) == 0 &&
+            pread(fd, header, sizeof(header), 0) == ssize_t(sizeof(header));
+  close(fd);
+  if (!ok) {
+    throw std::runtime_error(file + " is not a graph file");
+  }
+
+  uint64_t version    = galois::convert_le64toh(header[0]);
+  uint64_t sizeofEdge = galois::convert_le64toh(header[1]);
+  uint64_t numNodes   = galois::convert_le64toh(header[2]);
+  uint64_t numEdges   = galois::convert_le64toh(header[3]);
+  if (version != 1 && version != 2) {
+    throw std::runtime_error(file + " is not a graph file");
+  }
+  // the header and edge index, the edge destinations padded to 8 bytes and
+  // the edge data must fit; each is checked against what is left so that
+  // nothing overflows
+  uint64_t left      = buf.st_size - sizeof(header);
+  uint64_t sizeofDst = version == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+  uint64_t padded    = numEdges + numEdges % 2;
+  if (numNodes > left / sizeof(uint64_t)) {
+    throw std::runtime_error(file + " is truncated");
+  }
+  left -= numNodes * sizeof(uint64_t);
+  if (padded > left / sizeofDst) {
+    throw std::runtime_error(file + " is truncated");
+  }
+  left -= padded * sizeofDst;
+  if (sizeofEdge && numEdges > left / sizeofEdge) {
+    throw std::runtime_error(file + " is truncated");
+  }
+  return sizeofEdge;
+}
+
+class GraphServer {
+  std::map<std::string, std::unique_ptr<LoadedGraph>> graphs;
+  std::map<std::string, LatencyStats> latencies;
+
+  LoadedGraph& lookup(const std::string& graphName) {
+    auto it = graphs.find(graphName);
+    if (it == graphs.end()) {
+      throw std::runtime_error("unknown graph " + graphName);
+    }
+    return *it->second;
+  }
+
+  GNode parseNode(LoadedGraph& lg, std::istream& in, GNode def) {
+    uint64_t n = def;
+    if (!(in >> n)) {
+      return def;
+    }
+    if (n >= lg.graph.size()) {
+      throw std::runtime_error("node " + std::to_string(n) +
+                               " is out of range");
+    }
+    return n;
+  }
+
+public:
+  std::string load(const std::string& graphName, const std::string& file) {
+    uint64_t sizeofEdge = checkGraphFile(file);
+    auto lg             = std::make_unique<LoadedGraph>();
+    lg->weighted        = sizeofEdge == sizeof(uint32_t);
+    galois::graphs::readGraph(lg->graph, file, !lg->weighted);
+
+    std::ostringstream out;
+    out << "nodes=" << lg->graph.size() << " edges=" << lg->graph.sizeEdges()
+        << " weighted=" << lg->weighted;
+    graphs[graphName] = std::move(lg);
+    return out.str();
+  }
+
+  //! Executes one request line; returns false on quit
+  bool handle(const std::string& line, std::ostream& reply) {
+    std::istringstream in(line);
+    std::string cmd;
+    if (!(in >> cmd)) {
+      return true;
+    }
+    if (cmd == "quit" || cmd == "shutdown") {
+      reply << "OK bye\n";
+      return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string result;
+
+    try {
+      if (cmd == "load") {
+        std::string graphName, file;
+        if (!(in >> graphName >> file)) {
+          throw std::runtime_error("usage: load <name> <file>");
+        }
+        result = load(graphName, file);
+      } else if (cmd == "unload") {
+        std::string graphName;
+        in >> graphName;
+        if (!graphs.erase(graphName)) {
+          throw std::runtime_error("unknown graph " + graphName);
+        }
+      } else if (cmd == "graphs") {
+        std::ostringstream out;
+        for (auto& g : graphs) {
+          out << g.first << ":" << g.second->graph.size() << ":"
+              << g.second->graph.sizeEdges() << " ";
+        }
+        result = out.str();
+      } else if (cmd == "stats") {
+        std::ostringstream out;
+        for (auto& l : latencies) {
+          out << l.first << "{" << l.second.summary() << "} ";
+        }
+        result = out.str();
+      } else {
+        std::string graphName;
+        in >> graphName;
+        LoadedGraph& lg = lookup(graphName);
+
+        if (cmd == "bfs") {
+          GNode source = parseNode(lg, in, 0);
+          result       = runBFS(lg, source, parseNode(lg, in, source));
+        } else if (cmd == "sssp") {
+          GNode source = parseNode(lg, in, 0);
+          GNode report = parseNode(lg, in, source);
+          unsigned shift = stepShift;
+          in >> shift;
+          result = runSSSP(lg, source, report, shift);
+        } else if (cmd == "cc") {
+          result = runCC(lg);
+        } else if (cmd == "pagerank") {
+          PRTy tolerance         = 1.0e-3;
+          unsigned maxIterations = 1000;
+          in >> tolerance >> maxIterations;
+          result = runPageRank(lg, tolerance, maxIterations);
+        } else if (cmd == "kcore") {
+          uint32_t k;
+          if (!(in >> k)) {
+            throw std::runtime_error("usage: kcore <name> <k>");
+          }
+          result = runKCore(lg, k);
+        } else {
+          throw std::runtime_error("unknown command " + cmd);
+        }
+      }
+    } catch (const std::exception& e) {
+      reply << "ERROR " << e.what() << "\n";
+      return true;
+    }
+
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    latencies[cmd].add(us);
+    reply << "OK " << cmd << " " << result << " time_us=" << us << "\n";
+    return true;
+  }
+
+  //! Reports per-query latency totals through the stat manager
+  void reportStats() {
+    for (auto& l : latencies) {
+      uint64_t total = 0;
+      for (auto s : l.second.samples) {
+        total += s;
+      }
+      galois::runtime::reportStat_Single(REGION_NAME, l.first + "Queries",
+                                         l.second.samples.size());
+      galois::runtime::reportStat_Single(REGION_NAME, l.first + "TotalUs",
+                                         total);
+    }
+  }
+};
+
+//! Serves one client per connection until a client sends quit
+void serveSocket(GraphServer& server, const std::string& path) {
+  int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd < 0) {
+    GALOIS_SYS_DIE("socket failed");
+  }
+
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    GALOIS_DIE("socket path too long: ", path);
+  }
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(path.c_str());
+
+  if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(listenFd, 16) < 0) {
+    GALOIS_SYS_DIE("failed to listen on ", path);
+  }
+  galois::gInfo("Listening on ", path);
+
+  bool running = true;
+  while (running) {
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) {
+      continue;
+    }
+
+    std::string pending;
+    char buf[4096];
+    ssize_t n;
+    while (running && (n = read(fd, buf, sizeof(buf))) > 0) {
+      pending.append(buf, n);
+      size_t pos;
+      while (running && (pos = pending.find('\n')) != std::string::npos) {
+        std::ostringstream reply;
+        running = server.handle(pending.substr(0, pos), reply);
+        pending.erase(0, pos + 1);
+
+        std::string r = reply.str();
+        if (write(fd, r.data(), r.size()) < 0) {
+          break;
+        }
+      }
+    }
+    close(fd);
+  }
+
+  close(listenFd);
+  unlink(path.c_str());
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, nullptr, nullptr);
+
+  GraphServer server;
+
+  for (const std::string& spec : preload) {
+    size_t eq = spec.find('=');
+    if (eq == std::string::npos) {
+      GALOIS_DIE("expected <name>=<input file>, got ", spec);
+    }
+    std::ostringstream reply;
+    server.handle("load " + spec.substr(0, eq) + " " + spec.substr(eq + 1),
+                  reply);
+    std::cout << reply.str() << std::flush;
+  }
+
+  if (!socketPath.empty()) {
+    serveSocket(server, socketPath);
+  } else {
+    std::ifstream queries;
+    if (!queriesFile.empty()) {
+      queries.open(queriesFile);
+      if (!queries) {
+        GALOIS_DIE("failed to open ", queriesFile);
+      }
+    }
+    std::istream& in = queriesFile.empty() ? std::cin : queries;
+
+    std::string line;
+    while (std::getline(in, line)) {
+      std::ostringstream reply;
+      bool running = server.handle(line, reply);
+      std::cout << reply.str() << std::flush;
+      if (!running) {
+        break;
+      }
+    }
+  }
+
+  server.reportStats();
+  return 0;
+}
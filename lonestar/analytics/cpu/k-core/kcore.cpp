@@ -20,6 +20,7 @@
 #include "galois/Galois.h"
 #include "galois/gstl.h"
 #include "galois/AtomicHelpers.h"
+#include "galois/Frontier.h"
 #include "galois/Reduction.h"
 #include "galois/graphs/LCGraph.h"
 #include "Lonestar/BoilerPlate.h"
@@ -98,43 +99,38 @@ void degreeCounting(Graph& graph) {
  * Setup initial worklist of dead nodes.
  *
  * @param graph Graph to operate on
- * @param initialWorklist Empty worklist to be filled with dead nodes.
+ * @param initialWorklist Empty worklist (an InsertBag or the next frontier of
+ * a Frontier) to be filled with dead nodes.
  */
-void setupInitialWorklist(Graph& graph,
-                          galois::InsertBag<GNode>& initialWorklist) {
+template <typename Worklist>
+void setupInitialWorklist(Graph& graph, Worklist& initialWorklist) {
   galois::do_all(
       galois::iterate(graph.begin(), graph.end()),
       [&](GNode curNode) {
         NodeData& curData = graph.getData(curNode);
         if (curData.currentDegree < k_core_num) {
           //! Dead node, add to initialWorklist for processing later.
-          initialWorklist.emplace(curNode);
+          initialWorklist.push(curNode);
         }
       },
       galois::loopname("InitialWorklistSetup"), galois::no_stats());
 }
 
 /**
- * Starting with initial dead nodes as current worklist; decrement degree;
- * add to next worklist; switch next with current and repeat until worklist
- * is empty (i.e. no more dead nodes).
+ * Starting with initial dead nodes as current frontier; decrement degree;
+ * add to next frontier; advance and repeat until the frontier is empty
+ * (i.e. no more dead nodes).
  *
  * @param graph Graph to operate on
  */
 void syncCascadeKCore(Graph& graph) {
-  galois::InsertBag<GNode>* current = new galois::InsertBag<GNode>;
-  galois::InsertBag<GNode>* next    = new galois::InsertBag<GNode>;
+  galois::Frontier<GNode> frontier(graph.size());
 
-  //! Setup worklist.
-  setupInitialWorklist(graph, *next);
+  //! Setup frontier.
+  setupInitialWorklist(graph, frontier);
 
-  while (!next->empty()) {
-    //! Make "next" into current.
-    std::swap(current, next);
-    next->clear();
-
-    galois::do_all(
-        galois::iterate(*current),
+  for (frontier.advance(); !frontier.empty(); frontier.advance()) {
+    frontier.do_all(
         [&](GNode deadNode) {
           //! Decrement degree of all neighbors.
           for (auto e : graph.edges(deadNode)) {
@@ -145,17 +141,13 @@ void syncCascadeKCore(Graph& graph) {
 
             if (oldDegree == k_core_num) {
               //! This thread was responsible for putting degree of destination
-              //! below threshold; add to worklist.
-              next->emplace(dest);
+              //! below threshold; add to frontier.
+              frontier.push(dest);
             }
           }
         },
-        galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
-        galois::loopname("SyncCascadeDeadNodes"));
+        "SyncCascadeDeadNodes");
   }
-
-  delete current;
-  delete next;
 }
 
 /**
@@ -250,9 +242,8 @@ int main(int argc, char** argv) {
   //! Preallocate pages in memory so allocation doesn't occur during compute.
   galois::StatTimer preallocTime("PreAllocTime", REGION_NAME);
   preallocTime.start();
-  galois::preAlloc(
-      std::max(size_t{galois::getActiveThreads()} * (graph.size() / 1000000),
-               std::max(10U, galois::getActiveThreads()) * size_t{10}));
+  // a node is queued once, when it drops out of the core
+  galois::preAllocFor<GNode>(graph, 1);
   preallocTime.stop();
   galois::reportPageAlloc("MemAllocMid");
 
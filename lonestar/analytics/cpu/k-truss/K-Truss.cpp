@@ -618,9 +618,8 @@ void run() {
   std::cout << "Running " << algo.name() << " algorithm for maximal "
             << trussNum << "-truss\n";
 
-  size_t approxEdgeData = 4 * (graph.size() + graph.sizeEdges());
-  galois::preAlloc(numThreads +
-                   4 * (approxEdgeData) / galois::runtime::pagePoolSize());
+  // the edges of the current and the next round
+  galois::preAllocFor<Edge>(graph, 0, 2);
   galois::reportPageAlloc("MeminfoPre");
 
   initialize(graph);
@@ -298,9 +298,7 @@ int main(int argc, char** argv) {
   std::cout << "Read " << transposeGraph.size() << " nodes, "
             << transposeGraph.sizeEdges() << " edges\n";
 
-  galois::preAlloc(2 * numThreads + (3 * transposeGraph.size() *
-                                     sizeof(typename Graph::node_data_type)) /
-                                        galois::runtime::pagePoolSize());
+  galois::preAllocFor<typename Graph::node_data_type>(transposeGraph, 3);
   galois::reportPageAlloc("MeminfoPre");
 
   switch (algo) {
@@ -0,0 +1,308 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "Lonestar/BoilerPlate.h"
+#include "Lonestar/Utils.h"
+#include "PageRank-constants.h"
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/graphs/DynamicCSRGraph.h"
+#include "galois/graphs/ReadGraph.h"
+
+#include <cmath>
+
+/**
+ * Push-based PageRank maintained under batches of edge updates.
+ *
+ * The push algorithm keeps, for every node v, a value x_v and a residual r_v
+ * such that
+ *
+ *   r_v = (1 - ALPHA) + ALPHA * sum_{u -> v} x_u / outdeg(u) - x_v.
+ *
+ * Changing the out-edges of u only changes this sum for the old and new
+ * out-neighbors of u, so after a batch the invariant is restored by taking
+ * ALPHA * x_u / outdeg(u) back from every old out-neighbor and giving
+ * ALPHA * x_u / outdeg'(u) to every new one. Residual push then runs from the
+ * nodes whose residuals changed only. Residuals can become negative, so nodes
+ * are pushed when the magnitude of their residual exceeds the tolerance.
+ */
+
+const char* desc = "Maintains page ranks a la Page and Brin under batches of "
+                   "edge insertions and deletions. This is a push-style "
+                   "algorithm.";
+
+constexpr static const unsigned CHUNK_SIZE = 16;
+
+static cll::opt<std::string>
+    updatesFile("updates",
+                cll::desc("File with one edge update per line: 'a src dst' or "
+                          "'d src dst' (default: random updates)"),
+                cll::init(""));
+static cll::opt<unsigned> batchSize("batchSize",
+                                    cll::desc("Updates per batch "
+                                              "(default 10000)"),
+                                    cll::init(10000));
+static cll::opt<unsigned>
+    numBatches("numBatches",
+               cll::desc("Number of random batches (default 10)"),
+               cll::init(10));
+static cll::opt<double>
+    deleteRatio("deleteRatio",
+                cll::desc("Fraction of random updates that are deletions "
+                          "(default 0.5)"),
+                cll::init(0.5));
+static cll::opt<unsigned> seed("seed",
+                               cll::desc("Seed of random updates (default 0)"),
+                               cll::init(0));
+static cll::opt<double> compactThreshold(
+    "compactThreshold",
+    cll::desc("Compact the graph when more than this fraction of edges is in "
+              "overflow blocks (default 0.2)"),
+    cll::init(0.2));
+
+//! extra space left for each node when compacting, relative to its degree
+constexpr static const double COMPACT_SLACK = 0.1;
+
+struct LNode {
+  PRTy value;
+  std::atomic<PRTy> residual;
+
+  void init() {
+    value    = 0.0;
+    residual = INIT_RESIDUAL;
+  }
+};
+
+typedef galois::graphs::DynamicCSRGraph<LNode, void> Graph;
+typedef typename Graph::GraphNode GNode;
+typedef typename Graph::EdgeUpdate Update;
+
+class IncrementalPageRank {
+  Graph& graph;
+  galois::GAccumulator<uint64_t> work;
+
+  //! adds delta to the residual of every out-neighbor of src
+  void spread(GNode src, PRTy delta, galois::InsertBag<GNode>& touched) {
+    for (auto e : graph.edges(src)) {
+      GNode dst = graph.getEdgeDst(e);
+      atomicAdd(graph.getData(dst).residual, delta);
+      touched.push(dst);
+    }
+    work += graph.getDegree(src);
+  }
+
+  //! gives or takes back the contribution of every source to its neighbors
+  void adjust(const std::vector<GNode>& sources, bool give,
+              galois::InsertBag<GNode>& touched) {
+    galois::do_all(
+        galois::iterate(sources),
+        [&](GNode src) {
+          size_t degree = graph.getDegree(src);
+          if (degree > 0) {
+            PRTy delta = graph.getData(src).value * ALPHA / degree;
+            spread(src, give ? delta : -delta, touched);
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("AdjustResiduals"));
+  }
+
+public:
+  explicit IncrementalPageRank(Graph& g) : graph(g) {}
+
+  template <typename R>
+  void push(const R& range) {
+    typedef galois::worklists::PerSocketChunkFIFO<CHUNK_SIZE> WL;
+    galois::for_each(
+        range,
+        [&](GNode src, auto& ctx) {
+          LNode& sdata = graph.getData(src);
+          if (std::fabs(sdata.residual) <= tolerance) {
+            return;
+          }
+          PRTy oldResidual = sdata.residual.exchange(0.0);
+          sdata.value += oldResidual;
+          size_t degree = graph.getDegree(src);
+          if (degree == 0) {
+            return;
+          }
+          PRTy delta = oldResidual * ALPHA / degree;
+          for (auto jj : graph.edges(src)) {
+            GNode dst = graph.getEdgeDst(jj);
+            auto old  = atomicAdd(graph.getData(dst).residual, delta);
+            if (std::fabs(old) <= tolerance &&
+                std::fabs(old + delta) > tolerance) {
+              ctx.push(dst);
+            }
+          }
+          work += degree;
+        },
+        galois::loopname("PushResidualIncremental"),
+        galois::disable_conflict_detection(), galois::no_stats(),
+        galois::wl<WL>());
+  }
+
+  //! page rank from scratch
+  void recompute() {
+    galois::do_all(
+        galois::iterate(graph), [&](GNode n) { graph.getData(n).init(); },
+        galois::no_stats());
+    push(galois::iterate(graph));
+  }
+
+  void applyBatch(std::vector<Update>& insertions,
+                  std::vector<Update>& deletions) {
+    std::vector<GNode> sources;
+    for (auto* list : {&insertions, &deletions}) {
+      for (auto& u : *list) {
+        sources.push_back(u.src);
+      }
+    }
+    galois::ParallelSTL::sort(sources.begin(), sources.end());
+    sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+    galois::InsertBag<GNode> touched;
+    adjust(sources, false, touched);
+    graph.deleteEdges(deletions);
+    graph.insertEdges(insertions);
+    adjust(sources, true, touched);
+
+    push(galois::iterate(touched));
+  }
+
+  //! edges visited since the last call
+  uint64_t takeWork() {
+    uint64_t w = work.reduce();
+    work.reset();
+    return w;
+  }
+};
+
+//! Compares the incremental ranks against a full recomputation
+void compareWithFull(Graph& graph, IncrementalPageRank& pr,
+                     uint64_t incrementalWork, uint64_t numApplied) {
+  galois::LargeArray<PRTy> incremental;
+  incremental.allocateBlocked(graph.size());
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) { incremental[n] = graph.getData(n).value; },
+      galois::no_stats());
+
+  pr.takeWork();
+  galois::StatTimer fullTime("TimerFullRecompute");
+  fullTime.start();
+  pr.recompute();
+  fullTime.stop();
+  uint64_t fullWork = pr.takeWork();
+
+  galois::GAccumulator<double> diff;
+  galois::GAccumulator<double> sum;
+  galois::GReduceMax<double> maxDiff;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        double d = std::fabs(graph.getData(n).value - incremental[n]);
+        diff += d;
+        sum += graph.getData(n).value;
+        maxDiff.update(d);
+        // keep the incremental ranks for printing
+        graph.getData(n).value = incremental[n];
+      },
+      galois::no_stats());
+
+  double perBatch = numApplied ? double(incrementalWork) / numApplied : 0.0;
+  std::cout << "Edges visited per batch: " << perBatch
+            << " incremental vs " << fullWork << " for a full recompute ("
+            << (fullWork ? perBatch / fullWork : 0.0) << ")\n";
+  std::cout << "Difference from full recompute: max " << maxDiff.reduce()
+            << ", relative L1 " << diff.reduce() / sum.reduce() << "\n";
+  galois::runtime::reportStat_Single("IncrementalPageRank", "FullEdgeWork",
+                                     fullWork);
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  Graph graph;
+  galois::graphs::readGraph(graph, inputFile);
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges\n";
+
+  galois::preAlloc(5 * numThreads +
+                   (5 * graph.size() * sizeof(typename Graph::node_data_type)) /
+                       galois::runtime::pagePoolSize());
+  galois::reportPageAlloc("MeminfoPre");
+
+  std::cout << "tolerance:" << tolerance << "\n";
+
+  IncrementalPageRank pr(graph);
+  galois::StatTimer initTime("TimerInitial");
+  initTime.start();
+  pr.recompute();
+  initTime.stop();
+  pr.takeWork();
+
+  EdgeUpdateSource<Graph> source(updatesFile, batchSize, numBatches,
+                                 deleteRatio, seed);
+  EdgeUpdateSource<Graph>::Batch batch;
+  uint64_t numApplied     = 0;
+  uint64_t numUpdates     = 0;
+  unsigned numCompactions = 0;
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  while (source.next(graph, batch)) {
+    numUpdates += batch.size();
+    pr.applyBatch(batch.insertions, batch.deletions);
+    numApplied += 1;
+    if (graph.compactIfNeeded(compactThreshold, COMPACT_SLACK)) {
+      numCompactions += 1;
+    }
+  }
+  execTime.stop();
+  uint64_t totalWork = pr.takeWork();
+
+  galois::reportPageAlloc("MeminfoPost");
+
+  std::cout << "Applied " << numApplied << " batches (" << numUpdates
+            << " updates), graph now has " << graph.sizeEdges() << " edges\n";
+  galois::runtime::reportStat_Single("IncrementalPageRank", "Batches",
+                                     numApplied);
+  galois::runtime::reportStat_Single("IncrementalPageRank", "EdgeWork",
+                                     totalWork);
+  galois::runtime::reportStat_Single("IncrementalPageRank", "Compactions",
+                                     numCompactions);
+
+  if (!skipVerify) {
+    compareWithFull(graph, pr, totalWork, numApplied);
+    printTop(graph);
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
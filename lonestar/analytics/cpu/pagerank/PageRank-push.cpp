@@ -199,9 +199,7 @@ int main(int argc, char** argv) {
   std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
             << " edges\n";
 
-  galois::preAlloc(5 * numThreads +
-                   (5 * graph.size() * sizeof(typename Graph::node_data_type)) /
-                       galois::runtime::pagePoolSize());
+  galois::preAllocFor<typename Graph::node_data_type>(graph, 5);
   galois::reportPageAlloc("MeminfoPre");
 
   std::cout << "tolerance:" << tolerance << ", maxIterations:" << maxIterations
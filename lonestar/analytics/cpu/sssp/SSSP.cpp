@@ -54,6 +54,17 @@ static cll::opt<unsigned int>
     stepShift("delta",
               cll::desc("Shift value for the deltastep (default value 13)"),
               cll::init(13));
+static cll::opt<std::string>
+    sourcesFile("sourcesFile",
+                cll::desc("File of whitespace separated sources; runs a "
+                          "batched multi-source SSSP from every source "
+                          "instead of a single search from startNode"),
+                cll::init(""));
+static cll::opt<unsigned int>
+    batchSize("batchSize",
+              cll::desc("Number of sources searched concurrently in "
+                        "sourcesFile mode (default value 16, maximum 64)"),
+              cll::init(16));
 
 enum Algo {
   deltaTile = 0,
@@ -107,6 +118,7 @@ using SrcEdgeTilePushWrap  = SSSP::SrcEdgeTilePushWrap;
 using ReqPushWrap          = SSSP::ReqPushWrap;
 using OutEdgeRangeFn       = SSSP::OutEdgeRangeFn;
 using TileRangeFn          = SSSP::TileRangeFn;
+using MultiSourceSSSP      = MultiSourceBFS_SSSP<Graph, uint32_t, true>;
 
 namespace gwl = galois::worklists;
 using PSchunk = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
@@ -352,6 +364,57 @@ void topoTileAlgo(Graph& graph, const GNode& source) {
   galois::runtime::reportStat_Single("SSSP-topo", "rounds", rounds);
 }
 
+//! Runs SSSP from every source in sourcesFile, batchSize sources at a time
+void runMultiSource(Graph& graph) {
+  std::vector<GNode> sources =
+      readNodesFile<GNode>(sourcesFile, graph.size());
+  if (batchSize == 0 || batchSize > MultiSourceSSSP::MAX_LANES) {
+    GALOIS_DIE("batchSize must be in [1, ", MultiSourceSSSP::MAX_LANES, "]");
+  }
+  galois::gInfo("Running multi-source SSSP from ", sources.size(),
+                " sources in batches of ", batchSize);
+
+  MultiSourceSSSP engine(graph, batchSize);
+
+  galois::GReduceMax<uint64_t> maxDistance;
+  galois::GAccumulator<uint64_t> visitedPairs;
+  galois::StatTimer execTime("Timer_0");
+
+  for (size_t b = 0; b < sources.size(); b += batchSize) {
+    std::vector<GNode> batch(
+        sources.begin() + b,
+        sources.begin() + std::min(sources.size(), b + batchSize));
+
+    execTime.start();
+    engine.sssp(batch);
+    execTime.stop();
+
+    const unsigned numLanes = batch.size();
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          for (unsigned lane = 0; lane < numLanes; ++lane) {
+            Dist d = engine.dist(n, lane);
+            if (d != MultiSourceSSSP::DIST_INFINITY) {
+              maxDistance.update(d);
+              visitedPairs += 1;
+            }
+          }
+        },
+        galois::loopname("Sanity check"), galois::no_stats());
+
+    if (!skipVerify && !engine.verify(batch)) {
+      GALOIS_DIE("verification failed");
+    }
+  }
+
+  galois::gInfo("# visited (source, node) pairs is ", visitedPairs.reduce());
+  galois::gInfo("Max distance is ", maxDistance.reduce());
+  if (!skipVerify) {
+    std::cout << "Verification successful.\n";
+  }
+}
+
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   LonestarStart(argc, argv, name, desc, url, &inputFile);
@@ -368,6 +431,12 @@ int main(int argc, char** argv) {
   std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
             << " edges\n";
 
+  if (!sourcesFile.empty()) {
+    runMultiSource(graph);
+    totalTime.stop();
+    return 0;
+  }
+
   if (startNode >= graph.size() || reportNode >= graph.size()) {
     std::cerr << "failed to set report: " << reportNode
               << " or failed to set source: " << startNode << "\n";
@@ -382,9 +451,8 @@ int main(int argc, char** argv) {
   std::advance(it, reportNode.getValue());
   report = *it;
 
-  size_t approxNodeData = graph.size() * 64;
-  galois::preAlloc(numThreads +
-                   approxNodeData / galois::runtime::pagePoolSize());
+  // a node can be queued several times with decreasing distances
+  galois::preAllocFor<UpdateRequest>(graph, 8);
   galois::reportPageAlloc("MeminfoPre");
 
   if (algo == deltaStep || algo == deltaTile || algo == serDelta ||
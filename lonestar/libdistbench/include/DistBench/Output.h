@@ -1,15 +1,88 @@
 #ifndef GALOIS_DISTBENCH_OUTPUT_H
 #define GALOIS_DISTBENCH_OUTPUT_H
 
+#include <cstdint>
 #include <string>
 #include <fstream>
+#include <type_traits>
 #include "galois/gIO.h"
+#include "llvm/Support/CommandLine.h"
+
+//! How writeOutput stores the values of master nodes
+enum OutputFormat {
+  //! one text file per host with a "GID value" line per node
+  textOutput,
+  //! one binary file per host with the GIDs sorted and their values
+  binaryOutput,
+  //! one binary file shared by all hosts with the values indexed by GID
+  sharedBinaryOutput
+};
+
+//! Format used by writeOutput; set with -outputFormat
+extern llvm::cl::opt<OutputFormat> outputFormat;
+
+/**
+ * Binary output files start with this header. Data files have magic
+ * "GALOISBO"; the index file "<field>.index" that comes with every binary
+ * output has magic "GALOISBI" and numEntries set to the number of hosts,
+ * and is followed by one BinaryOutputIndexEntry per host.
+ *
+ * binaryOutput writes "<field>-<host>.bin" on each host: numEntries GIDs as
+ * sorted uint64_t at gidOffset and their values at valueOffset.
+ * sharedBinaryOutput writes "<field>.bin": numEntries (the largest GID plus
+ * one) values at valueOffset, which is page aligned, so the value of a node
+ * is at valueOffset + GID * elemSize. Nodes no host wrote are zero.
+ */
+struct BinaryOutputHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t format;   //!< OutputFormat used
+  uint64_t elemSize; //!< bytes per value
+  char type[8];      //!< numpy-style value type, e.g., "<f4"
+  uint64_t numEntries;
+  uint64_t gidOffset;   //!< byte offset of GIDs; 0 if values are dense
+  uint64_t valueOffset; //!< byte offset of values
+  uint64_t reserved;
+};
+static_assert(sizeof(BinaryOutputHeader) == 64, "header layout changed");
+
+//! What one host wrote
+struct BinaryOutputIndexEntry {
+  uint64_t numEntries;
+  uint64_t minGID; //!< larger than maxGID if the host wrote nothing
+  uint64_t maxGID;
+  uint64_t reserved;
+};
 
 std::string makeOutputFilename(const std::string& outputDir);
 
+//! Writes length values of elemSize bytes in one of the binary formats
+void writeBinaryOutput(const std::string& outputDir,
+                       const std::string& fieldName, const std::string& type,
+                       size_t elemSize, const void* values, size_t length,
+                       const uint64_t* IDs, OutputFormat format);
+
+//! numpy-style type string of T, stored in binary output headers
 template <typename T>
-void writeOutput(const std::string& outputDir, const std::string& /*fieldName*/,
+std::string binaryTypeName() {
+  static_assert(std::is_arithmetic<T>::value,
+                "binary output supports arithmetic values only");
+  char kind = std::is_same<T, bool>::value       ? 'b'
+              : std::is_floating_point<T>::value ? 'f'
+              : std::is_signed<T>::value         ? 'i'
+                                                 : 'u';
+  return std::string("<") + kind + std::to_string(sizeof(T));
+}
+
+template <typename T>
+void writeOutput(const std::string& outputDir, const std::string& fieldName,
                  T* values, size_t length, uint64_t* IDs) {
+  if (outputFormat != textOutput) {
+    writeBinaryOutput(outputDir, fieldName, binaryTypeName<T>(), sizeof(T),
+                      values, length, IDs, outputFormat);
+    return;
+  }
+
   std::string filename = makeOutputFilename(outputDir);
 
   std::ofstream outputFile(filename.c_str());
@@ -1,7 +1,16 @@
 #include "DistBench/Output.h"
+#include "galois/DReducible.h"
+#include "galois/Galois.h"
 #include "galois/runtime/Network.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
+#include <numeric>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace {
 std::string zeroPad(int num, int width) {
@@ -12,17 +21,217 @@ std::string zeroPad(int num, int width) {
   return out.str();
 }
 
-} // namespace
-
-std::string makeOutputFilename(const std::string& outputDir) {
-  std::string filename = zeroPad(galois::runtime::getHostID(), 8);
-
+std::string inOutputDir(const std::string& outputDir,
+                        const std::string& filename) {
   std::string output{outputDir};
   if (output.empty() || output.compare(output.size() - 1, 1, "/") == 0) {
     output += filename;
   } else {
     output += "/" + filename;
   }
-
   return output;
 }
+
+//! values of a dense file start on a page boundary so they can be mmap'd
+constexpr uint64_t DENSE_VALUE_OFFSET = 4096;
+//! bytes written by one pwrite call
+constexpr size_t WRITE_BLOCK_SIZE = 4 << 20;
+
+void writeFully(int fd, const void* buf, size_t size, uint64_t offset,
+                const std::string& filename) {
+  const char* p = static_cast<const char*>(buf);
+  while (size > 0) {
+    ssize_t written = pwrite(fd, p, size, offset);
+    if (written < 0) {
+      GALOIS_SYS_DIE("failed writing to ", filename);
+    }
+    p += written;
+    size -= written;
+    offset += written;
+  }
+}
+
+int openOutput(const std::string& filename, bool create) {
+  int fd = open(filename.c_str(), create ? O_WRONLY | O_CREAT | O_TRUNC
+                                         : O_WRONLY,
+                0644);
+  if (fd < 0) {
+    GALOIS_SYS_DIE("failed opening ", filename);
+  }
+  return fd;
+}
+
+void closeOutput(int fd, const std::string& filename) {
+  if (close(fd) != 0) {
+    GALOIS_SYS_DIE("failed closing ", filename);
+  }
+}
+
+BinaryOutputHeader makeHeader(const char* magic, OutputFormat format,
+                              const std::string& type, size_t elemSize) {
+  BinaryOutputHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, magic, sizeof(header.magic));
+  header.version  = 1;
+  header.format   = format;
+  header.elemSize = elemSize;
+  std::strncpy(header.type, type.c_str(), sizeof(header.type) - 1);
+  return header;
+}
+
+/**
+ * GIDs and values of the masters of this host sorted by GID. Partitions
+ * usually give masters in GID order, in which case nothing is copied.
+ */
+struct SortedValues {
+  std::vector<uint64_t> gidStore;
+  std::vector<char> valueStore;
+  const uint64_t* gids;
+  const char* values;
+
+  SortedValues(const void* _values, size_t elemSize, size_t length,
+               const uint64_t* IDs)
+      : gids(IDs), values(static_cast<const char*>(_values)) {
+    if (std::is_sorted(IDs, IDs + length)) {
+      return;
+    }
+
+    std::vector<size_t> order(length);
+    std::iota(order.begin(), order.end(), 0);
+    galois::ParallelSTL::sort(order.begin(), order.end(),
+                              [&](size_t a, size_t b) {
+                                return IDs[a] < IDs[b];
+                              });
+
+    gidStore.resize(length);
+    valueStore.resize(length * elemSize);
+    galois::do_all(
+        galois::iterate(size_t{0}, length),
+        [&](size_t i) {
+          gidStore[i] = IDs[order[i]];
+          std::memcpy(&valueStore[i * elemSize], values + order[i] * elemSize,
+                      elemSize);
+        },
+        galois::no_stats());
+    gids   = gidStore.data();
+    values = valueStore.data();
+  }
+};
+
+/**
+ * Calls fn(begin, end) in parallel for consecutive ranges of entries that
+ * hold about WRITE_BLOCK_SIZE bytes of values each.
+ */
+template <typename F>
+void forEachWriteBlock(size_t length, size_t elemSize, const F& fn) {
+  size_t perBlock  = std::max<size_t>(1, WRITE_BLOCK_SIZE / elemSize);
+  size_t numBlocks = (length + perBlock - 1) / perBlock;
+  galois::do_all(
+      galois::iterate(size_t{0}, numBlocks),
+      [&](size_t b) {
+        fn(b * perBlock, std::min(length, (b + 1) * perBlock));
+      },
+      galois::no_stats());
+}
+
+} // namespace
+
+std::string makeOutputFilename(const std::string& outputDir) {
+  return inOutputDir(outputDir, zeroPad(galois::runtime::getHostID(), 8));
+}
+
+void writeBinaryOutput(const std::string& outputDir,
+                       const std::string& fieldName, const std::string& type,
+                       size_t elemSize, const void* values, size_t length,
+                       const uint64_t* IDs, OutputFormat format) {
+  const uint32_t hostID   = galois::runtime::getHostID();
+  const uint32_t numHosts = galois::runtime::getSystemNetworkInterface().Num;
+  const bool dense        = format == sharedBinaryOutput;
+
+  SortedValues sorted(values, elemSize, length, IDs);
+
+  galois::DGReduceMax<uint64_t> maxGID;
+  maxGID.update(length ? sorted.gids[length - 1] + 1 : 0);
+  const uint64_t numGlobal = maxGID.reduce();
+
+  std::string indexFile = inOutputDir(outputDir, fieldName + ".index");
+  std::string dataFile  = inOutputDir(
+      outputDir, dense ? fieldName + ".bin"
+                        : fieldName + "-" + zeroPad(hostID, 8) + ".bin");
+
+  // host 0 creates the shared files before anyone writes to them
+  if (hostID == 0) {
+    BinaryOutputHeader index =
+        makeHeader("GALOISBI", format, type, elemSize);
+    index.numEntries  = numHosts;
+    index.valueOffset = sizeof(BinaryOutputHeader);
+    int fd            = openOutput(indexFile, true);
+    writeFully(fd, &index, sizeof(index), 0, indexFile);
+    closeOutput(fd, indexFile);
+
+    if (dense) {
+      BinaryOutputHeader header =
+          makeHeader("GALOISBO", format, type, elemSize);
+      header.numEntries  = numGlobal;
+      header.valueOffset = DENSE_VALUE_OFFSET;
+      fd                 = openOutput(dataFile, true);
+      if (ftruncate(fd, DENSE_VALUE_OFFSET + numGlobal * elemSize) != 0) {
+        GALOIS_SYS_DIE("failed resizing ", dataFile);
+      }
+      writeFully(fd, &header, sizeof(header), 0, dataFile);
+      closeOutput(fd, dataFile);
+    }
+  }
+  galois::runtime::getHostBarrier().wait();
+
+  BinaryOutputIndexEntry entry;
+  std::memset(&entry, 0, sizeof(entry));
+  entry.numEntries = length;
+  entry.minGID     = length ? sorted.gids[0] : 1;
+  entry.maxGID     = length ? sorted.gids[length - 1] : 0;
+  int indexFd      = openOutput(indexFile, false);
+  writeFully(indexFd, &entry, sizeof(entry),
+             sizeof(BinaryOutputHeader) + hostID * sizeof(entry), indexFile);
+  closeOutput(indexFd, indexFile);
+
+  int fd = openOutput(dataFile, !dense);
+  if (dense) {
+    // one pwrite per run of consecutive GIDs in a block
+    forEachWriteBlock(length, elemSize, [&](size_t begin, size_t end) {
+      while (begin < end) {
+        size_t run = begin + 1;
+        while (run < end && sorted.gids[run] == sorted.gids[run - 1] + 1) {
+          ++run;
+        }
+        writeFully(fd, sorted.values + begin * elemSize,
+                   (run - begin) * elemSize,
+                   DENSE_VALUE_OFFSET + sorted.gids[begin] * elemSize,
+                   dataFile);
+        begin = run;
+      }
+    });
+  } else {
+    BinaryOutputHeader header = makeHeader("GALOISBO", format, type, elemSize);
+    header.numEntries         = length;
+    header.gidOffset          = sizeof(BinaryOutputHeader);
+    header.valueOffset        = header.gidOffset + length * sizeof(uint64_t);
+    writeFully(fd, &header, sizeof(header), 0, dataFile);
+    forEachWriteBlock(length, elemSize, [&](size_t begin, size_t end) {
+      writeFully(fd, sorted.gids + begin, (end - begin) * sizeof(uint64_t),
+                 header.gidOffset + begin * sizeof(uint64_t), dataFile);
+      writeFully(fd, sorted.values + begin * elemSize,
+                 (end - begin) * elemSize,
+                 header.valueOffset + begin * elemSize, dataFile);
+    });
+  }
+  closeOutput(fd, dataFile);
+
+  galois::runtime::getHostBarrier().wait();
+
+  if (hostID == 0) {
+    galois::gPrint("Output written to: ", dataFile, " (index ", indexFile,
+                   ")\n");
+  } else if (!dense) {
+    galois::gPrint("Output written to: ", dataFile, "\n");
+  }
+}
@@ -18,6 +18,7 @@
  */
 
 #include "DistBench/Start.h"
+#include "DistBench/Output.h"
 #include "galois/Version.h"
 #include "galois/runtime/Network.h"
 #include "galois/runtime/DistStats.h"
@@ -61,6 +62,17 @@ cll::opt<std::string> outputLocation(
 cll::opt<bool> output("output", cll::desc("Write result (default false)"),
                       cll::init(false));
 
+cll::opt<OutputFormat> outputFormat(
+    "outputFormat", cll::desc("Format of the result when output is true:"),
+    cll::values(clEnumValN(textOutput, "text",
+                           "One text file per host (default)"),
+                clEnumValN(binaryOutput, "binary",
+                           "One binary file per host, sorted by GID"),
+                clEnumValN(sharedBinaryOutput, "sharedBinary",
+                           "One binary file indexed by GID, written by all "
+                           "hosts")),
+    cll::init(textOutput));
+
 #ifdef GALOIS_ENABLE_GPU
 std::string personality_str(Personality p) {
   switch (p) {
@@ -19,8 +19,15 @@
 
 #ifndef LONESTAR_BFS_SSSP_H
 #define LONESTAR_BFS_SSSP_H
+#include "galois/AtomicHelpers.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
+
+#include <atomic>
+#include <deque>
 #include <iostream>
 #include <cstdlib>
+#include <vector>
 
 template <typename Graph, typename _DistLabel, bool USE_EDGE_WT,
           ptrdiff_t EDGE_TILE_SIZE = 256>
@@ -263,6 +270,327 @@ struct BFS_SSSP {
   }
 };
 
+/**
+ * Batched multi-source BFS/SSSP engine.
+ *
+ * BFS runs up to 64 traversals at once in the style of MS-BFS: every node
+ * carries a 64-bit lane mask for "seen", "in current frontier" and "in next
+ * frontier", so one sweep over an edge advances every traversal that reached
+ * its source.  SSSP runs up to 64 Bellman-Ford instances in lock step over a
+ * node-major distance array (all lanes of a node are adjacent in memory) and
+ * only relaxes the lanes whose distance changed in the previous round.
+ *
+ * Lane i of a batch corresponds to the i-th source passed in.
+ */
+template <typename Graph, typename _DistLabel, bool USE_EDGE_WT>
+class MultiSourceBFS_SSSP {
+public:
+  using Dist     = _DistLabel;
+  using GNode    = typename Graph::GraphNode;
+  using LaneMask = uint64_t;
+  using Frontier = galois::InsertBag<GNode>;
+
+  constexpr static const unsigned MAX_LANES = 64;
+  constexpr static const Dist DIST_INFINITY =
+      BFS_SSSP<Graph, Dist, USE_EDGE_WT>::DIST_INFINITY;
+
+private:
+  constexpr static const unsigned CHUNK_SIZE = 64U;
+
+  Graph& graph;
+  unsigned numLanes;
+
+  galois::LargeArray<std::atomic<LaneMask>> seen;
+  galois::LargeArray<std::atomic<LaneMask>> visit;
+  galois::LargeArray<std::atomic<LaneMask>> visitNext;
+  //! node-major distances; allocated on first use by bfs()/sssp()
+  galois::LargeArray<std::atomic<Dist>> dists;
+  //! frontiers of the last batch, one bag per level; kept only on request
+  std::deque<Frontier> levels;
+
+  template <bool useWt, typename EI>
+  Dist getEdgeWeight(EI, typename std::enable_if<!useWt>::type* = nullptr) {
+    return 1;
+  }
+
+  template <bool useWt, typename EI>
+  Dist getEdgeWeight(EI ii, typename std::enable_if<useWt>::type* = nullptr) {
+    return graph.getEdgeData(ii, galois::MethodFlag::UNPROTECTED);
+  }
+
+  //! Calls f(lane) for every set bit of mask
+  template <typename F>
+  static void forEachLane(LaneMask mask, const F& f) {
+    while (mask) {
+      f(static_cast<unsigned>(__builtin_ctzll(mask)));
+      mask &= mask - 1;
+    }
+  }
+
+  void resetMasks() {
+    galois::do_all(
+        galois::iterate(size_t{0}, graph.size()),
+        [&](size_t n) {
+          seen[n].store(0, std::memory_order_relaxed);
+          visit[n].store(0, std::memory_order_relaxed);
+          visitNext[n].store(0, std::memory_order_relaxed);
+        },
+        galois::no_stats(), galois::loopname("MultiSourceReset"));
+  }
+
+  void resetDists() {
+    if (dists.size() == 0) {
+      dists.create(graph.size() * size_t{numLanes}, DIST_INFINITY);
+      return;
+    }
+    galois::do_all(
+        galois::iterate(size_t{0}, dists.size()),
+        [&](size_t i) { dists[i].store(DIST_INFINITY, std::memory_order_relaxed); },
+        galois::no_stats(), galois::loopname("MultiSourceResetDist"));
+  }
+
+  //! Seeds the frontier with the sources; lane i starts at sources[i]
+  void seedSources(const std::vector<GNode>& sources, Frontier& frontier) {
+    GALOIS_ASSERT(sources.size() <= numLanes,
+                  "batch larger than the number of lanes");
+    for (unsigned i = 0; i < sources.size(); ++i) {
+      GNode s = sources[i];
+      if (visit[s].fetch_or(LaneMask{1} << i) == 0) {
+        frontier.push(s);
+      }
+    }
+  }
+
+public:
+  /**
+   * @param g graph to traverse; must stay alive as long as the engine
+   * @param lanes number of concurrent traversals per batch (<= 64)
+   */
+  explicit MultiSourceBFS_SSSP(Graph& g, unsigned lanes = MAX_LANES)
+      : graph(g), numLanes(lanes) {
+    GALOIS_ASSERT(lanes > 0 && lanes <= MAX_LANES,
+                  "number of lanes must be in [1, 64]");
+    seen.create(graph.size(), LaneMask{0});
+    visit.create(graph.size(), LaneMask{0});
+    visitNext.create(graph.size(), LaneMask{0});
+  }
+
+  unsigned getNumLanes() const { return numLanes; }
+
+  //! Distance of node n from the source of lane; valid after bfs()/sssp()
+  Dist dist(GNode n, unsigned lane) const {
+    return dists[size_t{n} * numLanes + lane].load(std::memory_order_relaxed);
+  }
+
+  //! Frontier of each level of the last bfsBatch() run with keepLevels
+  std::deque<Frontier>& getLevels() { return levels; }
+
+  /**
+   * Generic bitmask BFS from up to getNumLanes() sources.
+   *
+   * edgeFn(src, dst, lanes, level) is called (in parallel) for every edge
+   * over which the traversals in mask lanes discover dst at level; it may be
+   * called several times for the same dst and level from different srcs.
+   * levelFn(node, lanes, level) is called exactly once per node and level
+   * with the set of traversals that reached node for the first time,
+   * including level 0 for the sources.
+   *
+   * @returns number of non-empty levels
+   */
+  template <typename EdgeFn, typename LevelFn>
+  unsigned bfsBatch(const std::vector<GNode>& sources, const EdgeFn& edgeFn,
+                    const LevelFn& levelFn, bool keepLevels = false) {
+    resetMasks();
+    levels.clear();
+
+    auto curr = std::make_unique<Frontier>();
+    auto next = std::make_unique<Frontier>();
+
+    seedSources(sources, *curr);
+    for (GNode s : *curr) {
+      LaneMask m = visit[s].load(std::memory_order_relaxed);
+      seen[s].store(m, std::memory_order_relaxed);
+      levelFn(s, m, 0U);
+    }
+
+    unsigned level = 0;
+    while (!curr->empty()) {
+      ++level;
+
+      galois::do_all(
+          galois::iterate(*curr),
+          [&](GNode src) {
+            LaneMask front = visit[src].exchange(0, std::memory_order_relaxed);
+            for (auto e : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
+              GNode dst = graph.getEdgeDst(e);
+              // seen is only updated between levels, so this is exactly the
+              // set of traversals that have not reached dst yet
+              LaneMask discovered =
+                  front & ~seen[dst].load(std::memory_order_relaxed);
+              if (!discovered) {
+                continue;
+              }
+              edgeFn(src, dst, discovered, level);
+              if ((visitNext[dst].load(std::memory_order_relaxed) &
+                   discovered) != discovered &&
+                  visitNext[dst].fetch_or(discovered,
+                                          std::memory_order_relaxed) == 0) {
+                next->push(dst);
+              }
+            }
+          },
+          galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+          galois::loopname("MultiSourceBFS"));
+
+      galois::do_all(
+          galois::iterate(*next),
+          [&](GNode n) {
+            LaneMask m = visitNext[n].exchange(0, std::memory_order_relaxed);
+            seen[n].fetch_or(m, std::memory_order_relaxed);
+            visit[n].store(m, std::memory_order_relaxed);
+            levelFn(n, m, level);
+          },
+          galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+          galois::loopname("MultiSourceBFSCommit"));
+
+      if (keepLevels) {
+        levels.emplace_back(std::move(*curr));
+      } else {
+        curr->clear();
+      }
+      std::swap(curr, next);
+    }
+
+    return level;
+  }
+
+  /**
+   * BFS from each source; hop counts are available through dist().
+   *
+   * @returns number of non-empty levels
+   */
+  unsigned bfs(const std::vector<GNode>& sources) {
+    resetDists();
+    const unsigned lanes = numLanes;
+    return bfsBatch(
+        sources, [](GNode, GNode, LaneMask, unsigned) {},
+        [&](GNode n, LaneMask m, unsigned level) {
+          forEachLane(m, [&](unsigned lane) {
+            dists[size_t{n} * lanes + lane].store(level,
+                                                   std::memory_order_relaxed);
+          });
+        });
+  }
+
+  /**
+   * Shortest paths from each source using lock-step Bellman-Ford; distances
+   * are available through dist().
+   *
+   * @returns number of rounds
+   */
+  unsigned sssp(const std::vector<GNode>& sources) {
+    resetMasks();
+    resetDists();
+
+    auto curr = std::make_unique<Frontier>();
+    auto next = std::make_unique<Frontier>();
+
+    seedSources(sources, *curr);
+    for (unsigned i = 0; i < sources.size(); ++i) {
+      dists[size_t{sources[i]} * numLanes + i].store(0);
+    }
+
+    const size_t lanes = numLanes;
+    unsigned rounds    = 0;
+    while (!curr->empty()) {
+      ++rounds;
+
+      galois::do_all(
+          galois::iterate(*curr),
+          [&](GNode src) {
+            LaneMask active = visit[src].exchange(0, std::memory_order_relaxed);
+            const size_t srcBase = size_t{src} * lanes;
+
+            for (auto e : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
+              GNode dst            = graph.getEdgeDst(e);
+              const Dist w         = getEdgeWeight<USE_EDGE_WT>(e);
+              const size_t dstBase = size_t{dst} * lanes;
+              LaneMask improved    = 0;
+
+              forEachLane(active, [&](unsigned lane) {
+                Dist nd = dists[srcBase + lane].load(std::memory_order_relaxed) + w;
+                if (nd < dists[dstBase + lane].load(std::memory_order_relaxed) &&
+                    galois::atomicMin(dists[dstBase + lane], nd) > nd) {
+                  improved |= LaneMask{1} << lane;
+                }
+              });
+
+              if (improved &&
+                  visitNext[dst].fetch_or(improved, std::memory_order_relaxed) ==
+                      0) {
+                next->push(dst);
+              }
+            }
+          },
+          galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+          galois::loopname("MultiSourceSSSP"));
+
+      galois::do_all(
+          galois::iterate(*next),
+          [&](GNode n) {
+            visit[n].fetch_or(visitNext[n].exchange(0, std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+          },
+          galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+          galois::loopname("MultiSourceSSSPCommit"));
+
+      curr->clear();
+      std::swap(curr, next);
+    }
+
+    return rounds;
+  }
+
+  /**
+   * Checks that the distances of every lane are a fixed point of edge
+   * relaxation and that every source has distance 0.
+   */
+  bool verify(const std::vector<GNode>& sources) {
+    for (unsigned i = 0; i < sources.size(); ++i) {
+      if (dist(sources[i], i) != 0) {
+        std::cerr << "ERROR: source " << sources[i] << " of lane " << i
+                  << " has non-zero dist value == " << dist(sources[i], i)
+                  << std::endl;
+        return false;
+      }
+    }
+
+    const unsigned numSources = sources.size();
+    std::atomic<bool> notConsistent(false);
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode src) {
+          for (auto e : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
+            GNode dst = graph.getEdgeDst(e);
+            Dist w    = getEdgeWeight<USE_EDGE_WT>(e);
+            for (unsigned lane = 0; lane < numSources; ++lane) {
+              Dist sd = dist(src, lane);
+              if (sd != DIST_INFINITY && dist(dst, lane) > sd + w) {
+                notConsistent = true;
+              }
+            }
+          }
+        },
+        galois::no_stats(), galois::loopname("MultiSourceVerify"));
+
+    if (notConsistent) {
+      std::cerr << "node found with incorrect distance\n";
+      return false;
+    }
+    return true;
+  }
+};
+
 template <typename T, typename BucketFunc, size_t MAX_BUCKETS = 543210ul>
 class SerialBucketWL {
 
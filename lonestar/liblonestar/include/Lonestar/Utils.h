@@ -4,6 +4,13 @@
 #include <random>
 #include <vector>
 #include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "galois/gIO.h"
 
 //! Used to pick random non-zero degree starting points for search algorithms
 //! This code has been copied from GAP benchmark suite
@@ -55,3 +62,153 @@ bool isApproximateDegreeDistributionPowerLaw(const Graph& graph) {
   double sample_median  = samples[num_samples / 2];
   return sample_average / 1.25 > sample_median;
 }
+
+//! Reads a whitespace separated list of node ids (e.g., search sources) from
+//! a file; dies if the file cannot be read, a token is not a node id or an id
+//! is out of range
+template <typename GNode>
+std::vector<GNode> readNodesFile(const std::string& filename,
+                                 size_t numNodes) {
+  std::ifstream file(filename);
+  if (!file) {
+    GALOIS_DIE("failed to open ", filename);
+  }
+  std::vector<GNode> nodes;
+  std::string line;
+  for (size_t lineNo = 1; std::getline(file, line); ++lineNo) {
+    std::istringstream tokens(line);
+    std::string token;
+    while (tokens >> token) {
+      size_t end = 0;
+      uint64_t n = 0;
+      try {
+        if (token[0] != '-') {
+          n = std::stoull(token, &end);
+        }
+      } catch (const std::logic_error&) {
+        end = 0;
+      }
+      if (end == 0 || end != token.size()) {
+        GALOIS_DIE("bad node id '", token, "' at ", filename, ":", lineNo);
+      }
+      if (n >= numNodes) {
+        GALOIS_DIE("node ", n, " at ", filename, ":", lineNo,
+                   " is out of range");
+      }
+      nodes.push_back(n);
+    }
+  }
+  if (nodes.empty()) {
+    GALOIS_DIE("no nodes in ", filename);
+  }
+  return nodes;
+}
+
+/**
+ * Produces batches of edge insertions and deletions for graphs with an
+ * insertEdges/deleteEdges interface (e.g., DynamicCSRGraph).
+ *
+ * Batches come either from a file with one update per line ("a src dst" to
+ * add an edge, "d src dst" to delete one; blank lines and lines starting with
+ * '#' are skipped) or, if no file is given, are generated at random: deletions
+ * pick a random out-edge of a random node of the current graph and insertions
+ * connect two random nodes.
+ */
+template <typename Graph>
+class EdgeUpdateSource {
+public:
+  using GNode  = typename Graph::GraphNode;
+  using Update = typename Graph::EdgeUpdate;
+
+  struct Batch {
+    std::vector<Update> insertions;
+    std::vector<Update> deletions;
+
+    size_t size() const { return insertions.size() + deletions.size(); }
+  };
+
+private:
+  std::ifstream file;
+  std::string filename;
+  size_t batchSize;
+  size_t batchesLeft;
+  double deleteRatio;
+  std::mt19937 rng;
+
+  static Update makeUpdate(GNode src, GNode dst) {
+    Update u{};
+    u.src = src;
+    u.dst = dst;
+    return u;
+  }
+
+  bool readBatch(const Graph& graph, Batch& batch) {
+    std::string line;
+    while (batch.size() < batchSize && std::getline(file, line)) {
+      std::istringstream ss(line);
+      char op;
+      uint64_t src, dst;
+      if (!(ss >> op) || op == '#') {
+        continue;
+      }
+      if (!(ss >> src >> dst) || (op != 'a' && op != 'd')) {
+        GALOIS_DIE("bad update '", line, "' in ", filename);
+      }
+      if (src >= graph.size() || dst >= graph.size()) {
+        GALOIS_DIE("update '", line, "' in ", filename, " is out of range");
+      }
+      auto& list = op == 'a' ? batch.insertions : batch.deletions;
+      list.push_back(makeUpdate(src, dst));
+    }
+    return batch.size() > 0;
+  }
+
+  void generateBatch(Graph& graph, Batch& batch) {
+    std::uniform_int_distribution<GNode> node(0, graph.size() - 1);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    for (size_t i = 0; i < batchSize; ++i) {
+      GNode src = node(rng);
+      if (coin(rng) < deleteRatio && graph.getDegree(src) > 0) {
+        std::uniform_int_distribution<size_t> pick(0,
+                                                   graph.getDegree(src) - 1);
+        auto e = graph.edge_begin(src);
+        std::advance(e, pick(rng));
+        batch.deletions.push_back(makeUpdate(src, graph.getEdgeDst(e)));
+      } else {
+        batch.insertions.push_back(makeUpdate(src, node(rng)));
+      }
+    }
+  }
+
+public:
+  //! @param numBatches number of random batches; ignored if reading a file
+  EdgeUpdateSource(const std::string& _filename, size_t _batchSize,
+                   size_t numBatches, double _deleteRatio, unsigned seed)
+      : filename(_filename), batchSize(_batchSize), batchesLeft(numBatches),
+        deleteRatio(_deleteRatio), rng(seed) {
+    if (batchSize == 0) {
+      GALOIS_DIE("batch size must be positive");
+    }
+    if (!filename.empty()) {
+      file.open(filename);
+      if (!file) {
+        GALOIS_DIE("failed to open ", filename);
+      }
+    }
+  }
+
+  //! Fills batch with the next updates; returns false once there are none
+  bool next(Graph& graph, Batch& batch) {
+    batch.insertions.clear();
+    batch.deletions.clear();
+    if (!filename.empty()) {
+      return readBatch(graph, batch);
+    }
+    if (batchesLeft == 0 || graph.size() == 0) {
+      return false;
+    }
+    --batchesLeft;
+    generateBatch(graph, batch);
+    return true;
+  }
+};
@@ -20,6 +20,8 @@
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/ParallelGraphBuilder.h"
+#include "galois/graphs/ParallelTextReader.h"
 
 #include <llvm/Support/CommandLine.h>
 
@@ -30,9 +32,11 @@
 #include <iostream>
 #include <limits>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include <random>
 #include <string>
+#include <optional>
 
 #include <fcntl.h>
 #include <cstdlib>
@@ -200,6 +204,9 @@ static cll::opt<int>
              cll::init(1));
 static cll::opt<int> maxDegree("maxDegree", cll::desc("maximum degree to keep"),
                                cll::init(2 * 1024));
+static cll::opt<unsigned>
+    numThreads("t", cll::desc("Number of threads (default: all)"),
+               cll::init(0));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -337,6 +344,34 @@ void skipLine(std::ifstream& infile) {
   infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
+//! Prints how fast a text input was parsed
+void printIngestRate(const galois::graphs::ParallelTextReader& reader,
+                     galois::Timer& timer) {
+  timer.stop();
+  double mb = reader.size() / (1024.0 * 1024.0);
+  std::cout << "Parsed " << mb << " MB in " << timer.get_usec() / 1e6
+            << " s (" << mb / (timer.get_usec() / 1e6) << " MB/s)\n";
+}
+
+//! Start of the line after the one starting at p
+const char* nextLine(const char* p, const char* end) {
+  const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  return nl ? nl + 1 : end;
+}
+
+/**
+ * Splits a header line into whitespace-separated tokens.
+ */
+std::vector<std::string> headerTokens(const char* p, const char* end) {
+  std::istringstream line(std::string(p, nextLine(p, end) - p));
+  std::vector<std::string> tokens;
+  std::string tmp;
+  while (line >> tmp) {
+    tokens.push_back(tmp);
+  }
+  return tokens;
+}
+
 /**
  * Common parsing for edgelist style text files.
  *
@@ -344,186 +379,61 @@ void skipLine(std::ifstream& infile) {
  * ...
  *
  * If delim is set, this function expects that each entry is separated by delim
- * surrounded by optional whitespace.
+ * surrounded by optional whitespace. Lines are parsed in parallel from the
+ * mapped file and the graph is built with the parallel graph builder.
  */
 template <typename EdgeTy>
 void convertEdgelist(const std::string& infilename,
                      const std::string& outfilename, const bool skipFirstLine,
                      std::optional<char> delim) {
-  typedef galois::graphs::FileGraphWriter Writer;
-
-  Writer p;
-  std::ifstream infile(infilename.c_str());
+  namespace text = galois::graphs::text;
 
-  size_t numNodes   = 0;
-  size_t numEdges   = 0;
-  size_t lineNumber = 0;
+  galois::Timer timer;
+  timer.start();
+  galois::graphs::ParallelTextReader reader(infilename);
+  galois::graphs::ParallelGraphBuilder<EdgeTy> builder;
 
   if (skipFirstLine) {
     galois::gWarn(
         "first line is assumed to contain labels and will be ignored\n");
-    skipLine(infile);
-    ++lineNumber;
+    reader.skipTo(nextLine(reader.begin(), reader.end()));
   }
 
-  const bool hasDelim = static_cast<bool>(delim);
-  std::optional<size_t> skippedLine;
-  std::string line;
-  char readDelim;
-
-  for (; std::getline(infile, line); ++lineNumber) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      skippedLine = lineNumber;
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        skippedLine = lineNumber;
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      skippedLine = lineNumber;
-      continue;
+  galois::GReduceMin<uint64_t> skippedLine;
+  reader.forEachLine([&](uint64_t lineNumber, const char* p, const char* end) {
+    uint64_t src;
+    uint64_t dst;
+    if (!(p = text::parseUint(p, end, src)) ||
+        (delim && !(p = text::expectChar(p, end, *delim))) ||
+        !(p = text::parseUint(p, end, dst))) {
+      skippedLine.update(lineNumber);
+      return;
     }
 
     if constexpr (!std::is_void<EdgeTy>::value) {
       EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          skippedLine = lineNumber;
-          continue;
-        }
-      }
-
-      if (!(iss >> data)) {
-        skippedLine = lineNumber;
-        continue;
+      if ((delim && !(p = text::expectChar(p, end, *delim))) ||
+          !(p = text::parseNumber(p, end, data))) {
+        skippedLine.update(lineNumber);
+        return;
       }
+      builder.addEdge(src, dst, data);
+    } else {
+      builder.addEdge(src, dst);
     }
+  });
+  printIngestRate(reader, timer);
 
-    if (infile) {
-      ++numEdges;
-      if (src > numNodes)
-        numNodes = src;
-      if (dst > numNodes)
-        numNodes = dst;
-    }
-  }
-
-  if (skippedLine) {
-    galois::gWarn("ignored at least one line (line ", *skippedLine,
+  if (skippedLine.reduce() != std::numeric_limits<uint64_t>::max()) {
+    galois::gWarn("ignored at least one line (line ",
+                  skippedLine.reduce() + skipFirstLine,
                   ") because it did not match the expected format\n");
   }
 
-  numNodes++;
-  p.setNumNodes(numNodes);
-  p.setNumEdges<EdgeTy>(numEdges);
-
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase1();
-
-  if (skipFirstLine) {
-    skipLine(infile);
-  }
-
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
-    }
-
-    if constexpr (!std::is_void<EdgeTy>::value) {
-      EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
-        }
-      }
-
-      if (!(iss >> data)) {
-        continue;
-      }
-    }
-
-    if (infile) {
-      p.incrementDegree(src);
-    }
-  }
-
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase2();
-
-  if (skipFirstLine) {
-    skipLine(infile);
-  }
-
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
-    }
-
-    if constexpr (!std::is_void<EdgeTy>::value) {
-      EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
-        }
-      }
-
-      if (!(iss >> data)) {
-        continue;
-      }
-
-      if (infile) {
-        p.addNeighbor<EdgeTy>(src, dst, data);
-      }
-    } else {
-      if (infile) {
-        p.addNeighbor(src, dst);
-      }
-    }
-  }
-
-  p.finish();
-
-  p.toFile(outfilename);
-  printStatus(numNodes, numEdges);
+  // a graph without edges still has node 0
+  builder.setNumNodes(1);
+  builder.toFile(outfilename);
+  printStatus(builder.size(), builder.sizeEdges());
 }
 
 template <typename EdgeTy>
@@ -635,98 +545,73 @@ struct Edgelist2Binary : public Conversion {
 struct Mtx2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
-
-    Writer p;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-      if (!infile) {
-        GALOIS_DIE("failed to open input file");
-      }
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() != '%') {
-          break;
+    namespace text = galois::graphs::text;
+
+    galois::Timer timer;
+    timer.start();
+    galois::graphs::ParallelTextReader reader(infilename);
+
+    // Skip comments
+    const char* header = reader.begin();
+    while (header < reader.end() && *header == '%') {
+      header = nextLine(header, reader.end());
+    }
+
+    // Read header
+    std::vector<std::string> tokens = headerTokens(header, reader.end());
+    if (tokens.size() != 3) {
+      GALOIS_DIE("unknown problem specification line: ",
+                 std::string(header, nextLine(header, reader.end()) - header));
+    }
+    // Prefer C functions for maximum compatibility
+    uint64_t nnodes = strtoull(tokens[0].c_str(), NULL, 0);
+    uint64_t nedges = strtoull(tokens[2].c_str(), NULL, 0);
+    reader.skipTo(nextLine(header, reader.end()));
+
+    // Parse edges
+    galois::graphs::ParallelGraphBuilder<EdgeTy> builder;
+    builder.setNumNodes(nnodes);
+    galois::GAccumulator<uint64_t> numEdges;
+    reader.forEachLine([&](uint64_t, const char* p, const char* end) {
+      uint64_t cur_id;
+      uint64_t neighbor_id;
+      double weight = 1;
+      const char* q = text::parseUint(p, end, cur_id);
+      if (!q) {
+        if (text::skipSpace(p, end) != end) {
+          GALOIS_DIE("bad node id or additional lines in file");
         }
-        skipLine(infile);
+        return;
       }
+      if (!(p = text::parseUint(q, end, neighbor_id))) {
+        GALOIS_DIE("missing neighbor of node: ", cur_id);
+      }
+      text::parseNumber(p, end, weight);
 
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
+      if (cur_id == 0 || cur_id > nnodes) {
+        GALOIS_DIE("node id out of range: ", cur_id);
       }
-      if (tokens.size() != 3) {
-        GALOIS_DIE("unknown problem specification line: ", line.str());
+      if (neighbor_id == 0 || neighbor_id > nnodes) {
+        GALOIS_DIE("neighbor id out of range: ", neighbor_id);
       }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[0]);
-      // nedges = std::stoull(tokens[2]);
-      nnodes = strtoull(tokens[0].c_str(), NULL, 0);
-      nedges = strtoull(tokens[2].c_str(), NULL, 0);
 
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges<EdgeTy>(nedges);
-        p.phase1();
+      // 1 indexed
+      if constexpr (std::is_void<EdgeTy>::value) {
+        builder.addEdge(cur_id - 1, neighbor_id - 1);
       } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        if ((edge_num % (nedges / 500)) == 0) {
-          printf("Phase %d: current edge progress %lf%%\n", phase,
-                 ((double)edge_num / nedges) * 100);
-        }
-        uint32_t cur_id, neighbor_id;
-        double weight = 1;
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          GALOIS_DIE("node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          GALOIS_DIE("neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          if constexpr (std::is_void<EdgeTy>::value) {
-            p.addNeighbor(cur_id - 1, neighbor_id - 1);
-          } else {
-            p.addNeighbor<EdgeTy>(cur_id - 1, neighbor_id - 1,
-                                  static_cast<EdgeTy>(weight));
-          }
-        }
-
-        skipLine(infile);
+        builder.addEdge(cur_id - 1, neighbor_id - 1,
+                        static_cast<EdgeTy>(weight));
       }
+      numEdges += 1;
+    });
+    printIngestRate(reader, timer);
 
-      infile.peek();
-      if (!infile.eof()) {
-        GALOIS_DIE("additional lines in file");
-      }
+    if (numEdges.reduce() != nedges) {
+      GALOIS_DIE("expected ", nedges, " edges but found ", numEdges.reduce());
     }
-    // this is for the progress print
 
-    p.finish();
-
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    builder.toFile(outfilename);
+    printStatus(builder.size(), builder.sizeEdges());
   }
 };
 
@@ -2109,98 +1994,68 @@ struct MakeUnsymmetric : public Conversion {
 struct Dimacs2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
+    namespace text = galois::graphs::text;
 
-    Writer p;
-    uint32_t nnodes;
-    size_t nedges;
+    galois::Timer timer;
+    timer.start();
+    galois::graphs::ParallelTextReader reader(infilename);
 
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
+    // Skip comments
+    const char* header = reader.begin();
+    while (header < reader.end() && *header != 'p') {
+      header = nextLine(header, reader.end());
+    }
 
-      // Skip comments
-      while (infile) {
-        if (infile.peek() == 'p') {
-          break;
-        }
-        skipLine(infile);
-      }
+    // Read header
+    std::vector<std::string> tokens = headerTokens(header, reader.end());
+    if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
+      GALOIS_DIE("unknown problem specification line: ",
+                 std::string(header, nextLine(header, reader.end()) - header));
+    }
+    // Prefer C functions for maximum compatibility
+    uint64_t nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
+    uint64_t nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
+    reader.skipTo(nextLine(header, reader.end()));
 
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
+    // Parse edges; lines other than arcs are skipped
+    galois::graphs::ParallelGraphBuilder<EdgeTy> builder;
+    builder.setNumNodes(nnodes);
+    galois::GAccumulator<uint64_t> numEdges;
+    reader.forEachLine([&](uint64_t, const char* p, const char* end) {
+      if (!(p = text::expectChar(p, end, 'a'))) {
+        return;
       }
-      if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
-        GALOIS_DIE("unknown problem specification line: ", line.str());
+      uint64_t cur_id;
+      uint64_t neighbor_id;
+      int32_t weight;
+      if (!(p = text::parseUint(p, end, cur_id)) ||
+          !(p = text::parseUint(p, end, neighbor_id)) ||
+          !(p = text::parseNumber(p, end, weight))) {
+        GALOIS_DIE("malformed arc line");
       }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[tokens.size() - 2]);
-      // nedges = std::stoull(tokens[tokens.size() - 1]);
-      nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
-      nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges<EdgeTy>(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
+      if (cur_id == 0 || cur_id > nnodes) {
+        GALOIS_DIE("node id out of range: ", cur_id);
       }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        uint32_t cur_id;
-        uint32_t neighbor_id;
-        int32_t weight;
-        std::string tmp;
-        infile >> tmp;
-
-        if (tmp.compare("a") != 0) {
-          --edge_num;
-          skipLine(infile);
-          continue;
-        }
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          GALOIS_DIE("node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          GALOIS_DIE("neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          if constexpr (std::is_void<EdgeTy>::value) {
-            p.addNeighbor(cur_id - 1, neighbor_id - 1);
-          } else {
-            p.addNeighbor<EdgeTy>(cur_id - 1, neighbor_id - 1, weight);
-          }
-        }
-
-        skipLine(infile);
+      if (neighbor_id == 0 || neighbor_id > nnodes) {
+        GALOIS_DIE("neighbor id out of range: ", neighbor_id);
       }
 
-      infile.peek();
-      if (!infile.eof()) {
-        GALOIS_DIE("additional lines in file");
+      // 1 indexed
+      if constexpr (std::is_void<EdgeTy>::value) {
+        builder.addEdge(cur_id - 1, neighbor_id - 1);
+      } else {
+        builder.addEdge(cur_id - 1, neighbor_id - 1, EdgeTy(weight));
       }
-    }
+      numEdges += 1;
+    });
+    printIngestRate(reader, timer);
 
-    p.finish();
+    if (numEdges.reduce() != nedges) {
+      GALOIS_DIE("expected ", nedges, " edges but found ", numEdges.reduce());
+    }
 
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    builder.toFile(outfilename);
+    printStatus(builder.size(), builder.sizeEdges());
   }
 };
 
@@ -2781,114 +2636,72 @@ struct Gr2Bsml : public Conversion {
 struct Svmlight2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
+    namespace text = galois::graphs::text;
 
-    Writer p;
-    std::ifstream infile(infilename.c_str());
     std::ofstream outlabels(labelsFilename.c_str());
-
     if (!outlabels) {
       GALOIS_DIE("unable to create labels file");
     }
 
-    size_t featureOffset = 0;
-    size_t numEdges      = 0;
-    long maxFeature      = -1;
-
-    for (int phase = 0; phase < 3; ++phase) {
-      infile.clear();
-      infile.seekg(0, std::ios::beg);
-      size_t numNodes = 0;
-
-      while (infile) {
-        if (phase == 2) {
-          float label;
-          infile >> label;
-          if (!infile)
-            break;
-          outlabels << numNodes << " " << label << "\n";
-        } else {
-          infile.ignore(std::numeric_limits<std::streamsize>::max(), ' ');
-          if (!infile)
-            break;
+    galois::Timer timer;
+    timer.start();
+    galois::graphs::ParallelTextReader reader(infilename);
+
+    // line i is node i and feature f is node numLines + f
+    const uint64_t featureOffset = reader.numLines();
+    std::vector<float> labels(featureOffset);
+    galois::graphs::ParallelGraphBuilder<EdgeTy> builder;
+    builder.setNumNodes(featureOffset);
+
+    reader.forEachLine([&](uint64_t node, const char* p, const char* end) {
+      const char* comment =
+          static_cast<const char*>(std::memchr(p, '#', end - p));
+      if (comment) {
+        end = comment;
+      }
+      if (!(p = text::parseNumber(p, end, labels[node]))) {
+        return;
+      }
+
+      // Parse "feature:value" pairs
+      while ((p = text::skipSpace(p, end)) != end) {
+        uint64_t feature;
+        double value;
+        const char* q = text::parseUint(p, end, feature);
+        if (!q || !(q = text::expectChar(q, end, ':')) ||
+            !(q = text::parseNumber(q, end, value))) {
+          GALOIS_DIE("unknown feature format: '",
+                     std::string(p, std::find(p, end, ' ') - p),
+                     "' on line: ", node + 1);
         }
-
-        const int maxLength = 1024;
-        char buffer[maxLength];
-        int idx = 0;
-
-        while (infile) {
-          char c = infile.get();
-          if (!infile)
-            break;
-          if (c == ' ' || c == '\n' || c == '#') {
-            buffer[idx] = '\0';
-            // Parse "feature:value" pairs
-            if (idx) {
-              char* delim = strchr(buffer, ':');
-              if (!delim)
-                GALOIS_DIE("unknown feature format: '", buffer,
-                           "' on line: ", numNodes + 1);
-              *delim       = '\0';
-              double value = strtod(delim + 1, NULL);
-              if (value == 0.0) {
-                ; // pass
-              } else if (phase == 0) {
-                long feature = strtol(buffer, NULL, 10);
-                maxFeature   = std::max(maxFeature, feature);
-                numEdges += 1;
-              } else if (phase == 1) {
-                p.incrementDegree(numNodes);
-              } else {
-                long feature = strtol(buffer, NULL, 10);
-                if constexpr (std::is_void<EdgeTy>::value) {
-                  p.addNeighbor(numNodes, feature + featureOffset);
-                } else {
-                  p.addNeighbor<EdgeTy>(numNodes, feature + featureOffset,
-                                        value);
-                }
-              }
-            }
-
-            idx = 0;
-          } else {
-            buffer[idx++] = c;
-            if (idx == maxLength)
-              GALOIS_DIE("token too long");
-            continue;
-          }
-          if (c == '#') {
-            skipLine(infile);
-          }
-          if (c == '#' || c == '\n') {
-            break;
-          }
+        p = q;
+        if (value == 0.0) {
+          continue;
+        }
+        if constexpr (std::is_void<EdgeTy>::value) {
+          builder.addEdge(node, feature + featureOffset);
+        } else {
+          builder.addEdge(node, feature + featureOffset, EdgeTy(value));
         }
-
-        numNodes += 1;
       }
+    });
+    printIngestRate(reader, timer);
 
-      if (phase == 0) {
-        featureOffset = numNodes;
-        numNodes += maxFeature + 1;
-        p.setNumNodes(numNodes);
-        p.setNumEdges<EdgeTy>(numEdges);
-        p.phase1();
-      } else if (phase == 1) {
-        p.phase2();
-      } else {
-        p.finish();
-        numNodes += maxFeature + 1;
-        p.toFile(outfilename);
-        printStatus(numNodes, numEdges);
-      }
+    for (uint64_t node = 0; node < featureOffset; ++node) {
+      outlabels << node << " " << labels[node] << "\n";
     }
+
+    builder.toFile(outfilename);
+    printStatus(builder.size(), builder.sizeEdges());
   }
 };
 
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  galois::setActiveThreads(
+      numThreads ? numThreads
+                 : galois::substrate::getThreadPool().getMaxUsableThreads());
   std::ios_base::sync_with_stdio(false);
   switch (convertMode) {
   case bipartitegr2bigpetsc: